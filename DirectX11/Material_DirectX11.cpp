@@ -130,9 +130,10 @@ namespace JumaRenderEngine
             }
             else
             {
-                const RenderTarget_DirectX11* valueRenderTarget = dynamic_cast<RenderTarget_DirectX11*>(value);
+                RenderTarget_DirectX11* valueRenderTarget = dynamic_cast<RenderTarget_DirectX11*>(value);
                 if (valueRenderTarget != nullptr)
                 {
+                    valueRenderTarget->updateMips();
                     textureView = valueRenderTarget->getResultImageView();
                 }
             }
@@ -9,6 +9,7 @@
 #include "Material_DirectX11.h"
 #include "RenderTarget_DirectX11.h"
 #include "Shader_DirectX11.h"
+#include "TextureFormat_DirectX11.h"
 #include "Texture_DirectX11.h"
 #include "VertexBuffer_DirectX11.h"
 #include "renderEngine/window/DirectX11/WindowControllerInfo_DirectX11.h"
@@ -128,6 +129,11 @@ namespace JumaRenderEngine
         return createObject<RenderTarget_DirectX11>();
     }
 
+    bool RenderEngine_DirectX11::isTextureFormatSupportedInternal(const TextureFormat format) const
+    {
+        return GetDirectX11FormatByTextureFormat(format) != DXGI_FORMAT_UNKNOWN;
+    }
+
     ID3D11RasterizerState* RenderEngine_DirectX11::getRasterizerState(const DirectX11RasterizationDescription& description)
     {
         ID3D11RasterizerState** statePtr = m_RasterizerStates.find(description);
@@ -66,6 +66,8 @@ namespace JumaRenderEngine
         virtual Material* createMaterialInternal() override;
         virtual RenderTarget* createRenderTargetInternal() override;
 
+        virtual bool isTextureFormatSupportedInternal(TextureFormat format) const override;
+
     private:
 
         ID3D11Device* m_Device = nullptr;
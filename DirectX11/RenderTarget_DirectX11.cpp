@@ -10,6 +10,7 @@
 #include "RenderEngine_DirectX11.h"
 #include "TextureFormat_DirectX11.h"
 #include "renderEngine/RenderEngine.h"
+#include "renderEngine/RenderTargetOperations.h"
 #include "renderEngine/window/DirectX11/WindowController_DirectX11.h"
 
 namespace JumaRenderEngine
@@ -326,12 +327,19 @@ namespace JumaRenderEngine
 
         ID3D11DeviceContext* deviceContext = getRenderEngine<RenderEngine_DirectX11>()->getDeviceContext();
 
-        constexpr float clearColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-        deviceContext->ClearRenderTargetView(m_ColorAttachmentView, clearColor);
-        deviceContext->ClearDepthStencilView(m_DepthAttachmentView, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+        const RenderTargetOperations& operations = GetRenderTargetOperations(renderOptions);
+        if (operations.colorLoadOperation == RenderTargetLoadOperation::Clear)
+        {
+            const float clearColor[] = { operations.clearColor.x, operations.clearColor.y, operations.clearColor.z, operations.clearColor.w };
+            deviceContext->ClearRenderTargetView(m_ColorAttachmentView, clearColor);
+        }
+        if (operations.depthLoadOperation == RenderTargetLoadOperation::Clear)
+        {
+            deviceContext->ClearDepthStencilView(m_DepthAttachmentView, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, operations.clearDepth, operations.clearStencil);
+        }
         deviceContext->OMSetRenderTargets(1, &m_ColorAttachmentView, m_DepthAttachmentView);
 
-        const math::uvector2 size = getSize();
+        const math::uvector2 size = getRenderSize();
         const D3D11_VIEWPORT viewport = { 0, 0, static_cast<FLOAT>(size.x), static_cast<FLOAT>(size.y), 0.0f, 1.0f };
         deviceContext->RSSetState(m_RasterizerState);
         deviceContext->RSSetViewports(1, &viewport);
@@ -351,13 +359,18 @@ namespace JumaRenderEngine
                 GetDirectX11FormatByTextureFormat(getFormat())
             );
         }
-        if (!isWindowRenderTarget())
-        {
-            deviceContext->GenerateMips(m_ResultImageView);
-        }
 
         Super::onFinishRender(renderOptions);
     }
+
+    void RenderTarget_DirectX11::updateMips()
+    {
+        if ((m_ResultImageView != nullptr) && shouldUpdateMips())
+        {
+            getRenderEngine<RenderEngine_DirectX11>()->getDeviceContext()->GenerateMips(m_ResultImageView);
+            onMipsUpdated();
+        }
+    }
 }
 
 #endif
@@ -31,6 +31,8 @@ namespace JumaRenderEngine
         virtual ~RenderTarget_DirectX11() override;
 
         ID3D11ShaderResourceView* getResultImageView() const { return m_ResultImageView; }
+        // Generates mips if they are outdated and sampler uses them
+        void updateMips();
 
         virtual bool onStartRender(RenderOptions* renderOptions) override;
         virtual void onFinishRender(RenderOptions* renderOptions) override;
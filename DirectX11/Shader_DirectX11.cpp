@@ -162,6 +162,18 @@ namespace JumaRenderEngine
             case VertexComponentType::Vec2: componentFormat = DXGI_FORMAT_R32G32_FLOAT; break;
             case VertexComponentType::Vec3: componentFormat = DXGI_FORMAT_R32G32B32_FLOAT; break;
             case VertexComponentType::Vec4: componentFormat = DXGI_FORMAT_R32G32B32A32_FLOAT; break;
+            case VertexComponentType::Half: componentFormat = DXGI_FORMAT_R16_FLOAT; break;
+            case VertexComponentType::Half2: componentFormat = DXGI_FORMAT_R16G16_FLOAT; break;
+            case VertexComponentType::Half4: componentFormat = DXGI_FORMAT_R16G16B16A16_FLOAT; break;
+            case VertexComponentType::UByte2_Norm: componentFormat = DXGI_FORMAT_R8G8_UNORM; break;
+            case VertexComponentType::UByte4_Norm: componentFormat = DXGI_FORMAT_R8G8B8A8_UNORM; break;
+            case VertexComponentType::Byte2_Norm: componentFormat = DXGI_FORMAT_R8G8_SNORM; break;
+            case VertexComponentType::Byte4_Norm: componentFormat = DXGI_FORMAT_R8G8B8A8_SNORM; break;
+            case VertexComponentType::UShort2_Norm: componentFormat = DXGI_FORMAT_R16G16_UNORM; break;
+            case VertexComponentType::UShort4_Norm: componentFormat = DXGI_FORMAT_R16G16B16A16_UNORM; break;
+            case VertexComponentType::Short2_Norm: componentFormat = DXGI_FORMAT_R16G16_SNORM; break;
+            case VertexComponentType::Short4_Norm: componentFormat = DXGI_FORMAT_R16G16B16A16_SNORM; break;
+            case VertexComponentType::UInt_10_10_10_2_Norm: componentFormat = DXGI_FORMAT_R10G10B10A2_UNORM; break;
             default: continue;
             }
 
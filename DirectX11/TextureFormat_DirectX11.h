@@ -18,8 +18,20 @@ namespace JumaRenderEngine
         {
         case TextureFormat::RGBA8: return DXGI_FORMAT_R8G8B8A8_UNORM;
         case TextureFormat::BGRA8: return DXGI_FORMAT_B8G8R8A8_UNORM;
+        case TextureFormat::R8: return DXGI_FORMAT_R8_UNORM;
+        case TextureFormat::RG8: return DXGI_FORMAT_R8G8_UNORM;
+        case TextureFormat::R16F: return DXGI_FORMAT_R16_FLOAT;
+        case TextureFormat::RG16F: return DXGI_FORMAT_R16G16_FLOAT;
+        case TextureFormat::RGBA16F: return DXGI_FORMAT_R16G16B16A16_FLOAT;
+        case TextureFormat::R32F: return DXGI_FORMAT_R32_FLOAT;
+        case TextureFormat::R11G11B10F: return DXGI_FORMAT_R11G11B10_FLOAT;
         case TextureFormat::DEPTH32: return DXGI_FORMAT_D32_FLOAT;
         case TextureFormat::DEPTH24_STENCIL8: return DXGI_FORMAT_D24_UNORM_S8_UINT;
+        case TextureFormat::BC1_RGBA: return DXGI_FORMAT_BC1_UNORM;
+        case TextureFormat::BC3_RGBA: return DXGI_FORMAT_BC3_UNORM;
+        case TextureFormat::BC4_R: return DXGI_FORMAT_BC4_UNORM;
+        case TextureFormat::BC5_RG: return DXGI_FORMAT_BC5_UNORM;
+        case TextureFormat::BC7_RGBA: return DXGI_FORMAT_BC7_UNORM;
         default: ;
         }
         return DXGI_FORMAT_UNKNOWN;
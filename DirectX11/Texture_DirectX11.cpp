@@ -16,23 +16,24 @@ namespace JumaRenderEngine
         clearDirectX();
     }
 
-    bool Texture_DirectX11::initInternal(const math::uvector2& size, const TextureFormat format, const uint8* data)
+    bool Texture_DirectX11::initInternal(const math::uvector2& size, const TextureFormat format, const jarray<const uint8*>& mipLevelsData)
     {
         RenderEngine_DirectX11* renderEngine = getRenderEngine<RenderEngine_DirectX11>();
         ID3D11Device* device = renderEngine->getDevice();
 
+        const bool generateMips = (mipLevelsData.getSize() == 1) && !IsTextureFormatCompressed(format);
         D3D11_TEXTURE2D_DESC textureDescription{};
         textureDescription.Width = size.x;
         textureDescription.Height = size.y;
-        textureDescription.MipLevels = GetMipLevelCountByTextureSize(size);
+        textureDescription.MipLevels = generateMips ? GetMipLevelCountByTextureSize(size) : static_cast<UINT>(mipLevelsData.getSize());
         textureDescription.ArraySize = 1;
         textureDescription.Format = GetDirectX11FormatByTextureFormat(format);
         textureDescription.SampleDesc.Count = 1;
         textureDescription.SampleDesc.Quality = 0;
         textureDescription.Usage = D3D11_USAGE_DEFAULT;
-        textureDescription.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+        textureDescription.BindFlags = generateMips ? D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE : D3D11_BIND_SHADER_RESOURCE;
         textureDescription.CPUAccessFlags = 0;
-        textureDescription.MiscFlags = D3D11_RESOURCE_MISC_GENERATE_MIPS;
+        textureDescription.MiscFlags = generateMips ? D3D11_RESOURCE_MISC_GENERATE_MIPS : 0;
         ID3D11Texture2D* texture = nullptr;
         HRESULT result = device->CreateTexture2D(&textureDescription, nullptr, &texture);
         if (FAILED(result))
@@ -56,15 +57,39 @@ namespace JumaRenderEngine
         }
 
         ID3D11DeviceContext* deviceContext = renderEngine->getDeviceContext();
-        const D3D11_BOX textureRange = { 0, 0, 0, size.x, size.y, 1 };
-        deviceContext->UpdateSubresource(texture, 0, &textureRange, data, size.x * GetTextureFormatSize(format), 1);
-        deviceContext->GenerateMips(textureView);
+        math::uvector2 levelSize = size;
+        for (int32 mipLevel = 0; mipLevel < mipLevelsData.getSize(); mipLevel++)
+        {
+            // Whole subresource is updated, so compressed levels don't need block aligned box
+            deviceContext->UpdateSubresource(texture, static_cast<UINT>(mipLevel), nullptr, mipLevelsData[mipLevel], 
+                GetTextureRowPitch(format, levelSize.x), 1);
+            levelSize = { math::max(levelSize.x / 2, 1u), math::max(levelSize.y / 2, 1u) };
+        }
+        if (generateMips)
+        {
+            deviceContext->GenerateMips(textureView);
+        }
 
         m_Texture = texture;
         m_TextureView = textureView;
         return true;
     }
 
+    bool Texture_DirectX11::updateRegionInternal(const math::uvector2& offset, const math::uvector2& size, const uint32 mipLevel, const uint8* data)
+    {
+        // Driver copies data and schedules upload, so there is no wait for the GPU
+        D3D11_BOX box{};
+        box.left = offset.x;
+        box.top = offset.y;
+        box.front = 0;
+        box.right = offset.x + size.x;
+        box.bottom = offset.y + size.y;
+        box.back = 1;
+        getRenderEngine<RenderEngine_DirectX11>()->getDeviceContext()->UpdateSubresource(m_Texture, mipLevel, &box, data, 
+            GetTextureRowPitch(getFormat(), size.x), 1);
+        return true;
+    }
+
     void Texture_DirectX11::clearDirectX()
     {
         if (m_TextureView != nullptr)
@@ -145,11 +145,15 @@ namespace JumaRenderEngine
 
     bool DirectX12Swapchain::present()
     {
-        const bool vsyncEnabled = true;
-        const bool tearingSupported = getRenderEngine()->getWindowController<WindowController_DirectX12>()->isTearingSupported();
+        const WindowController_DirectX12* windowController = getRenderEngine()->getWindowController<WindowController_DirectX12>();
+        const WindowData* windowData = windowController->findWindowData(m_WindowID);
+        const WindowPresentMode presentMode = windowData != nullptr ? windowData->properties.presentMode : WindowPresentMode::FIFO;
+        const bool vsyncEnabled = (presentMode == WindowPresentMode::FIFO) || (presentMode == WindowPresentMode::FIFORelaxed);
+        const bool tearingSupported = windowController->isTearingSupported();
 
+        // Flip model swapchain without sync interval doesn't tear unless it's allowed, so it works like mailbox
         const UINT syncInterval = vsyncEnabled ? 1 : 0;
-        const UINT presentFlags = tearingSupported && !vsyncEnabled ? DXGI_PRESENT_ALLOW_TEARING : 0;
+        const UINT presentFlags = tearingSupported && (presentMode == WindowPresentMode::Immediate) ? DXGI_PRESENT_ALLOW_TEARING : 0;
         const HRESULT result = m_Swapchain->Present(syncInterval, presentFlags);
         if (FAILED(result))
         {
@@ -14,6 +14,7 @@
 #include "RenderPipeline_DirectX12.h"
 #include "RenderTarget_DirectX12.h"
 #include "Shader_DirectX12.h"
+#include "TextureFormat_DirectX12.h"
 #include "Texture_DirectX12.h"
 #include "VertexBuffer_DirectX12.h"
 #include "DirectX12Objects/DirectX12MipGenerator.h"
@@ -412,6 +413,11 @@ namespace JumaRenderEngine
     {
         return createObject<RenderPipeline_DirectX12>();
     }
+
+    bool RenderEngine_DirectX12::isTextureFormatSupportedInternal(const TextureFormat format) const
+    {
+        return GetDirectX12FormatByTextureFormat(format) != DXGI_FORMAT_UNKNOWN;
+    }
 }
 
 #endif
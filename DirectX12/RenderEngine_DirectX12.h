@@ -66,6 +66,8 @@ namespace JumaRenderEngine
         virtual RenderTarget* createRenderTargetInternal() override;
         virtual RenderPipeline* createRenderPipelineInternal() override;
 
+        virtual bool isTextureFormatSupportedInternal(TextureFormat format) const override;
+
     private:
 
         ID3D12Device2* m_Device = nullptr;
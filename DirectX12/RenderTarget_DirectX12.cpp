@@ -10,6 +10,7 @@
 #include "DirectX12Objects/DirectX12MipGenerator.h"
 #include "DirectX12Objects/DirectX12Swapchain.h"
 #include "DirectX12Objects/DirectX12Texture.h"
+#include "renderEngine/RenderTargetOperations.h"
 #include "renderEngine/window/DirectX12/WindowController_DirectX12.h"
 
 namespace JumaRenderEngine
@@ -329,7 +330,7 @@ namespace JumaRenderEngine
         }
         else
         {
-            size = getSize();
+            size = getRenderSize();
             rtvIndex = 0;
             renderTexture = m_ColorTexture;
         }
@@ -347,9 +348,17 @@ namespace JumaRenderEngine
 
         const D3D12_CPU_DESCRIPTOR_HANDLE rtvDescriptor = renderEngine->getDescriptorCPU<D3D12_DESCRIPTOR_HEAP_TYPE_RTV>(m_DescriptorHeapRTV, rtvIndex);
         const D3D12_CPU_DESCRIPTOR_HANDLE dsvDescriptor = m_DescriptorHeapDSV->GetCPUDescriptorHandleForHeapStart();
-        static constexpr FLOAT clearColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-        commandList->ClearRenderTargetView(rtvDescriptor, clearColor, 0, nullptr);
-        commandList->ClearDepthStencilView(dsvDescriptor, D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 1.0f, 0, 0, nullptr);
+        const RenderTargetOperations& operations = GetRenderTargetOperations(renderOptions);
+        if (operations.colorLoadOperation == RenderTargetLoadOperation::Clear)
+        {
+            const FLOAT clearColor[] = { operations.clearColor.x, operations.clearColor.y, operations.clearColor.z, operations.clearColor.w };
+            commandList->ClearRenderTargetView(rtvDescriptor, clearColor, 0, nullptr);
+        }
+        if (operations.depthLoadOperation == RenderTargetLoadOperation::Clear)
+        {
+            commandList->ClearDepthStencilView(dsvDescriptor, D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 
+                operations.clearDepth, operations.clearStencil, 0, nullptr);
+        }
         commandList->OMSetRenderTargets(1, &rtvDescriptor, FALSE, &dsvDescriptor);
 
         const D3D12_VIEWPORT viewport = {
@@ -397,7 +406,7 @@ namespace JumaRenderEngine
         {
             if (!isWindowRenderTarget())
             {
-                renderEngine->getMipGenerator()->generateMips(commandListObject, this, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+                finishResultTexture(commandListObject);
             }
             else
             {
@@ -419,7 +428,7 @@ namespace JumaRenderEngine
             commandListObject->changeTextureState(renderTexture, D3D12_RESOURCE_STATE_RENDER_TARGET);
             if (!isWindowRenderTarget())
             {
-                renderEngine->getMipGenerator()->generateMips(commandListObject, this, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+                finishResultTexture(commandListObject);
             }
             else
             {
@@ -430,6 +439,18 @@ namespace JumaRenderEngine
 
         Super::onFinishRender(renderOptions);
     }
+    void RenderTarget_DirectX12::finishResultTexture(DirectX12CommandList* commandListObject)
+    {
+        // Command list is recorded in order, so mips can't be generated later when the texture is bound
+        if (IsTextureFilterTypeUsingMips(getSamplerType().filterType))
+        {
+            getRenderEngine<RenderEngine_DirectX12>()->getMipGenerator()->generateMips(commandListObject, this, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+        }
+        else
+        {
+            commandListObject->changeTextureState(getMipGeneratorTargetTexture(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+        }
+    }
 }
 
 #endif
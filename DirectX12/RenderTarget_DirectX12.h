@@ -13,6 +13,7 @@
 
 namespace JumaRenderEngine
 {
+    class DirectX12CommandList;
     class DirectX12Swapchain;
     class DirectX12Texture;
 
@@ -62,6 +63,8 @@ namespace JumaRenderEngine
 
         void clearDirectX();
         void clearRenderTarget();
+
+        void finishResultTexture(DirectX12CommandList* commandListObject);
     };
 }
 
@@ -15,12 +15,13 @@ namespace JumaRenderEngine
         clearDirectX();
     }
 
-    bool Texture_DirectX12::initInternal(const math::uvector2& size, const TextureFormat format, const uint8* data)
+    bool Texture_DirectX12::initInternal(const math::uvector2& size, const TextureFormat format, const jarray<const uint8*>& mipLevelsData)
     {
         RenderEngine_DirectX12* renderEngine = getRenderEngine<RenderEngine_DirectX12>();
 
+        const uint32 mipLevels = static_cast<uint32>(mipLevelsData.getSize());
         DirectX12Texture* texture = renderEngine->createObject<DirectX12Texture>();
-        texture->initColor(size, 1, GetDirectX12FormatByTextureFormat(format), 1, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_FLAG_NONE);
+        texture->initColor(size, 1, GetDirectX12FormatByTextureFormat(format), mipLevels, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_FLAG_NONE);
         if (!texture->isValid())
         {
             JUMA_RENDER_LOG(error, JSTR("Failed to create DirectX12Texture object"));
@@ -31,15 +32,16 @@ namespace JumaRenderEngine
         ID3D12Device2* device = renderEngine->getDevice();
         ID3D12Resource* textureResource = texture->getResource();
         const D3D12_RESOURCE_DESC resourceDescription = textureResource->GetDesc();
-        D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint;
+        jarray<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> footprints(static_cast<int32>(mipLevels), D3D12_PLACED_SUBRESOURCE_FOOTPRINT());
+        jarray<UINT> rowCounts(static_cast<int32>(mipLevels), 0);
+        UINT64 stagingBufferSize = 0;
         device->GetCopyableFootprints(
-            &resourceDescription, 0, 1, 0, 
-            &footprint, nullptr, nullptr, nullptr
+            &resourceDescription, 0, mipLevels, 0, 
+            footprints.getData(), rowCounts.getData(), nullptr, &stagingBufferSize
         );
-        const uint32 bufferRowSize = footprint.Footprint.RowPitch;
 
         DirectX12Buffer* stagingBuffer = renderEngine->getBuffer();
-        if ((stagingBuffer == nullptr) || !stagingBuffer->initStaging(bufferRowSize * size.y))
+        if ((stagingBuffer == nullptr) || !stagingBuffer->initStaging(static_cast<uint32>(stagingBufferSize)))
         {
             JUMA_RENDER_LOG(error, JSTR("Failed to create staging buffer"));
             renderEngine->returnBuffer(stagingBuffer);
@@ -47,11 +49,21 @@ namespace JumaRenderEngine
             return false;
         }
 
-        const int32 formatSize = GetTextureFormatSize(format);
         stagingBuffer->initMappedData();
-        for (uint32 y = 0; y < size.y; y++)
+        math::uvector2 levelSize = size;
+        for (uint32 mipLevel = 0; mipLevel < mipLevels; mipLevel++)
         {
-            std::memcpy(stagingBuffer->getMappedData(bufferRowSize * y), data + formatSize * size.x * y, formatSize * size.x);
+            // Rows of compressed formats are rows of blocks
+            const uint32 rowSize = GetTextureRowPitch(format, levelSize.x);
+            const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& footprint = footprints[mipLevel];
+            for (uint32 row = 0; row < rowCounts[mipLevel]; row++)
+            {
+                std::memcpy(
+                    stagingBuffer->getMappedData(static_cast<uint32>(footprint.Offset) + footprint.Footprint.RowPitch * row), 
+                    mipLevelsData[mipLevel] + rowSize * row, rowSize
+                );
+            }
+            levelSize = { math::max(levelSize.x / 2, 1u), math::max(levelSize.y / 2, 1u) };
         }
         stagingBuffer->flushMappedData(nullptr, true);
 
@@ -59,15 +71,18 @@ namespace JumaRenderEngine
         DirectX12CommandList* commandListObject = commandQueue->getCommandList();
         ID3D12GraphicsCommandList2* commandList = commandListObject->get();
 
-        D3D12_TEXTURE_COPY_LOCATION srcCopyLocation{};
-        srcCopyLocation.pResource = stagingBuffer->get();
-        srcCopyLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
-        srcCopyLocation.PlacedFootprint = footprint;
-        D3D12_TEXTURE_COPY_LOCATION dstCopyLocation{};
-        dstCopyLocation.pResource = textureResource;
-        dstCopyLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
-        dstCopyLocation.SubresourceIndex = 0;
-        commandList->CopyTextureRegion(&dstCopyLocation, 0, 0, 0, &srcCopyLocation, nullptr);
+        for (uint32 mipLevel = 0; mipLevel < mipLevels; mipLevel++)
+        {
+            D3D12_TEXTURE_COPY_LOCATION srcCopyLocation{};
+            srcCopyLocation.pResource = stagingBuffer->get();
+            srcCopyLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+            srcCopyLocation.PlacedFootprint = footprints[mipLevel];
+            D3D12_TEXTURE_COPY_LOCATION dstCopyLocation{};
+            dstCopyLocation.pResource = textureResource;
+            dstCopyLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+            dstCopyLocation.SubresourceIndex = mipLevel;
+            commandList->CopyTextureRegion(&dstCopyLocation, 0, 0, 0, &srcCopyLocation, nullptr);
+        }
         /*D3D12_RESOURCE_BARRIER resourceBarrier{};
         resourceBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
         resourceBarrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
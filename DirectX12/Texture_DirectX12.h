@@ -25,7 +25,7 @@ namespace JumaRenderEngine
 
     protected:
 
-        virtual bool initInternal(const math::uvector2& size, TextureFormat format, const uint8* data) override;
+        virtual bool initInternal(const math::uvector2& size, TextureFormat format, const jarray<const uint8*>& mipLevelsData) override;
 
     private:
 
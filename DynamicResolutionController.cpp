@@ -0,0 +1,122 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#include "DynamicResolutionController.h"
+
+#include <cmath>
+
+#include "RenderEngine.h"
+#include "RenderPipeline.h"
+#include "RenderTarget.h"
+
+namespace JumaRenderEngine
+{
+    DynamicResolutionController::~DynamicResolutionController()
+    {
+        clearData();
+    }
+
+    bool DynamicResolutionController::init()
+    {
+        if (isValid())
+        {
+            JUMA_RENDER_LOG(error, JSTR("Dynamic resolution controller already initialized"));
+            return false;
+        }
+
+        markAsInitialized();
+        return true;
+    }
+
+    void DynamicResolutionController::clearData()
+    {
+        applyRenderScale(1.0f);
+        m_RenderTargets.clear();
+        m_RenderScale = 1.0f;
+        m_FrameTime = -1.0f;
+    }
+
+    void DynamicResolutionController::setEnabled(const bool enabled)
+    {
+        if (m_Enabled != enabled)
+        {
+            m_Enabled = enabled;
+            m_FrameTime = -1.0f;
+            m_RenderScale = m_MaxRenderScale;
+            applyRenderScale(enabled ? m_RenderScale : 1.0f);
+        }
+    }
+
+    bool DynamicResolutionController::setRenderScaleRange(const float minScale, const float maxScale)
+    {
+        if ((minScale < RenderTarget::MinRenderScale) || (maxScale > 1.0f) || (minScale > maxScale))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Invalid render scale range"));
+            return false;
+        }
+
+        m_MinRenderScale = minScale;
+        m_MaxRenderScale = maxScale;
+        m_RenderScale = math::min(math::max(m_RenderScale, minScale), maxScale);
+        if (m_Enabled)
+        {
+            applyRenderScale(m_RenderScale);
+        }
+        return true;
+    }
+
+    bool DynamicResolutionController::addRenderTarget(RenderTarget* renderTarget)
+    {
+        if ((renderTarget == nullptr) || renderTarget->isWindowRenderTarget())
+        {
+            JUMA_RENDER_LOG(error, JSTR("Invalid render target, only offscreen render targets could be scaled"));
+            return false;
+        }
+
+        m_RenderTargets.add(renderTarget);
+        renderTarget->setRenderScale(m_Enabled ? m_RenderScale : 1.0f);
+        return true;
+    }
+    void DynamicResolutionController::removeRenderTarget(RenderTarget* renderTarget)
+    {
+        if (m_RenderTargets.remove(renderTarget))
+        {
+            renderTarget->setRenderScale(1.0f);
+        }
+    }
+
+    void DynamicResolutionController::update()
+    {
+        float frameTime = 0.0f;
+        if (!m_Enabled || m_RenderTargets.isEmpty() || (m_FrameTimeBudget <= 0.0f) || 
+            !getRenderEngine()->getRenderPipeline()->getGPUFrameTime(frameTime) || (frameTime <= 0.0f))
+        {
+            return;
+        }
+
+        // Smoothing prevents scale from reacting to single slow frames
+        m_FrameTime = m_FrameTime < 0.0f ? frameTime : (m_FrameTime * 0.9f + frameTime * 0.1f);
+        if ((m_FrameTime <= m_FrameTimeBudget) && (m_FrameTime >= m_FrameTimeBudget * IncreaseScaleThreshold))
+        {
+            return;
+        }
+
+        // Frame time is roughly proportional to the rendered pixel count, which is proportional to the squared scale
+        const float targetFrameTime = m_FrameTimeBudget * (1.0f + IncreaseScaleThreshold) * 0.5f;
+        const float desiredScale = m_RenderScale * std::sqrt(targetFrameTime / m_FrameTime);
+        const float scale = math::min(math::max(desiredScale, m_RenderScale - MaxScaleStep), m_RenderScale + MaxScaleStep);
+        const float clampedScale = math::min(math::max(scale, m_MinRenderScale), m_MaxRenderScale);
+        if (clampedScale != m_RenderScale)
+        {
+            m_RenderScale = clampedScale;
+            applyRenderScale(m_RenderScale);
+        }
+    }
+
+    void DynamicResolutionController::applyRenderScale(const float scale)
+    {
+        for (const auto& renderTarget : m_RenderTargets)
+        {
+            renderTarget->setRenderScale(scale);
+        }
+    }
+}
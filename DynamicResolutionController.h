@@ -0,0 +1,69 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#pragma once
+
+#include "renderEngine/juma_render_engine_core.h"
+#include "RenderEngineContextObject.h"
+
+#include "jutils/jset.h"
+
+namespace JumaRenderEngine
+{
+    class RenderTarget;
+
+    // Changes render scale of the registered render targets to keep GPU frame time within the budget.
+    // Render targets keep their size, so sample them with RenderTarget::getUVScale()
+    class DynamicResolutionController : public RenderEngineContextObject
+    {
+        friend RenderEngine;
+
+    public:
+        DynamicResolutionController() = default;
+        virtual ~DynamicResolutionController() override;
+
+        static constexpr float DefaultFrameTimeBudget = 16.0f;
+        // Scale is increased only if frame time is lower than this part of the budget
+        static constexpr float IncreaseScaleThreshold = 0.85f;
+        static constexpr float MaxScaleStep = 0.05f;
+
+        bool isEnabled() const { return m_Enabled; }
+        void setEnabled(bool enabled);
+
+        float getFrameTimeBudget() const { return m_FrameTimeBudget; }
+        void setFrameTimeBudget(const float milliseconds) { m_FrameTimeBudget = milliseconds; }
+
+        float getMinRenderScale() const { return m_MinRenderScale; }
+        float getMaxRenderScale() const { return m_MaxRenderScale; }
+        bool setRenderScaleRange(float minScale, float maxScale);
+        float getRenderScale() const { return m_RenderScale; }
+
+        bool addRenderTarget(RenderTarget* renderTarget);
+        // Called automatically when render target is destroyed
+        void removeRenderTarget(RenderTarget* renderTarget);
+
+        void update();
+
+    protected:
+
+        virtual void clearInternal() override { clearData(); }
+
+    private:
+
+        bool m_Enabled = true;
+        float m_FrameTimeBudget = DefaultFrameTimeBudget;
+        float m_MinRenderScale = 0.5f;
+        float m_MaxRenderScale = 1.0f;
+        float m_RenderScale = 1.0f;
+        // Smoothed GPU frame time, negative until the first frame time is received
+        float m_FrameTime = -1.0f;
+
+        jset<RenderTarget*> m_RenderTargets;
+
+
+        bool init();
+
+        void clearData();
+
+        void applyRenderScale(float scale);
+    };
+}
@@ -0,0 +1,188 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#include "GeometryArena.h"
+
+#include <algorithm>
+
+#include "RenderEngine.h"
+#include "RenderPipeline.h"
+#include "vertex/VertexBufferData.h"
+
+namespace JumaRenderEngine
+{
+    GeometryArena::~GeometryArena()
+    {
+        clearData();
+    }
+
+    bool GeometryArena::init(const jstringID& vertexTypeName, const uint32 vertexSize, const uint32 vertexCapacity, const uint32 indexCapacity)
+    {
+        if (isValid())
+        {
+            JUMA_RENDER_LOG(error, JSTR("Geometry arena already initialized"));
+            return false;
+        }
+        if ((vertexTypeName == jstringID_NONE) || (vertexSize == 0) || (vertexCapacity == 0) || (indexCapacity == 0))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Invalid input params"));
+            return false;
+        }
+
+        m_VertexTypeName = vertexTypeName;
+        m_VertexSize = vertexSize;
+        m_VertexAllocator.reset(vertexCapacity);
+        m_IndexAllocator.reset(indexCapacity);
+        if (!initInternal())
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to initialize geometry arena"));
+            clearData();
+            return false;
+        }
+
+        markAsInitialized();
+        return true;
+    }
+
+    void GeometryArena::clearData()
+    {
+        for (const auto& allocation : m_Allocations)
+        {
+            delete allocation;
+        }
+        m_Allocations.clear();
+
+        m_VertexAllocator.reset(0);
+        m_IndexAllocator.reset(0);
+        m_VertexSize = 0;
+        m_VertexTypeName = jstringID_NONE;
+    }
+
+    bool GeometryArena::canAllocate(const uint32 vertexCount, const uint32 indexCount) const
+    {
+        return (m_VertexAllocator.getLargestFreeRange() >= vertexCount) && ((indexCount == 0) || (m_IndexAllocator.getLargestFreeRange() >= indexCount));
+    }
+    const GeometryArenaAllocation* GeometryArena::allocate(const VertexBufferData* verticesData)
+    {
+        if (!isValid() || (verticesData == nullptr) || (verticesData->getVertexTypeName() != m_VertexTypeName))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Invalid input params"));
+            return nullptr;
+        }
+
+        const uint32 vertexCount = verticesData->getVertexCount();
+        const uint32 indexCount = verticesData->getIndexCount();
+        if (vertexCount == 0)
+        {
+            JUMA_RENDER_LOG(error, JSTR("Empty vertex buffer data"));
+            return nullptr;
+        }
+
+        uint32 firstVertex = 0, firstIndex = 0;
+        if (!m_VertexAllocator.allocate(vertexCount, firstVertex))
+        {
+            return nullptr;
+        }
+        if (!m_IndexAllocator.allocate(indexCount, firstIndex))
+        {
+            m_VertexAllocator.free(firstVertex, vertexCount);
+            return nullptr;
+        }
+
+        if (!uploadVertices(firstVertex, vertexCount, verticesData->getVertices()) ||
+            ((indexCount > 0) && !uploadIndices(firstIndex, indexCount, static_cast<const uint32*>(verticesData->getIndices()))))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to upload data to geometry arena"));
+            m_VertexAllocator.free(firstVertex, vertexCount);
+            m_IndexAllocator.free(firstIndex, indexCount);
+            return nullptr;
+        }
+
+        GeometryArenaAllocation* allocation = new GeometryArenaAllocation();
+        allocation->arena = this;
+        allocation->firstVertex = firstVertex;
+        allocation->vertexCount = vertexCount;
+        allocation->firstIndex = firstIndex;
+        allocation->indexCount = indexCount;
+        m_Allocations.add(allocation);
+        return allocation;
+    }
+    void GeometryArena::free(const GeometryArenaAllocation* allocation)
+    {
+        if ((allocation == nullptr) || (allocation->arena != this))
+        {
+            return;
+        }
+
+        for (int32 index = 0; index < m_Allocations.getSize(); index++)
+        {
+            if (m_Allocations[index] == allocation)
+            {
+                m_VertexAllocator.free(allocation->firstVertex, allocation->vertexCount);
+                m_IndexAllocator.free(allocation->firstIndex, allocation->indexCount);
+                delete m_Allocations[index];
+                m_Allocations.removeAt(index);
+                return;
+            }
+        }
+    }
+
+    bool GeometryArena::compact()
+    {
+        if (!isValid())
+        {
+            return false;
+        }
+        if (getFragmentation() <= 0.0f)
+        {
+            return true;
+        }
+
+        RenderPipeline* renderPipeline = getRenderEngine()->getRenderPipeline();
+        if (renderPipeline != nullptr)
+        {
+            renderPipeline->waitForRenderFinished();
+        }
+
+        jarray<GeometryArenaAllocation*> vertexOrder = m_Allocations;
+        std::sort(vertexOrder.getData(), vertexOrder.getData() + vertexOrder.getSize(), 
+            [](const GeometryArenaAllocation* a, const GeometryArenaAllocation* b) { return a->firstVertex < b->firstVertex; });
+        jarray<GeometryArenaRelocation> vertexRelocations;
+        vertexRelocations.reserve(vertexOrder.getSize());
+        uint32 vertexOffset = 0;
+        for (const auto& allocation : vertexOrder)
+        {
+            vertexRelocations.add({ allocation->firstVertex, vertexOffset, allocation->vertexCount });
+            vertexOffset += allocation->vertexCount;
+        }
+
+        jarray<GeometryArenaAllocation*> indexOrder = m_Allocations;
+        std::sort(indexOrder.getData(), indexOrder.getData() + indexOrder.getSize(), 
+            [](const GeometryArenaAllocation* a, const GeometryArenaAllocation* b) { return a->firstIndex < b->firstIndex; });
+        jarray<GeometryArenaRelocation> indexRelocations;
+        indexRelocations.reserve(indexOrder.getSize());
+        uint32 indexOffset = 0;
+        for (const auto& allocation : indexOrder)
+        {
+            indexRelocations.add({ allocation->firstIndex, indexOffset, allocation->indexCount });
+            indexOffset += allocation->indexCount;
+        }
+
+        if (!relocateData(vertexRelocations, indexRelocations))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to compact geometry arena"));
+            return false;
+        }
+        for (int32 index = 0; index < vertexOrder.getSize(); index++)
+        {
+            vertexOrder[index]->firstVertex = vertexRelocations[index].dstOffset;
+        }
+        for (int32 index = 0; index < indexOrder.getSize(); index++)
+        {
+            indexOrder[index]->firstIndex = indexRelocations[index].dstOffset;
+        }
+
+        m_VertexAllocator.reset(m_VertexAllocator.getCapacity(), vertexOffset);
+        m_IndexAllocator.reset(m_IndexAllocator.getCapacity(), indexOffset);
+        return true;
+    }
+}
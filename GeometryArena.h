@@ -0,0 +1,85 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#pragma once
+
+#include "renderEngine/juma_render_engine_core.h"
+#include "RenderEngineContextObject.h"
+
+#include "jutils/jarray.h"
+#include "jutils/jstringID.h"
+#include "vertex/GeometryArenaAllocator.h"
+
+namespace JumaRenderEngine
+{
+    class GeometryArena;
+    class VertexBufferData;
+
+    struct GeometryArenaAllocation
+    {
+        GeometryArena* arena = nullptr;
+
+        uint32 firstVertex = 0;
+        uint32 vertexCount = 0;
+        uint32 firstIndex = 0;
+        uint32 indexCount = 0;
+    };
+    struct GeometryArenaRelocation
+    {
+        uint32 srcOffset = 0;
+        uint32 dstOffset = 0;
+        uint32 size = 0;
+    };
+
+    // Shared vertex and index buffers for all meshes of one vertex type
+    class GeometryArena : public RenderEngineContextObject
+    {
+        friend RenderEngine;
+
+    public:
+        GeometryArena() = default;
+        virtual ~GeometryArena() override;
+
+        static constexpr uint32 DefaultVertexCapacity = 65536;
+        static constexpr uint32 DefaultIndexCapacity = 196608;
+
+        const jstringID& getVertexTypeName() const { return m_VertexTypeName; }
+        uint32 getVertexSize() const { return m_VertexSize; }
+        uint32 getVertexCapacity() const { return m_VertexAllocator.getCapacity(); }
+        uint32 getIndexCapacity() const { return m_IndexAllocator.getCapacity(); }
+
+        bool isEmpty() const { return m_Allocations.isEmpty(); }
+        int32 getAllocationCount() const { return m_Allocations.getSize(); }
+        float getFragmentation() const { return math::max(m_VertexAllocator.getFragmentation(), m_IndexAllocator.getFragmentation()); }
+
+        bool canAllocate(uint32 vertexCount, uint32 indexCount) const;
+        const GeometryArenaAllocation* allocate(const VertexBufferData* verticesData);
+        void free(const GeometryArenaAllocation* allocation);
+
+        bool compact();
+
+    protected:
+
+        virtual bool initInternal() = 0;
+        virtual void clearInternal() override { clearData(); }
+
+        virtual bool uploadVertices(uint32 firstVertex, uint32 vertexCount, const void* data) = 0;
+        virtual bool uploadIndices(uint32 firstIndex, uint32 indexCount, const uint32* data) = 0;
+        // Move data to the new buffers, offsets and sizes are in elements
+        virtual bool relocateData(const jarray<GeometryArenaRelocation>& vertexRelocations,
+            const jarray<GeometryArenaRelocation>& indexRelocations) = 0;
+
+    private:
+
+        jstringID m_VertexTypeName = jstringID_NONE;
+        uint32 m_VertexSize = 0;
+
+        GeometryArenaAllocator m_VertexAllocator;
+        GeometryArenaAllocator m_IndexAllocator;
+        jarray<GeometryArenaAllocation*> m_Allocations;
+
+
+        bool init(const jstringID& vertexTypeName, uint32 vertexSize, uint32 vertexCapacity, uint32 indexCapacity);
+
+        void clearData();
+    };
+}
@@ -51,6 +51,7 @@ namespace JumaRenderEngine
         template<typename T, TEMPLATE_ENABLE(is_base<Shader, T>)>
         T* getShader() const { return dynamic_cast<T*>(getShader()); }
 
+        void markParamForUpdate(const jstringID& name) { m_MaterialParamsForUpdate.add(name); }
         void clearParamsForUpdate() { m_MaterialParamsForUpdate.clear(); }
 
     private:
@@ -0,0 +1,115 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#include "GeometryArena_OpenGL.h"
+
+#if defined(JUMARENDERENGINE_INCLUDE_RENDER_API_OPENGL)
+
+#include <GL/glew.h>
+
+#include "RenderEngine_OpenGL.h"
+
+namespace JumaRenderEngine
+{
+    GeometryArena_OpenGL::~GeometryArena_OpenGL()
+    {
+        clearOpenGL();
+    }
+
+    bool GeometryArena_OpenGL::initInternal()
+    {
+        m_VerticesBufferIndex = createBuffer(getVertexCapacity() * getVertexSize());
+        m_IndicesBufferIndex = createBuffer(getIndexCapacity() * sizeof(uint32));
+        return true;
+    }
+    uint32 GeometryArena_OpenGL::createBuffer(const uint32 size)
+    {
+        // GL_COPY_WRITE_BUFFER doesn't touch state of the bound VAO
+        uint32 bufferIndex = 0;
+        glGenBuffers(1, &bufferIndex);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, bufferIndex);
+        glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_STATIC_DRAW);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        return bufferIndex;
+    }
+
+    void GeometryArena_OpenGL::clearInternal()
+    {
+        clearOpenGL();
+        Super::clearInternal();
+    }
+    void GeometryArena_OpenGL::clearOpenGL()
+    {
+        getRenderEngine<RenderEngine_OpenGL>()->onVertexBuffersDeleted(m_VerticesBufferIndex, m_IndicesBufferIndex);
+        if (m_IndicesBufferIndex != 0)
+        {
+            glDeleteBuffers(1, &m_IndicesBufferIndex);
+            m_IndicesBufferIndex = 0;
+        }
+        if (m_VerticesBufferIndex != 0)
+        {
+            glDeleteBuffers(1, &m_VerticesBufferIndex);
+            m_VerticesBufferIndex = 0;
+        }
+    }
+
+    bool GeometryArena_OpenGL::uploadVertices(const uint32 firstVertex, const uint32 vertexCount, const void* data)
+    {
+        const uint32 vertexSize = getVertexSize();
+        glBindBuffer(GL_COPY_WRITE_BUFFER, m_VerticesBufferIndex);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(firstVertex * vertexSize), static_cast<GLsizeiptr>(vertexCount * vertexSize), data);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        return true;
+    }
+    bool GeometryArena_OpenGL::uploadIndices(const uint32 firstIndex, const uint32 indexCount, const uint32* data)
+    {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, m_IndicesBufferIndex);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(firstIndex * sizeof(uint32)), static_cast<GLsizeiptr>(indexCount * sizeof(uint32)), data);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        return true;
+    }
+
+    bool GeometryArena_OpenGL::relocateData(const jarray<GeometryArenaRelocation>& vertexRelocations,
+        const jarray<GeometryArenaRelocation>& indexRelocations)
+    {
+        const uint32 vertexSize = getVertexSize();
+        const uint32 verticesBufferIndex = createBuffer(getVertexCapacity() * vertexSize);
+        const uint32 indicesBufferIndex = createBuffer(getIndexCapacity() * sizeof(uint32));
+
+        glBindBuffer(GL_COPY_READ_BUFFER, m_VerticesBufferIndex);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, verticesBufferIndex);
+        for (const auto& relocation : vertexRelocations)
+        {
+            if (relocation.size > 0)
+            {
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                    relocation.srcOffset * vertexSize, relocation.dstOffset * vertexSize, relocation.size * vertexSize);
+            }
+        }
+        glBindBuffer(GL_COPY_READ_BUFFER, m_IndicesBufferIndex);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, indicesBufferIndex);
+        for (const auto& relocation : indexRelocations)
+        {
+            if (relocation.size > 0)
+            {
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                    relocation.srcOffset * sizeof(uint32), relocation.dstOffset * sizeof(uint32), relocation.size * sizeof(uint32));
+            }
+        }
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        getRenderEngine<RenderEngine_OpenGL>()->onVertexBuffersDeleted(m_VerticesBufferIndex, m_IndicesBufferIndex);
+        glDeleteBuffers(1, &m_VerticesBufferIndex);
+        glDeleteBuffers(1, &m_IndicesBufferIndex);
+        m_VerticesBufferIndex = verticesBufferIndex;
+        m_IndicesBufferIndex = indicesBufferIndex;
+        return true;
+    }
+
+    bool GeometryArena_OpenGL::bindBuffers()
+    {
+        return getRenderEngine<RenderEngine_OpenGL>()->bindVertexBuffers(getVertexTypeName(), m_VerticesBufferIndex, m_IndicesBufferIndex);
+    }
+}
+
+#endif
@@ -0,0 +1,45 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#pragma once
+
+#include "renderEngine/juma_render_engine_core.h"
+
+#if defined(JUMARENDERENGINE_INCLUDE_RENDER_API_OPENGL)
+
+#include "renderEngine/GeometryArena.h"
+
+namespace JumaRenderEngine
+{
+    class GeometryArena_OpenGL final : public GeometryArena
+    {
+        using Super = GeometryArena;
+
+    public:
+        GeometryArena_OpenGL() = default;
+        virtual ~GeometryArena_OpenGL() override;
+
+        bool bindBuffers();
+
+    protected:
+
+        virtual bool initInternal() override;
+        virtual void clearInternal() override;
+
+        virtual bool uploadVertices(uint32 firstVertex, uint32 vertexCount, const void* data) override;
+        virtual bool uploadIndices(uint32 firstIndex, uint32 indexCount, const uint32* data) override;
+        virtual bool relocateData(const jarray<GeometryArenaRelocation>& vertexRelocations,
+            const jarray<GeometryArenaRelocation>& indexRelocations) override;
+
+    private:
+
+        uint32 m_VerticesBufferIndex = 0;
+        uint32 m_IndicesBufferIndex = 0;
+
+
+        static uint32 createBuffer(uint32 size);
+
+        void clearOpenGL();
+    };
+}
+
+#endif
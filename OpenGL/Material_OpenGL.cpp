@@ -8,7 +8,9 @@
 
 #include "RenderTarget_OpenGL.h"
 #include "Shader_OpenGL.h"
+#include "TextureArray_OpenGL.h"
 #include "Texture_OpenGL.h"
+#include "renderEngine/RenderTargetAttachment.h"
 
 namespace JumaRenderEngine
 {
@@ -116,11 +118,32 @@ namespace JumaRenderEngine
                     }
                     else
                     {
-                        const RenderTarget_OpenGL* renderTarget = dynamic_cast<RenderTarget_OpenGL*>(value);
+                        RenderTarget_OpenGL* renderTarget = dynamic_cast<RenderTarget_OpenGL*>(value);
                         if (renderTarget != nullptr)
                         {
                             renderTarget->bindToShader(uniform.value.shaderLocation);
                         }
+                        else
+                        {
+                            const RenderTargetAttachment* attachment = dynamic_cast<RenderTargetAttachment*>(value);
+                            renderTarget = attachment != nullptr ? dynamic_cast<RenderTarget_OpenGL*>(attachment->getRenderTarget()) : nullptr;
+                            if (renderTarget != nullptr)
+                            {
+                                renderTarget->bindToShader(uniform.value.shaderLocation, attachment->getAttachmentIndex());
+                            }
+                        }
+                    }
+                }
+                break;
+            case ShaderUniformType::TextureArray:
+                {
+                    ShaderUniformInfo<ShaderUniformType::TextureArray>::value_type value = nullptr;
+                    materialParams.getValue<ShaderUniformType::TextureArray>(uniform.key, value);
+
+                    const TextureArray_OpenGL* textureArray = dynamic_cast<TextureArray_OpenGL*>(value);
+                    if (textureArray != nullptr)
+                    {
+                        textureArray->bindToShader(uniform.value.shaderLocation);
                     }
                 }
                 break;
@@ -149,6 +172,10 @@ namespace JumaRenderEngine
             {
                 Texture_OpenGL::unbindTexture(uniform.value.shaderLocation);
             }
+            else if (uniform.value.type == ShaderUniformType::TextureArray)
+            {
+                TextureArray_OpenGL::unbindTexture(uniform.value.shaderLocation);
+            }
         }
         Shader_OpenGL::deactivateAnyShader();
     }
@@ -5,12 +5,17 @@
 #if defined(JUMARENDERENGINE_INCLUDE_RENDER_API_OPENGL)
 
 #include <GL/glew.h>
+#include <cstring>
 
+#include "GeometryArena_OpenGL.h"
 #include "Material_OpenGL.h"
+#include "RenderPipeline_OpenGL.h"
 #include "RenderTarget_OpenGL.h"
 #include "Shader_OpenGL.h"
+#include "TextureArray_OpenGL.h"
 #include "Texture_OpenGL.h"
 #include "VertexBuffer_OpenGL.h"
+#include "renderEngine/window/OpenGL/WindowController_OpenGL.h"
 #include "renderEngine/window/OpenGL/WindowControllerInfo_OpenGL.h"
 
 namespace JumaRenderEngine
@@ -18,6 +23,8 @@ namespace JumaRenderEngine
     RenderEngine_OpenGL::~RenderEngine_OpenGL()
     {
         clearOpenGL();
+        // Windows notify this engine about destruction, so they are destroyed before base destructor
+        clearData();
     }
 
     void RenderEngine_OpenGL::clearInternal()
@@ -29,11 +36,37 @@ namespace JumaRenderEngine
     {
         clearRenderAssets();
 
+        m_TextureUpdates.clear();
+        if (m_TextureUpdatesBufferIndex != 0)
+        {
+            glDeleteBuffers(1, &m_TextureUpdatesBufferIndex);
+            m_TextureUpdatesBufferIndex = 0;
+        }
         for (const auto& sampler : m_SamplerObjectIndices)
         {
             glDeleteSamplers(1, &sampler.value);
         }
         m_SamplerObjectIndices.clear();
+        clearVertexArrays();
+    }
+    void RenderEngine_OpenGL::clearVertexArrays()
+    {
+        WindowController_OpenGL* windowController = getWindowController<WindowController_OpenGL>();
+        if ((windowController != nullptr) && !m_VertexArrays.isEmpty())
+        {
+            const window_id prevWindowID = windowController->getActiveWindowID();
+            for (const auto& windowVertexArrays : m_VertexArrays)
+            {
+                windowController->setActiveWindowID(windowVertexArrays.key);
+                for (const auto& vertexArray : windowVertexArrays.value)
+                {
+                    glDeleteVertexArrays(1, &vertexArray.value.vertexArrayIndex);
+                }
+            }
+            windowController->setActiveWindowID(prevWindowID);
+        }
+        m_VertexArrays.clear();
+        m_BoundVertexArrayIndices.clear();
     }
 
     WindowController* RenderEngine_OpenGL::createWindowController()
@@ -48,6 +81,10 @@ namespace JumaRenderEngine
     {
         return createObject<Texture_OpenGL>();
     }
+    TextureArray* RenderEngine_OpenGL::createTextureArrayInternal()
+    {
+        return createObject<TextureArray_OpenGL>();
+    }
     Shader* RenderEngine_OpenGL::createShaderInternal()
     {
         return createObject<Shader_OpenGL>();
@@ -60,6 +97,277 @@ namespace JumaRenderEngine
     {
         return createObject<RenderTarget_OpenGL>();
     }
+    RenderPipeline* RenderEngine_OpenGL::createRenderPipelineInternal()
+    {
+        return createObject<RenderPipeline_OpenGL>();
+    }
+    GeometryArena* RenderEngine_OpenGL::createGeometryArenaInternal()
+    {
+        return createObject<GeometryArena_OpenGL>();
+    }
+
+    bool RenderEngine_OpenGL::isTextureFormatSupportedInternal(const TextureFormat format) const
+    {
+        switch (format)
+        {
+        case TextureFormat::BC1_RGBA:
+        case TextureFormat::BC3_RGBA:
+            // S3TC is not a part of the core profile
+            return GLEW_EXT_texture_compression_s3tc;
+        default: ;
+        }
+        // RGTC, BPTC and ETC2 are in the core since 4.3
+        return GetOpenGLInternalFormatByTextureFormat(format) != 0;
+    }
+    bool RenderEngine_OpenGL::isRenderTargetFormatSupportedInternal(const TextureFormat format) const
+    {
+        // Depth formats are used by depth-only render targets
+        return !IsTextureFormatCompressed(format) && (GetOpenGLInternalFormatByTextureFormat(format) != 0);
+    }
+    uint8 RenderEngine_OpenGL::getMaxColorAttachmentCount() const
+    {
+        // GL_MAX_DRAW_BUFFERS and GL_MAX_COLOR_ATTACHMENTS are at least 8 since OpenGL 3.0
+        return RenderTarget::MaxColorAttachmentCount;
+    }
+
+    bool RenderEngine_OpenGL::bindVertexBuffers(const jstringID& vertexName, const uint32 verticesBufferIndex, const uint32 indicesBufferIndex)
+    {
+        const window_id windowID = getWindowController<WindowController_OpenGL>()->getActiveWindowID();
+        jmap<jstringID, VertexArray_OpenGL>& windowVertexArrays = m_VertexArrays[windowID];
+        VertexArray_OpenGL* vertexArray = windowVertexArrays.find(vertexName);
+        if (vertexArray == nullptr)
+        {
+            const uint32 VAO = createVertexArray(vertexName);
+            if (VAO == 0)
+            {
+                return false;
+            }
+            vertexArray = &windowVertexArrays.add(vertexName);
+            vertexArray->vertexArrayIndex = VAO;
+            vertexArray->vertexSize = findVertexType(vertexName)->size;
+        }
+
+        bindVertexArray(vertexArray->vertexArrayIndex);
+        if (vertexArray->verticesBufferIndex != verticesBufferIndex)
+        {
+            glBindVertexBuffer(0, verticesBufferIndex, 0, static_cast<GLsizei>(vertexArray->vertexSize));
+            vertexArray->verticesBufferIndex = verticesBufferIndex;
+        }
+        if (vertexArray->indicesBufferIndex != indicesBufferIndex)
+        {
+            // Element buffer binding is the state of bound VAO
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indicesBufferIndex);
+            vertexArray->indicesBufferIndex = indicesBufferIndex;
+        }
+        return true;
+    }
+    void RenderEngine_OpenGL::onVertexBuffersDeleted(const uint32 verticesBufferIndex, const uint32 indicesBufferIndex)
+    {
+        // Deleted buffers stay attached to VAOs of other contexts until other buffers are attached
+        for (auto& windowVertexArrays : m_VertexArrays)
+        {
+            for (auto& vertexArray : windowVertexArrays.value)
+            {
+                if ((verticesBufferIndex != 0) && (vertexArray.value.verticesBufferIndex == verticesBufferIndex))
+                {
+                    vertexArray.value.verticesBufferIndex = 0;
+                }
+                if ((indicesBufferIndex != 0) && (vertexArray.value.indicesBufferIndex == indicesBufferIndex))
+                {
+                    vertexArray.value.indicesBufferIndex = 0;
+                }
+            }
+        }
+    }
+    void RenderEngine_OpenGL::onWindowDestroyed(const window_id windowID)
+    {
+        // VAOs are destroyed with the context
+        m_VertexArrays.remove(windowID);
+        m_BoundVertexArrayIndices.remove(windowID);
+    }
+
+    void RenderEngine_OpenGL::addTextureUpdate(const uint32 textureIndex, const TextureFormat format, const uint32 mipLevel, 
+        const math::uvector2& offset, const math::uvector2& size, const uint8* data)
+    {
+        TextureUpdate_OpenGL& update = m_TextureUpdates.addDefault();
+        update.textureIndex = textureIndex;
+        update.format = format;
+        update.mipLevel = mipLevel;
+        update.offset = offset;
+        update.size = size;
+
+        const uint32 dataSize = GetTextureDataSize(format, size.x, size.y);
+        update.data = jarray<uint8>(static_cast<int32>(dataSize), 0);
+        std::memcpy(update.data.getData(), data, dataSize);
+    }
+    void RenderEngine_OpenGL::removeTextureUpdates(const uint32 textureIndex)
+    {
+        for (int32 index = m_TextureUpdates.getSize() - 1; index >= 0; index--)
+        {
+            if (m_TextureUpdates[index].textureIndex == textureIndex)
+            {
+                m_TextureUpdates.removeAt(index);
+            }
+        }
+    }
+    void RenderEngine_OpenGL::flushTextureUpdates()
+    {
+        if (m_TextureUpdates.isEmpty())
+        {
+            return;
+        }
+
+        jarray<uint32> dataOffsets;
+        dataOffsets.reserve(m_TextureUpdates.getSize());
+        uint32 dataSize = 0;
+        for (const auto& update : m_TextureUpdates)
+        {
+            dataOffsets.add(dataSize);
+            dataSize += static_cast<uint32>(update.data.getSize());
+        }
+
+        if (m_TextureUpdatesBufferIndex == 0)
+        {
+            glGenBuffers(1, &m_TextureUpdatesBufferIndex);
+        }
+        // Respecifying whole buffer orphans storage still read by previous uploads, so there is no wait
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_TextureUpdatesBufferIndex);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(dataSize), nullptr, GL_STREAM_DRAW);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        for (int32 index = 0; index < m_TextureUpdates.getSize(); index++)
+        {
+            const TextureUpdate_OpenGL& update = m_TextureUpdates[index];
+            glBufferSubData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLintptr>(dataOffsets[index]), static_cast<GLsizeiptr>(update.data.getSize()), update.data.getData());
+            glBindTexture(GL_TEXTURE_2D, update.textureIndex);
+            glTexSubImage2D(GL_TEXTURE_2D, static_cast<GLint>(update.mipLevel), 
+                static_cast<GLint>(update.offset.x), static_cast<GLint>(update.offset.y), static_cast<GLsizei>(update.size.x), static_cast<GLsizei>(update.size.y), 
+                GetOpenGLFormatByTextureFormat(update.format), GetOpenGLTypeByTextureFormat(update.format), reinterpret_cast<const void*>(static_cast<uintptr_t>(dataOffsets[index]))
+            );
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        m_TextureUpdates.clear();
+    }
+
+    uint32 RenderEngine_OpenGL::createVertexArray(const jstringID& vertexName)
+    {
+        const VertexDescription* vertexDescription = findVertexType(vertexName);
+        if (vertexDescription == nullptr)
+        {
+            return 0;
+        }
+
+        // Vertex format is the state of VAO, buffers are attached to binding 0 later
+        uint32 VAO = 0;
+        glGenVertexArrays(1, &VAO);
+        bindVertexArray(VAO);
+        for (int32 index = 0; index < vertexDescription->components.getSize(); index++)
+        {
+            const VertexComponentDescription& componentDescriprion = vertexDescription->components[index];
+
+            GLenum componentType;
+            GLint componentSize;
+            GLboolean componentNormalized = GL_FALSE;
+            switch (componentDescriprion.type)
+            {
+            case VertexComponentType::Float:
+                componentType = GL_FLOAT;
+                componentSize = 1;
+                break;
+            case VertexComponentType::Vec2:
+                componentType = GL_FLOAT;
+                componentSize = 2;
+                break;
+            case VertexComponentType::Vec3:
+                componentType = GL_FLOAT;
+                componentSize = 3;
+                break;
+            case VertexComponentType::Vec4:
+                componentType = GL_FLOAT;
+                componentSize = 4;
+                break;
+            case VertexComponentType::Half:
+                componentType = GL_HALF_FLOAT;
+                componentSize = 1;
+                break;
+            case VertexComponentType::Half2:
+                componentType = GL_HALF_FLOAT;
+                componentSize = 2;
+                break;
+            case VertexComponentType::Half4:
+                componentType = GL_HALF_FLOAT;
+                componentSize = 4;
+                break;
+            case VertexComponentType::UByte2_Norm:
+                componentType = GL_UNSIGNED_BYTE;
+                componentSize = 2;
+                componentNormalized = GL_TRUE;
+                break;
+            case VertexComponentType::UByte4_Norm:
+                componentType = GL_UNSIGNED_BYTE;
+                componentSize = 4;
+                componentNormalized = GL_TRUE;
+                break;
+            case VertexComponentType::Byte2_Norm:
+                componentType = GL_BYTE;
+                componentSize = 2;
+                componentNormalized = GL_TRUE;
+                break;
+            case VertexComponentType::Byte4_Norm:
+                componentType = GL_BYTE;
+                componentSize = 4;
+                componentNormalized = GL_TRUE;
+                break;
+            case VertexComponentType::UShort2_Norm:
+                componentType = GL_UNSIGNED_SHORT;
+                componentSize = 2;
+                componentNormalized = GL_TRUE;
+                break;
+            case VertexComponentType::UShort4_Norm:
+                componentType = GL_UNSIGNED_SHORT;
+                componentSize = 4;
+                componentNormalized = GL_TRUE;
+                break;
+            case VertexComponentType::Short2_Norm:
+                componentType = GL_SHORT;
+                componentSize = 2;
+                componentNormalized = GL_TRUE;
+                break;
+            case VertexComponentType::Short4_Norm:
+                componentType = GL_SHORT;
+                componentSize = 4;
+                componentNormalized = GL_TRUE;
+                break;
+            case VertexComponentType::UInt_10_10_10_2_Norm:
+                componentType = GL_UNSIGNED_INT_2_10_10_10_REV;
+                componentSize = 4;
+                componentNormalized = GL_TRUE;
+                break;
+            case VertexComponentType::Int_10_10_10_2_Norm:
+                componentType = GL_INT_2_10_10_10_REV;
+                componentSize = 4;
+                componentNormalized = GL_TRUE;
+                break;
+            default: continue;
+            }
+
+            glVertexAttribFormat(componentDescriprion.shaderLocation, componentSize, componentType, componentNormalized, componentDescriprion.offset);
+            glVertexAttribBinding(componentDescriprion.shaderLocation, 0);
+            glEnableVertexAttribArray(componentDescriprion.shaderLocation);
+        }
+        return VAO;
+    }
+    void RenderEngine_OpenGL::bindVertexArray(const uint32 vertexArrayIndex)
+    {
+        const window_id windowID = getWindowController<WindowController_OpenGL>()->getActiveWindowID();
+        uint32& boundVertexArrayIndex = m_BoundVertexArrayIndices[windowID];
+        if (boundVertexArrayIndex != vertexArrayIndex)
+        {
+            glBindVertexArray(vertexArrayIndex);
+            boundVertexArrayIndex = vertexArrayIndex;
+        }
+    }
 
     uint32 RenderEngine_OpenGL::getTextureSamplerIndex(const TextureSamplerType sampler)
     {
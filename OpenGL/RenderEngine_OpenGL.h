@@ -9,9 +9,28 @@
 #include "renderEngine/RenderEngine.h"
 
 #include "renderEngine/texture/TextureSamplerType.h"
+#include "renderEngine/window/window_id.h"
 
 namespace JumaRenderEngine
 {
+    struct VertexArray_OpenGL
+    {
+        uint32 vertexArrayIndex = 0;
+        uint32 vertexSize = 0;
+
+        uint32 verticesBufferIndex = 0;
+        uint32 indicesBufferIndex = 0;
+    };
+    struct TextureUpdate_OpenGL
+    {
+        uint32 textureIndex = 0;
+        TextureFormat format = TextureFormat::RGBA8;
+        uint32 mipLevel = 0;
+        math::uvector2 offset = { 0, 0 };
+        math::uvector2 size = { 0, 0 };
+        jarray<uint8> data;
+    };
+
     class RenderEngine_OpenGL final : public RenderEngine
     {
         using Super = RenderEngine;
@@ -24,9 +43,23 @@ namespace JumaRenderEngine
 
         uint32 getTextureSamplerIndex(TextureSamplerType sampler);
 
+        // Binds VAO of the vertex type for the active context and attaches buffers to it
+        bool bindVertexBuffers(const jstringID& vertexName, uint32 verticesBufferIndex, uint32 indicesBufferIndex);
+        // Should be called when buffers are deleted, so VAOs don't skip attaching new buffers with the same names
+        void onVertexBuffersDeleted(uint32 verticesBufferIndex, uint32 indicesBufferIndex);
+        void onWindowDestroyed(window_id windowID);
+
+        // Texture region updates are collected until the start of the next frame and uploaded through one pixel buffer
+        void addTextureUpdate(uint32 textureIndex, TextureFormat format, uint32 mipLevel, const math::uvector2& offset, const math::uvector2& size, 
+            const uint8* data);
+        void removeTextureUpdates(uint32 textureIndex);
+        void flushTextureUpdates();
+
         virtual math::vector2 getScreenCoordinateModifier() const override { return { 1.0f, -1.0f }; }
         virtual bool shouldFlipLoadedTextures() const override { return true; }
 
+        virtual uint8 getMaxColorAttachmentCount() const override;
+
     protected:
 
         virtual void clearInternal() override;
@@ -34,16 +67,32 @@ namespace JumaRenderEngine
         virtual WindowController* createWindowController() override;
         virtual VertexBuffer* createVertexBufferInternal() override;
         virtual Texture* createTextureInternal() override;
+        virtual TextureArray* createTextureArrayInternal() override;
         virtual Shader* createShaderInternal() override;
         virtual Material* createMaterialInternal() override;
         virtual RenderTarget* createRenderTargetInternal() override;
+        virtual RenderPipeline* createRenderPipelineInternal() override;
+        virtual GeometryArena* createGeometryArenaInternal() override;
+
+        virtual bool isTextureFormatSupportedInternal(TextureFormat format) const override;
+        virtual bool isRenderTargetFormatSupportedInternal(TextureFormat format) const override;
 
     private:
 
         jmap<TextureSamplerType, uint32> m_SamplerObjectIndices;
+        // VAOs are not shared between contexts
+        jmap<window_id, jmap<jstringID, VertexArray_OpenGL>> m_VertexArrays;
+        jmap<window_id, uint32> m_BoundVertexArrayIndices;
+
+        jarray<TextureUpdate_OpenGL> m_TextureUpdates;
+        uint32 m_TextureUpdatesBufferIndex = 0;
 
 
         void clearOpenGL();
+        void clearVertexArrays();
+
+        uint32 createVertexArray(const jstringID& vertexName);
+        void bindVertexArray(uint32 vertexArrayIndex);
     };
 }
 
@@ -0,0 +1,116 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#include "RenderPipeline_OpenGL.h"
+
+#if defined(JUMARENDERENGINE_INCLUDE_RENDER_API_OPENGL)
+
+#include <GL/glew.h>
+
+#include "GeometryArena_OpenGL.h"
+#include "Material_OpenGL.h"
+#include "RenderEngine_OpenGL.h"
+#include "RenderTarget_OpenGL.h"
+#include "renderEngine/VertexBuffer.h"
+
+namespace JumaRenderEngine
+{
+    struct DrawElementsIndirectCommand_OpenGL
+    {
+        uint32 count = 0;
+        uint32 instanceCount = 0;
+        uint32 firstIndex = 0;
+        int32 baseVertex = 0;
+        uint32 baseInstance = 0;
+    };
+
+    RenderPipeline_OpenGL::~RenderPipeline_OpenGL()
+    {
+        clearOpenGL();
+    }
+
+    void RenderPipeline_OpenGL::clearOpenGL()
+    {
+        if (m_IndirectCommandBufferIndex != 0)
+        {
+            glDeleteBuffers(1, &m_IndirectCommandBufferIndex);
+            m_IndirectCommandBufferIndex = 0;
+        }
+    }
+
+    bool RenderPipeline_OpenGL::getGPUFrameTime(float& outMilliseconds) const
+    {
+        // Render targets could use different contexts, so frame time is the sum of their render times
+        jset<const RenderTarget_OpenGL*> renderTargets;
+        for (const auto& pipelineStage : getPipelineStages())
+        {
+            renderTargets.add(dynamic_cast<const RenderTarget_OpenGL*>(pipelineStage.value.renderTarget));
+        }
+
+        bool timeValid = false;
+        float frameTime = 0.0f;
+        for (const auto& renderTarget : renderTargets)
+        {
+            float renderTime = 0.0f;
+            if ((renderTarget != nullptr) && renderTarget->getGPURenderTime(renderTime))
+            {
+                frameTime += renderTime;
+                timeValid = true;
+            }
+        }
+        if (!timeValid)
+        {
+            return false;
+        }
+        outMilliseconds = frameTime;
+        return true;
+    }
+
+    bool RenderPipeline_OpenGL::onStartRender(RenderOptions* renderOptions)
+    {
+        if (!Super::onStartRender(renderOptions))
+        {
+            return false;
+        }
+
+        // Texture region updates are applied before any render target of the frame
+        getRenderEngine<RenderEngine_OpenGL>()->flushTextureUpdates();
+        return true;
+    }
+
+    void RenderPipeline_OpenGL::renderPrimitiveBatch(const RenderOptions* renderOptions, const RenderPrimitiveBatch& batch)
+    {
+        jarray<DrawElementsIndirectCommand_OpenGL> commands;
+        commands.reserve(batch.vertexBuffers.getSize());
+        for (const auto& vertexBuffer : batch.vertexBuffers)
+        {
+            const GeometryArenaAllocation* allocation = vertexBuffer->getGeometryAllocation();
+            DrawElementsIndirectCommand_OpenGL& command = commands.addDefault();
+            command.count = allocation->indexCount;
+            command.instanceCount = 1;
+            command.firstIndex = allocation->firstIndex;
+            command.baseVertex = static_cast<int32>(allocation->firstVertex);
+        }
+
+        GeometryArena_OpenGL* geometryArena = dynamic_cast<GeometryArena_OpenGL*>(batch.geometryArena);
+        Material_OpenGL* material = dynamic_cast<Material_OpenGL*>(batch.material);
+        if (!geometryArena->bindBuffers() || !material->bindMaterial())
+        {
+            return;
+        }
+
+        if (m_IndirectCommandBufferIndex == 0)
+        {
+            glGenBuffers(1, &m_IndirectCommandBufferIndex);
+        }
+        // Respecifying whole buffer orphans storage still read by previous draws
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_IndirectCommandBufferIndex);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, static_cast<GLsizeiptr>(commands.getSize() * sizeof(DrawElementsIndirectCommand_OpenGL)), 
+            commands.getData(), GL_STREAM_DRAW);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(commands.getSize()), 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+        material->unbindMaterial();
+    }
+}
+
+#endif
@@ -0,0 +1,38 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#pragma once
+
+#include "renderEngine/juma_render_engine_core.h"
+
+#if defined(JUMARENDERENGINE_INCLUDE_RENDER_API_OPENGL)
+
+#include "renderEngine/RenderPipeline.h"
+
+namespace JumaRenderEngine
+{
+    class RenderPipeline_OpenGL final : public RenderPipeline
+    {
+        using Super = RenderPipeline;
+
+    public:
+        RenderPipeline_OpenGL() = default;
+        virtual ~RenderPipeline_OpenGL() override;
+
+        virtual bool getGPUFrameTime(float& outMilliseconds) const override;
+
+    protected:
+
+        virtual bool onStartRender(RenderOptions* renderOptions) override;
+
+        virtual void renderPrimitiveBatch(const RenderOptions* renderOptions, const RenderPrimitiveBatch& batch) override;
+
+    private:
+
+        uint32 m_IndirectCommandBufferIndex = 0;
+
+
+        void clearOpenGL();
+    };
+}
+
+#endif
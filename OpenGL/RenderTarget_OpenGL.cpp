@@ -8,6 +8,7 @@
 
 #include "Texture_OpenGL.h"
 #include "renderEngine/RenderEngine.h"
+#include "renderEngine/RenderTargetOperations.h"
 #include "renderEngine/window/OpenGL/WindowController_OpenGL.h"
 
 namespace JumaRenderEngine
@@ -28,6 +29,12 @@ namespace JumaRenderEngine
     }
     void RenderTarget_OpenGL::createFramebuffers()
     {
+        if (isDepthOnly())
+        {
+            createDepthOnlyFramebuffer();
+            return;
+        }
+
         const TextureSamples sampleCount = getSampleCount();
 
         const bool renderToWindow = isWindowRenderTarget();
@@ -37,8 +44,9 @@ namespace JumaRenderEngine
             return;
         }
 
-        const GLenum colorFormat = GetOpenGLFormatByTextureFormat(getFormat());
-        const GLenum depthFormat = GetOpenGLFormatByTextureFormat(TextureFormat::DEPTH24_STENCIL8);
+        const TextureFormat format = getFormat();
+        const GLenum colorFormat = GetOpenGLInternalFormatByTextureFormat(format);
+        const GLenum depthFormat = GetOpenGLInternalFormatByTextureFormat(TextureFormat::DEPTH24_STENCIL8);
         const uint8 samplesNumber = GetTextureSamplesNumber(sampleCount);
         const bool depthEnabled = true;
         const bool resolveFramebufferEnabled = !renderToWindow && shouldResolveMultisampling;
@@ -65,12 +73,37 @@ namespace JumaRenderEngine
             glGenTextures(1, &colorAttachment);
             glBindTexture(GL_TEXTURE_2D, colorAttachment);
             glTexImage2D(GL_TEXTURE_2D, 
-                0, colorFormat, static_cast<GLsizei>(size.x), static_cast<GLsizei>(size.y), 0, 
-                GL_RGB, GL_UNSIGNED_BYTE, nullptr
+                0, static_cast<GLint>(colorFormat), static_cast<GLsizei>(size.x), static_cast<GLsizei>(size.y), 0, 
+                GetOpenGLFormatByTextureFormat(format), GetOpenGLTypeByTextureFormat(format), nullptr
             );
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
             glBindTexture(GL_TEXTURE_2D, 0);
             glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorAttachment, 0);
         }
+        // Render target with multiple color attachments is never multisampled
+        const uint8 colorAttachmentCount = getColorAttachmentCount();
+        if (colorAttachmentCount > 1)
+        {
+            GLenum drawBuffers[MaxColorAttachmentCount];
+            drawBuffers[0] = GL_COLOR_ATTACHMENT0;
+            m_AdditionalColorAttachments.resize(colorAttachmentCount - 1);
+            glGenTextures(colorAttachmentCount - 1, m_AdditionalColorAttachments.getData());
+            for (uint8 attachmentIndex = 1; attachmentIndex < colorAttachmentCount; attachmentIndex++)
+            {
+                const TextureFormat attachmentFormat = getColorAttachmentFormat(attachmentIndex);
+                const GLuint attachmentTexture = m_AdditionalColorAttachments[attachmentIndex - 1];
+                glBindTexture(GL_TEXTURE_2D, attachmentTexture);
+                glTexImage2D(GL_TEXTURE_2D, 
+                    0, static_cast<GLint>(GetOpenGLInternalFormatByTextureFormat(attachmentFormat)), static_cast<GLsizei>(size.x), static_cast<GLsizei>(size.y), 0, 
+                    GetOpenGLFormatByTextureFormat(attachmentFormat), GetOpenGLTypeByTextureFormat(attachmentFormat), nullptr
+                );
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+                glBindTexture(GL_TEXTURE_2D, 0);
+                glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + attachmentIndex, GL_TEXTURE_2D, attachmentTexture, 0);
+                drawBuffers[attachmentIndex] = GL_COLOR_ATTACHMENT0 + attachmentIndex;
+            }
+            glDrawBuffers(colorAttachmentCount, drawBuffers);
+        }
         if (depthEnabled)
         {
             glGenRenderbuffers(1, &depthAttachment);
@@ -94,9 +127,10 @@ namespace JumaRenderEngine
             glGenTextures(1, &resolveAttachment);
             glBindTexture(GL_TEXTURE_2D, resolveAttachment);
             glTexImage2D(GL_TEXTURE_2D, 
-                0, colorFormat, static_cast<GLsizei>(size.x), static_cast<GLsizei>(size.y), 0, 
-                GL_RGBA, GL_UNSIGNED_BYTE, nullptr
+                0, static_cast<GLint>(colorFormat), static_cast<GLsizei>(size.x), static_cast<GLsizei>(size.y), 0, 
+                GetOpenGLFormatByTextureFormat(format), GetOpenGLTypeByTextureFormat(format), nullptr
             );
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
             glBindTexture(GL_TEXTURE_2D, 0);
             glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, resolveAttachment, 0);
         }
@@ -108,6 +142,34 @@ namespace JumaRenderEngine
         m_ResolveFramebuffer = framebufferIndices[1];
         m_ResolveColorAttachment = resolveAttachment;
     }
+    void RenderTarget_OpenGL::createDepthOnlyFramebuffer()
+    {
+        const TextureFormat format = getFormat();
+        const math::uvector2 size = getSize();
+
+        GLuint framebuffer = 0, depthAttachment = 0;
+        getRenderEngine()->getWindowController<WindowController_OpenGL>()->setActiveWindowID(getWindowID());
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+
+        // Sampled as texture, so it can't be renderbuffer
+        glGenTextures(1, &depthAttachment);
+        glBindTexture(GL_TEXTURE_2D, depthAttachment);
+        glTexImage2D(GL_TEXTURE_2D, 
+            0, static_cast<GLint>(GetOpenGLInternalFormatByTextureFormat(format)), static_cast<GLsizei>(size.x), static_cast<GLsizei>(size.y), 0, 
+            GetOpenGLFormatByTextureFormat(format), GetOpenGLTypeByTextureFormat(format), nullptr
+        );
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, format == TextureFormat::DEPTH24_STENCIL8 ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT, 
+            GL_TEXTURE_2D, depthAttachment, 0);
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        m_Framebuffer = framebuffer;
+        m_DepthAttachment = depthAttachment;
+    }
     void RenderTarget_OpenGL::clearFramebuffers()
     {
         if (m_Framebuffer != 0)
@@ -120,19 +182,29 @@ namespace JumaRenderEngine
             m_ResolveFramebuffer = 0;
 
             const bool shouldResolveMultisampling = getSampleCount() != TextureSamples::X1;
-            if (shouldResolveMultisampling)
+            if (m_ColorAttachment != 0)
             {
-                glDeleteRenderbuffers(1, &m_ColorAttachment);
+                if (shouldResolveMultisampling)
+                {
+                    glDeleteRenderbuffers(1, &m_ColorAttachment);
+                }
+                else
+                {
+                    glDeleteTextures(1, &m_ColorAttachment);
+                }
+                m_ColorAttachment = 0;
             }
-            else
-            {
-                glDeleteTextures(1, &m_ColorAttachment);
-            }
-            m_ColorAttachment = 0;
 
             if (m_DepthAttachment != 0)
             {
-                glDeleteRenderbuffers(1, &m_DepthAttachment);
+                if (isDepthOnly())
+                {
+                    glDeleteTextures(1, &m_DepthAttachment);
+                }
+                else
+                {
+                    glDeleteRenderbuffers(1, &m_DepthAttachment);
+                }
                 m_DepthAttachment = 0;
             }
             if (m_ResolveColorAttachment != 0)
@@ -140,11 +212,29 @@ namespace JumaRenderEngine
                 glDeleteTextures(1, &m_ResolveColorAttachment);
                 m_ResolveColorAttachment = 0;
             }
+            if (!m_AdditionalColorAttachments.isEmpty())
+            {
+                glDeleteTextures(static_cast<GLsizei>(m_AdditionalColorAttachments.getSize()), m_AdditionalColorAttachments.getData());
+                m_AdditionalColorAttachments.clear();
+            }
         }
     }
 
     void RenderTarget_OpenGL::clearOpenGL()
     {
+        if (m_TimerQueries[0] != 0)
+        {
+            getRenderEngine()->getWindowController<WindowController_OpenGL>()->setActiveWindowID(getWindowID());
+            glDeleteQueries(2, m_TimerQueries);
+            m_TimerQueries[0] = 0;
+            m_TimerQueries[1] = 0;
+        }
+        m_TimerQueriesIssued[0] = false;
+        m_TimerQueriesIssued[1] = false;
+        m_TimerQueryIndex = 0;
+        m_GPURenderTime = -1.0f;
+        m_GPURenderTimeUpdated = false;
+
         clearFramebuffers();
     }
 
@@ -163,10 +253,35 @@ namespace JumaRenderEngine
         }
 
         getRenderEngine()->getWindowController<WindowController_OpenGL>()->setActiveWindowID(getWindowID());
+        if (m_TimerQueries[0] == 0)
+        {
+            glGenQueries(2, m_TimerQueries);
+        }
+        glBeginQuery(GL_TIME_ELAPSED, m_TimerQueries[m_TimerQueryIndex]);
         glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer);
 
-        glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+        const RenderTargetOperations& operations = GetRenderTargetOperations(renderOptions);
+        GLbitfield clearMask = 0;
+        if (!isDepthOnly() && (operations.colorLoadOperation == RenderTargetLoadOperation::Clear))
+        {
+            const math::vector4& clearColor = operations.clearColor;
+            glClearColor(clearColor.x, clearColor.y, clearColor.z, clearColor.w);
+            clearMask |= GL_COLOR_BUFFER_BIT;
+        }
+        if (operations.depthLoadOperation == RenderTargetLoadOperation::Clear)
+        {
+            glClearDepth(operations.clearDepth);
+            glClearStencil(operations.clearStencil);
+            clearMask |= GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT;
+        }
+        if (clearMask != 0)
+        {
+            glClear(clearMask);
+        }
+        invalidateAttachments(
+            !isDepthOnly() && (operations.colorLoadOperation == RenderTargetLoadOperation::DontCare), 
+            operations.depthLoadOperation == RenderTargetLoadOperation::DontCare
+        );
         glEnable(GL_DEPTH_TEST);
         glEnable(GL_BLEND);
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -174,16 +289,17 @@ namespace JumaRenderEngine
         glEnable(GL_CULL_FACE);
         glCullFace(GL_FRONT);
 
-        const math::uvector2 size = getSize();
+        const math::uvector2 size = getRenderSize();
         glViewport(0, 0, static_cast<GLsizei>(size.x), static_cast<GLsizei>(size.y));
         return true;
     }
     void RenderTarget_OpenGL::onFinishRender(RenderOptions* renderOptions)
     {
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        if (getSampleCount() != TextureSamples::X1)
+        const RenderTargetOperations& operations = GetRenderTargetOperations(renderOptions);
+        const bool multisampled = getSampleCount() != TextureSamples::X1;
+        if (multisampled && (operations.colorStoreOperation == RenderTargetStoreOperation::Store))
         {
-            const math::uvector2 size = getSize();
+            const math::uvector2 size = getRenderSize();
 
             glBindFramebuffer(GL_READ_FRAMEBUFFER, m_Framebuffer);
             glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_ResolveFramebuffer);
@@ -192,23 +308,130 @@ namespace JumaRenderEngine
                 0, 0, static_cast<GLint>(size.x), static_cast<GLint>(size.y), 
                 GL_COLOR_BUFFER_BIT, GL_NEAREST
             );
-            glBindFramebuffer(GL_FRAMEBUFFER, 0);
         }
-        const uint32 resultTextureIndex = getResultTextureIndex();
-        if (resultTextureIndex != 0)
+        // Multisampled color is not needed after resolve, so driver could skip storing it.
+        // Depth is the result of depth-only render target, so it's always stored
+        invalidateAttachments(
+            !isDepthOnly() && (multisampled || (operations.colorStoreOperation == RenderTargetStoreOperation::DontCare)), 
+            !isDepthOnly() && (operations.depthStoreOperation == RenderTargetStoreOperation::DontCare)
+        );
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        glEndQuery(GL_TIME_ELAPSED);
+        m_TimerQueriesIssued[m_TimerQueryIndex] = true;
+        m_TimerQueryIndex = (m_TimerQueryIndex + 1) % 2;
+        // Query of the previous render is reused on the next one
+        readTimerQuery(m_TimerQueryIndex);
+
+        Super::onFinishRender(renderOptions);
+    }
+
+    void RenderTarget_OpenGL::readTimerQuery(const uint8 queryIndex)
+    {
+        m_GPURenderTimeUpdated = false;
+        if (!m_TimerQueriesIssued[queryIndex])
         {
-            glBindTexture(GL_TEXTURE_2D, resultTextureIndex);
-            glGenerateMipmap(GL_TEXTURE_2D);
-            glBindTexture(GL_TEXTURE_2D, 0);
+            return;
         }
 
-        Super::onFinishRender(renderOptions);
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(m_TimerQueries[queryIndex], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available == GL_TRUE)
+        {
+            GLuint64 elapsedTime = 0;
+            glGetQueryObjectui64v(m_TimerQueries[queryIndex], GL_QUERY_RESULT, &elapsedTime);
+            m_GPURenderTime = static_cast<float>(static_cast<double>(elapsedTime) / 1000000.0);
+            m_GPURenderTimeUpdated = true;
+        }
+        m_TimerQueriesIssued[queryIndex] = false;
+    }
+    bool RenderTarget_OpenGL::getGPURenderTime(float& outMilliseconds) const
+    {
+        if (!m_GPURenderTimeUpdated || (m_GPURenderTime < 0.0f))
+        {
+            return false;
+        }
+        outMilliseconds = m_GPURenderTime;
+        return true;
+    }
+
+    void RenderTarget_OpenGL::invalidateAttachments(const bool color, const bool depth) const
+    {
+        // Default framebuffer uses different attachment names
+        const bool defaultFramebuffer = m_Framebuffer == 0;
+        GLenum attachments[2 + MaxColorAttachmentCount];
+        GLsizei attachmentCount = 0;
+        if (color)
+        {
+            attachments[attachmentCount++] = defaultFramebuffer ? GL_COLOR : GL_COLOR_ATTACHMENT0;
+            for (int32 index = 0; index < m_AdditionalColorAttachments.getSize(); index++)
+            {
+                attachments[attachmentCount++] = GL_COLOR_ATTACHMENT1 + index;
+            }
+        }
+        if (depth)
+        {
+            if (defaultFramebuffer)
+            {
+                attachments[attachmentCount++] = GL_DEPTH;
+                attachments[attachmentCount++] = GL_STENCIL;
+            }
+            else
+            {
+                attachments[attachmentCount++] = GL_DEPTH_STENCIL_ATTACHMENT;
+            }
+        }
+        if (attachmentCount > 0)
+        {
+            glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer);
+            glInvalidateFramebuffer(GL_FRAMEBUFFER, attachmentCount, attachments);
+        }
     }
 
-    bool RenderTarget_OpenGL::bindToShader(const uint32 bindIndex) const
+    void RenderTarget_OpenGL::updateMips()
     {
         const uint32 resultTextureIndex = getResultTextureIndex();
-        return resultTextureIndex != 0 ? Texture_OpenGL::bindToShader(this, resultTextureIndex, bindIndex, getSamplerType()) : false;
+        if ((resultTextureIndex == 0) || !shouldUpdateMips())
+        {
+            return;
+        }
+
+        // Mip levels are allocated by the first generation, until then only level 0 is complete
+        glBindTexture(GL_TEXTURE_2D, resultTextureIndex);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, GetMipLevelCountByTextureSize(getSize()) - 1);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        onMipsUpdated();
+    }
+    uint32 RenderTarget_OpenGL::getResultTextureIndex(const uint8 attachmentIndex) const
+    {
+        if (isWindowRenderTarget())
+        {
+            return 0;
+        }
+        if (attachmentIndex > 0)
+        {
+            return m_AdditionalColorAttachments.isValidIndex(attachmentIndex - 1) ? m_AdditionalColorAttachments[attachmentIndex - 1] : 0;
+        }
+        if (isDepthOnly())
+        {
+            return m_DepthAttachment;
+        }
+        return m_ResolveColorAttachment != 0 ? m_ResolveColorAttachment : m_ColorAttachment;
+    }
+    bool RenderTarget_OpenGL::bindToShader(const uint32 bindIndex, const uint8 attachmentIndex)
+    {
+        const uint32 resultTextureIndex = getResultTextureIndex(attachmentIndex);
+        if (resultTextureIndex == 0)
+        {
+            return false;
+        }
+        if (attachmentIndex == 0)
+        {
+            updateMips();
+            return Texture_OpenGL::bindToShader(this, resultTextureIndex, bindIndex, getSamplerType());
+        }
+        return Texture_OpenGL::bindToShader(this, resultTextureIndex, bindIndex, getColorAttachment(attachmentIndex)->getSamplerType());
     }
 }
 
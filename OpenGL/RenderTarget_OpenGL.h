@@ -8,6 +8,8 @@
 
 #include "renderEngine/RenderTarget.h"
 
+#include "jutils/jarray.h"
+
 namespace JumaRenderEngine
 {
     class RenderTarget_OpenGL final : public RenderTarget
@@ -18,12 +20,16 @@ namespace JumaRenderEngine
         RenderTarget_OpenGL() = default;
         virtual ~RenderTarget_OpenGL() override;
 
-        uint32 getResultTextureIndex() const { return !isWindowRenderTarget() ? (m_ResolveColorAttachment != 0 ? m_ResolveColorAttachment : m_ColorAttachment) : 0; }
+        uint32 getResultTextureIndex(uint8 attachmentIndex = 0) const;
 
         virtual bool onStartRender(RenderOptions* renderOptions) override;
         virtual void onFinishRender(RenderOptions* renderOptions) override;
 
-        bool bindToShader(uint32 bindIndex) const;
+        // Generates mips first if they are outdated and sampler uses them, additional color attachments don't have mips
+        bool bindToShader(uint32 bindIndex, uint8 attachmentIndex = 0);
+
+        // Measured without stalls, so it is the time of one of the previous renders
+        bool getGPURenderTime(float& outMilliseconds) const;
 
     protected:
 
@@ -36,14 +42,31 @@ namespace JumaRenderEngine
         uint32 m_ColorAttachment = 0;
         uint32 m_DepthAttachment = 0;
         uint32 m_ResolveColorAttachment = 0;
+        // Bound to GL_COLOR_ATTACHMENT1 and next ones
+        jarray<uint32> m_AdditionalColorAttachments;
 
         uint32 m_Framebuffer = 0;
         uint32 m_ResolveFramebuffer = 0;
 
+        // Queries are not shared between contexts, so each render target has its own ones
+        uint32 m_TimerQueries[2] = { 0, 0 };
+        bool m_TimerQueriesIssued[2] = { false, false };
+        uint8 m_TimerQueryIndex = 0;
+        float m_GPURenderTime = -1.0f;
+        // Result of the query could be not available yet, so old time shouldn't be reported again
+        bool m_GPURenderTimeUpdated = false;
+
 
         void createFramebuffers();
+        void createDepthOnlyFramebuffer();
         void clearFramebuffers();
 
+        void invalidateAttachments(bool color, bool depth) const;
+
+        void updateMips();
+
+        void readTimerQuery(uint8 queryIndex);
+
         void clearOpenGL();
     };
 }
@@ -0,0 +1,79 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#include "TextureArray_OpenGL.h"
+
+#if defined(JUMARENDERENGINE_INCLUDE_RENDER_API_OPENGL)
+
+#include "RenderEngine_OpenGL.h"
+#include "Texture_OpenGL.h"
+
+namespace JumaRenderEngine
+{
+    TextureArray_OpenGL::~TextureArray_OpenGL()
+    {
+        clearOpenGL();
+    }
+
+    bool TextureArray_OpenGL::initInternal(const math::uvector2& size, const TextureFormat format, const jarray<const uint8*>& layersData)
+    {
+        const GLenum internalFormat = GetOpenGLInternalFormatByTextureFormat(format);
+        if (internalFormat == 0)
+        {
+            JUMA_RENDER_LOG(error, JSTR("Unsupported texture format"));
+            return false;
+        }
+
+        const GLenum formatOpenGL = GetOpenGLFormatByTextureFormat(format);
+        const GLenum typeOpenGL = GetOpenGLTypeByTextureFormat(format);
+        const GLsizei layerCount = static_cast<GLsizei>(layersData.getSize());
+        glGenTextures(1, &m_TextureIndex);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, m_TextureIndex);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexStorage3D(GL_TEXTURE_2D_ARRAY, 
+            GetMipLevelCountByTextureSize(size), internalFormat, static_cast<GLsizei>(size.x), static_cast<GLsizei>(size.y), layerCount
+        );
+        for (GLsizei layer = 0; layer < layerCount; layer++)
+        {
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 
+                0, 0, 0, layer, static_cast<GLsizei>(size.x), static_cast<GLsizei>(size.y), 1, 
+                formatOpenGL, typeOpenGL, layersData[layer]
+            );
+        }
+        glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+        return true;
+    }
+
+    void TextureArray_OpenGL::clearOpenGL()
+    {
+        if (m_TextureIndex != 0)
+        {
+            glDeleteTextures(1, &m_TextureIndex);
+            m_TextureIndex = 0;
+        }
+    }
+
+    bool TextureArray_OpenGL::bindToShader(const uint32 bindIndex) const
+    {
+        if (m_TextureIndex == 0)
+        {
+            return false;
+        }
+
+        const uint32 samplerIndex = getRenderEngine<RenderEngine_OpenGL>()->getTextureSamplerIndex(getSamplerType());
+
+        glActiveTexture(GL_TEXTURE0 + bindIndex);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, m_TextureIndex);
+        glBindSampler(bindIndex, samplerIndex);
+        return true;
+    }
+    void TextureArray_OpenGL::unbindTexture(const uint32 bindIndex)
+    {
+        glActiveTexture(GL_TEXTURE0 + bindIndex);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+        glBindSampler(bindIndex, 0);
+    }
+}
+
+#endif
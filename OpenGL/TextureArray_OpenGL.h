@@ -0,0 +1,37 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#pragma once
+
+#include "renderEngine/juma_render_engine_core.h"
+
+#if defined(JUMARENDERENGINE_INCLUDE_RENDER_API_OPENGL)
+
+#include "renderEngine/TextureArray.h"
+
+namespace JumaRenderEngine
+{
+    class TextureArray_OpenGL final : public TextureArray
+    {
+        using Super = TextureArray;
+
+    public:
+        TextureArray_OpenGL() = default;
+        virtual ~TextureArray_OpenGL() override;
+
+        bool bindToShader(uint32 bindIndex) const;
+        static void unbindTexture(uint32 bindIndex);
+
+    protected:
+
+        virtual bool initInternal(const math::uvector2& size, TextureFormat format, const jarray<const uint8*>& layersData) override;
+
+    private:
+
+        uint32 m_TextureIndex = 0;
+
+
+        void clearOpenGL();
+    };
+}
+
+#endif
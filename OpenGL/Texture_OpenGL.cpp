@@ -13,32 +13,62 @@ namespace JumaRenderEngine
         clearOpenGL();
     }
 
-    bool Texture_OpenGL::initInternal(const math::uvector2& size, const TextureFormat format, const uint8* data)
+    bool Texture_OpenGL::initInternal(const math::uvector2& size, const TextureFormat format, const jarray<const uint8*>& mipLevelsData)
     {
-        const GLenum formatOpenGL = GetOpenGLFormatByTextureFormat(format);
-        if (formatOpenGL == 0)
+        const GLenum internalFormat = GetOpenGLInternalFormatByTextureFormat(format);
+        if (internalFormat == 0)
         {
             JUMA_RENDER_LOG(error, JSTR("Unsupported texture format"));
             return false;
         }
 
+        const bool compressed = IsTextureFormatCompressed(format);
         glGenTextures(1, &m_TextureIndex);
         glBindTexture(GL_TEXTURE_2D, m_TextureIndex);
         glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-        glTexImage2D(
-            GL_TEXTURE_2D, 0, GL_RGBA, 
-            static_cast<GLsizei>(size.x), static_cast<GLsizei>(size.y), 0, formatOpenGL, GL_UNSIGNED_BYTE, data
-        );
-        glGenerateMipmap(GL_TEXTURE_2D);
+        math::uvector2 levelSize = size;
+        for (int32 mipLevel = 0; mipLevel < mipLevelsData.getSize(); mipLevel++)
+        {
+            if (compressed)
+            {
+                glCompressedTexImage2D(
+                    GL_TEXTURE_2D, mipLevel, internalFormat, static_cast<GLsizei>(levelSize.x), static_cast<GLsizei>(levelSize.y), 0, 
+                    static_cast<GLsizei>(GetTextureDataSize(format, levelSize.x, levelSize.y)), mipLevelsData[mipLevel]
+                );
+            }
+            else
+            {
+                glTexImage2D(
+                    GL_TEXTURE_2D, mipLevel, static_cast<GLint>(internalFormat), static_cast<GLsizei>(levelSize.x), static_cast<GLsizei>(levelSize.y), 0, 
+                    GetOpenGLFormatByTextureFormat(format), GetOpenGLTypeByTextureFormat(format), mipLevelsData[mipLevel]
+                );
+            }
+            levelSize = { math::max(levelSize.x / 2, 1u), math::max(levelSize.y / 2, 1u) };
+        }
+        if ((mipLevelsData.getSize() == 1) && !compressed)
+        {
+            glGenerateMipmap(GL_TEXTURE_2D);
+        }
+        else
+        {
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mipLevelsData.getSize() - 1);
+        }
         glBindTexture(GL_TEXTURE_2D, 0);
 
         return true;
     }
 
+    bool Texture_OpenGL::updateRegionInternal(const math::uvector2& offset, const math::uvector2& size, const uint32 mipLevel, const uint8* data)
+    {
+        getRenderEngine<RenderEngine_OpenGL>()->addTextureUpdate(m_TextureIndex, getFormat(), mipLevel, offset, size, data);
+        return true;
+    }
+
     void Texture_OpenGL::clearOpenGL()
     {
         if (m_TextureIndex != 0)
         {
+            getRenderEngine<RenderEngine_OpenGL>()->removeTextureUpdates(m_TextureIndex);
             glDeleteTextures(1, &m_TextureIndex);
             m_TextureIndex = 0;
         }
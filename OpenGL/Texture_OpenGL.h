@@ -12,14 +12,73 @@
 
 namespace JumaRenderEngine
 {
+    constexpr GLenum GetOpenGLInternalFormatByTextureFormat(const TextureFormat format)
+    {
+        switch (format)
+        {
+        case TextureFormat::RGBA8: return GL_RGBA8;
+        case TextureFormat::BGRA8: return GL_RGBA8;
+        case TextureFormat::R8: return GL_R8;
+        case TextureFormat::RG8: return GL_RG8;
+        case TextureFormat::R16F: return GL_R16F;
+        case TextureFormat::RG16F: return GL_RG16F;
+        case TextureFormat::RGBA16F: return GL_RGBA16F;
+        case TextureFormat::R32F: return GL_R32F;
+        case TextureFormat::R11G11B10F: return GL_R11F_G11F_B10F;
+        case TextureFormat::DEPTH32: return GL_DEPTH_COMPONENT32F;
+        case TextureFormat::DEPTH24_STENCIL8: return GL_DEPTH24_STENCIL8;
+        case TextureFormat::BC1_RGBA: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+        case TextureFormat::BC3_RGBA: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case TextureFormat::BC4_R: return GL_COMPRESSED_RED_RGTC1;
+        case TextureFormat::BC5_RG: return GL_COMPRESSED_RG_RGTC2;
+        case TextureFormat::BC7_RGBA: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+        case TextureFormat::ETC2_RGB8: return GL_COMPRESSED_RGB8_ETC2;
+        case TextureFormat::ETC2_RGBA8: return GL_COMPRESSED_RGBA8_ETC2_EAC;
+        default: ;
+        }
+        return 0;
+    }
+    // Format of the pixel data, 0 for compressed formats
     constexpr GLenum GetOpenGLFormatByTextureFormat(const TextureFormat format)
     {
         switch (format)
         {
         case TextureFormat::RGBA8: return GL_RGBA;
         case TextureFormat::BGRA8: return GL_BGRA;
-        case TextureFormat::DEPTH32: return GL_DEPTH_COMPONENT32F;
-        case TextureFormat::DEPTH24_STENCIL8: return GL_DEPTH24_STENCIL8;
+        case TextureFormat::R8: return GL_RED;
+        case TextureFormat::RG8: return GL_RG;
+        case TextureFormat::R16F: return GL_RED;
+        case TextureFormat::RG16F: return GL_RG;
+        case TextureFormat::RGBA16F: return GL_RGBA;
+        case TextureFormat::R32F: return GL_RED;
+        case TextureFormat::R11G11B10F: return GL_RGB;
+        case TextureFormat::DEPTH32: return GL_DEPTH_COMPONENT;
+        case TextureFormat::DEPTH24_STENCIL8: return GL_DEPTH_STENCIL;
+        default: ;
+        }
+        return 0;
+    }
+    constexpr GLenum GetOpenGLTypeByTextureFormat(const TextureFormat format)
+    {
+        switch (format)
+        {
+        case TextureFormat::RGBA8:
+        case TextureFormat::BGRA8:
+        case TextureFormat::R8:
+        case TextureFormat::RG8:
+            return GL_UNSIGNED_BYTE;
+
+        case TextureFormat::R16F:
+        case TextureFormat::RG16F:
+        case TextureFormat::RGBA16F:
+            return GL_HALF_FLOAT;
+
+        case TextureFormat::R32F:
+        case TextureFormat::DEPTH32:
+            return GL_FLOAT;
+
+        case TextureFormat::R11G11B10F: return GL_UNSIGNED_INT_10F_11F_11F_REV;
+        case TextureFormat::DEPTH24_STENCIL8: return GL_UNSIGNED_INT_24_8;
         default: ;
         }
         return 0;
@@ -39,7 +98,9 @@ namespace JumaRenderEngine
 
     protected:
 
-        virtual bool initInternal(const math::uvector2& size, TextureFormat format, const uint8* data) override;
+        virtual bool initInternal(const math::uvector2& size, TextureFormat format, const jarray<const uint8*>& mipLevelsData) override;
+
+        virtual bool updateRegionInternal(const math::uvector2& offset, const math::uvector2& size, uint32 mipLevel, const uint8* data) override;
 
     private:
 
@@ -6,12 +6,11 @@
 
 #include <GL/glew.h>
 
+#include "GeometryArena_OpenGL.h"
 #include "Material_OpenGL.h"
-#include "renderEngine/RenderEngine.h"
+#include "RenderEngine_OpenGL.h"
 #include "renderEngine/RenderOptions.h"
-#include "renderEngine/RenderTarget.h"
 #include "renderEngine/vertex/VertexBufferData.h"
-#include "renderEngine/window/OpenGL/WindowController_OpenGL.h"
 
 namespace JumaRenderEngine
 {
@@ -22,70 +21,69 @@ namespace JumaRenderEngine
 
     bool VertexBuffer_OpenGL::initInternal(VertexBufferData* verticesData)
     {
-        const uint32 vertexCount = verticesData->getVertexCount();
-        if (vertexCount == 0)
+        if (isDynamic())
         {
-            JUMA_RENDER_LOG(error, JSTR("Empty vertex buffer data"));
-            return false;
+            glGenBuffers(1, &m_DynamicVerticesBufferIndex);
+            glGenBuffers(1, &m_DynamicIndicesBufferIndex);
+            return updateInternal(verticesData);
         }
-        const VertexDescription* vertexDescription = getRenderEngine()->findVertexType(getVertexTypeName());
-
-        uint32 verticesVBO = 0, indicesVBO = 0;
-        glGenBuffers(1, &verticesVBO);
-        glBindBuffer(GL_ARRAY_BUFFER, verticesVBO);
-        glBufferData(
-            GL_ARRAY_BUFFER, static_cast<int32>(vertexDescription->size * vertexCount), verticesData->getVertices(), GL_STATIC_DRAW
-        );
 
-        const uint32 indexCount = verticesData->getIndexCount();
-        if (indexCount > 0)
+        const GeometryArenaAllocation* allocation = getRenderEngine()->allocateGeometry(verticesData);
+        if (allocation == nullptr)
         {
-            glGenBuffers(1, &indicesVBO);
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indicesVBO);
-            glBufferData(
-                GL_ELEMENT_ARRAY_BUFFER,
-                static_cast<int32>(sizeof(uint32) * indexCount), 
-                verticesData->getIndices(), 
-                GL_STATIC_DRAW
-            );
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+            JUMA_RENDER_LOG(error, JSTR("Failed to allocate vertex buffer data in geometry arena"));
+            return false;
         }
 
-        m_VerticesBufferIndex = verticesVBO;
-        m_IndicesBufferIndex = indicesVBO;
-        m_RenderElementsCount = static_cast<int32>(indexCount > 0 ? indexCount : vertexCount);
+        m_GeometryAllocation = allocation;
         return true;
     }
 
     void VertexBuffer_OpenGL::clearOpenGL()
     {
-        if (!m_VertexArrayIndices.isEmpty())
+        if (m_GeometryAllocation != nullptr)
         {
-            WindowController_OpenGL* windowController = getRenderEngine()->getWindowController<WindowController_OpenGL>();
-            const window_id prevWindowID = windowController->getActiveWindowID();
-            for (const auto& VAO : m_VertexArrayIndices)
-            {
-                if (VAO.value != 0)
-                {
-                    windowController->setActiveWindowID(VAO.key);
-                    glDeleteVertexArrays(1, &VAO.value);
-                }
-            }
-            windowController->setActiveWindowID(prevWindowID);
-            m_VertexArrayIndices.clear();
+            m_GeometryAllocation->arena->free(m_GeometryAllocation);
+            m_GeometryAllocation = nullptr;
+        }
+
+        if ((m_DynamicVerticesBufferIndex != 0) || (m_DynamicIndicesBufferIndex != 0))
+        {
+            getRenderEngine<RenderEngine_OpenGL>()->onVertexBuffersDeleted(m_DynamicVerticesBufferIndex, m_DynamicIndicesBufferIndex);
         }
-        
-        if (m_IndicesBufferIndex != 0)
+        if (m_DynamicIndicesBufferIndex != 0)
         {
-            glDeleteBuffers(1, &m_IndicesBufferIndex);
-            m_IndicesBufferIndex = 0;
+            glDeleteBuffers(1, &m_DynamicIndicesBufferIndex);
+            m_DynamicIndicesBufferIndex = 0;
         }
-        if (m_VerticesBufferIndex != 0)
+        if (m_DynamicVerticesBufferIndex != 0)
         {
-            glDeleteBuffers(1, &m_VerticesBufferIndex);
-            m_VerticesBufferIndex = 0;
+            glDeleteBuffers(1, &m_DynamicVerticesBufferIndex);
+            m_DynamicVerticesBufferIndex = 0;
         }
-        m_RenderElementsCount = 0;
+        m_DynamicVertexCount = 0;
+        m_DynamicIndexCount = 0;
+    }
+
+    bool VertexBuffer_OpenGL::updateInternal(VertexBufferData* verticesData)
+    {
+        const VertexDescription* vertexDescription = getRenderEngine()->findVertexType(getVertexTypeName());
+        const uint32 vertexCount = verticesData->getVertexCount();
+        const uint32 indexCount = verticesData->getIndexCount();
+
+        // Respecifying whole buffer orphans old storage, so driver doesn't stall on draws still reading it
+        glBindBuffer(GL_COPY_WRITE_BUFFER, m_DynamicVerticesBufferIndex);
+        glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(vertexCount * vertexDescription->size), verticesData->getVertices(), GL_STREAM_DRAW);
+        if (indexCount > 0)
+        {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, m_DynamicIndicesBufferIndex);
+            glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(indexCount * sizeof(uint32)), verticesData->getIndices(), GL_STREAM_DRAW);
+        }
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        m_DynamicVertexCount = vertexCount;
+        m_DynamicIndexCount = indexCount;
+        return true;
     }
 
     void VertexBuffer_OpenGL::render(const RenderOptions* renderOptions, Material* material)
@@ -96,87 +94,44 @@ namespace JumaRenderEngine
         }
 
         Material_OpenGL* materialOpenGL = dynamic_cast<Material_OpenGL*>(material);
+        if (isDynamic())
+        {
+            RenderEngine_OpenGL* renderEngine = getRenderEngine<RenderEngine_OpenGL>();
+            if ((m_DynamicVertexCount > 0) && renderEngine->bindVertexBuffers(getVertexTypeName(), m_DynamicVerticesBufferIndex, m_DynamicIndicesBufferIndex) && 
+                materialOpenGL->bindMaterial())
+            {
+                if (m_DynamicIndexCount > 0)
+                {
+                    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_DynamicIndexCount), GL_UNSIGNED_INT, nullptr);
+                }
+                else
+                {
+                    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(m_DynamicVertexCount));
+                }
 
-        const window_id windowID = renderOptions->renderTarget->getWindowID();
-        const uint32 VAO = getVerticesVAO(windowID);
-        if ((VAO != 0) && materialOpenGL->bindMaterial())
+                materialOpenGL->unbindMaterial();
+            }
+            return;
+        }
+
+        GeometryArena_OpenGL* geometryArena = dynamic_cast<GeometryArena_OpenGL*>(m_GeometryAllocation->arena);
+        if (geometryArena->bindBuffers() && materialOpenGL->bindMaterial())
         {
-            glBindVertexArray(VAO);
-            if (m_IndicesBufferIndex != 0)
+            if (m_GeometryAllocation->indexCount > 0)
             {
-                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_IndicesBufferIndex);
-                glDrawElements(GL_TRIANGLES, m_RenderElementsCount, GL_UNSIGNED_INT, nullptr);
-                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+                glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(m_GeometryAllocation->indexCount), GL_UNSIGNED_INT,
+                    (const void*)static_cast<std::uintptr_t>(m_GeometryAllocation->firstIndex * sizeof(uint32)),
+                    static_cast<GLint>(m_GeometryAllocation->firstVertex)
+                );
             }
             else
             {
-                glDrawArrays(GL_TRIANGLES, 0, m_RenderElementsCount);
+                glDrawArrays(GL_TRIANGLES, static_cast<GLint>(m_GeometryAllocation->firstVertex), static_cast<GLsizei>(m_GeometryAllocation->vertexCount));
             }
-            glBindVertexArray(0);
 
             materialOpenGL->unbindMaterial();
         }
     }
-    uint32 VertexBuffer_OpenGL::getVerticesVAO(const window_id windowID)
-    {
-        const uint32* VAOPtr = m_VertexArrayIndices.find(windowID);
-        if (VAOPtr != nullptr)
-        {
-            return *VAOPtr;
-        }
-
-        const uint32 VAO = createVerticesVAO();
-        return VAO != 0 ? (m_VertexArrayIndices[windowID] = VAO) : 0;
-    }
-    uint32 VertexBuffer_OpenGL::createVerticesVAO() const
-    {
-        const VertexDescription* vertexDescription = getRenderEngine()->findVertexType(getVertexTypeName());
-        if (vertexDescription == nullptr)
-        {
-            return 0;
-        }
-
-        uint32 VAO = 0;
-        glGenVertexArrays(1, &VAO);
-        glBindBuffer(GL_ARRAY_BUFFER, m_VerticesBufferIndex);
-        glBindVertexArray(VAO);
-        for (int32 index = 0; index < vertexDescription->components.getSize(); index++)
-        {
-            const VertexComponentDescription& componentDescriprion = vertexDescription->components[index];
-
-            GLenum componentType;
-            GLint componentSize;
-            switch (componentDescriprion.type)
-            {
-            case VertexComponentType::Float: 
-                componentType = GL_FLOAT;
-                componentSize = 1;
-                break;
-            case VertexComponentType::Vec2: 
-                componentType = GL_FLOAT;
-                componentSize = 2;
-                break;
-            case VertexComponentType::Vec3: 
-                componentType = GL_FLOAT;
-                componentSize = 3;
-                break;
-            case VertexComponentType::Vec4: 
-                componentType = GL_FLOAT;
-                componentSize = 4;
-                break;
-            default: continue;
-            }
-            
-            glVertexAttribPointer(
-                componentDescriprion.shaderLocation, componentSize, componentType, GL_FALSE, 
-                static_cast<GLsizei>(vertexDescription->size), (const void*)static_cast<std::uintptr_t>(componentDescriprion.offset)
-            );
-            glEnableVertexAttribArray(componentDescriprion.shaderLocation);
-        }
-        glBindVertexArray(0);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        return VAO;
-    }
 }
 
 #endif
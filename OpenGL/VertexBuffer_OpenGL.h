@@ -8,11 +8,10 @@
 
 #include "renderEngine/VertexBuffer.h"
 
-#include "jutils/jmap.h"
-#include "renderEngine/window/window_id.h"
-
 namespace JumaRenderEngine
 {
+    struct GeometryArenaAllocation;
+
     class VertexBuffer_OpenGL final : public VertexBuffer
     {
         using Super = VertexBuffer;
@@ -21,25 +20,26 @@ namespace JumaRenderEngine
         VertexBuffer_OpenGL() = default;
         virtual ~VertexBuffer_OpenGL() override;
 
+        virtual const GeometryArenaAllocation* getGeometryAllocation() const override { return m_GeometryAllocation; }
+
         virtual void render(const RenderOptions* renderOptions, Material* material) override;
 
     protected:
 
         virtual bool initInternal(VertexBufferData* verticesData) override;
+        virtual bool updateInternal(VertexBufferData* verticesData) override;
 
     private:
 
-        uint32 m_VerticesBufferIndex = 0;
-        uint32 m_IndicesBufferIndex = 0;
-        jmap<window_id, uint32> m_VertexArrayIndices;
+        const GeometryArenaAllocation* m_GeometryAllocation = nullptr;
 
-        int32 m_RenderElementsCount = 0;
+        uint32 m_DynamicVerticesBufferIndex = 0;
+        uint32 m_DynamicIndicesBufferIndex = 0;
+        uint32 m_DynamicVertexCount = 0;
+        uint32 m_DynamicIndexCount = 0;
 
 
         void clearOpenGL();
-
-        uint32 getVerticesVAO(window_id windowID);
-        uint32 createVerticesVAO() const;
     };
 }
 
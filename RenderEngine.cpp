@@ -2,11 +2,16 @@
 
 #include "RenderEngine.h"
 
+#include "DynamicResolutionController.h"
+#include "GeometryArena.h"
 #include "Material.h"
 #include "RenderPipeline.h"
 #include "RenderTarget.h"
+#include "ResidencyManager.h"
 #include "Shader.h"
 #include "Texture.h"
+#include "TextureArray.h"
+#include "TextureStreamer.h"
 #include "VertexBuffer.h"
 #include "vertex/VertexBufferData.h"
 
@@ -84,10 +89,57 @@ namespace JumaRenderEngine
         }
         m_RenderPipeline = renderPipeline;
 
+        TextureStreamer* textureStreamer = createObject<TextureStreamer>();
+        if (!textureStreamer->init())
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to init texture streamer"));
+            delete textureStreamer;
+            return false;
+        }
+        m_TextureStreamer = textureStreamer;
+
+        ResidencyManager* residencyManager = createObject<ResidencyManager>();
+        if (!residencyManager->init())
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to init residency manager"));
+            delete residencyManager;
+            return false;
+        }
+        m_ResidencyManager = residencyManager;
+
+        DynamicResolutionController* dynamicResolutionController = createObject<DynamicResolutionController>();
+        if (!dynamicResolutionController->init())
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to init dynamic resolution controller"));
+            delete dynamicResolutionController;
+            return false;
+        }
+        m_DynamicResolutionController = dynamicResolutionController;
+
         return true;
     }
     void RenderEngine::clearRenderAssets()
     {
+        if (m_DynamicResolutionController != nullptr)
+        {
+            delete m_DynamicResolutionController;
+            m_DynamicResolutionController = nullptr;
+        }
+        if (m_ResidencyManager != nullptr)
+        {
+            delete m_ResidencyManager;
+            m_ResidencyManager = nullptr;
+        }
+        if (m_TextureStreamer != nullptr)
+        {
+            if (m_RenderPipeline != nullptr)
+            {
+                m_RenderPipeline->waitForRenderFinished();
+            }
+            delete m_TextureStreamer;
+            m_TextureStreamer = nullptr;
+        }
+        clearGeometryArenas();
         if (m_RenderPipeline != nullptr)
         {
             delete m_RenderPipeline;
@@ -115,6 +167,7 @@ namespace JumaRenderEngine
             m_WindowController = nullptr;
         }
         m_RegisteredVertexTypes.clear();
+        m_UploadBatchActive = false;
     }
 
     void RenderEngine::registerObjectInternal(RenderEngineContextObjectBase* object)
@@ -137,7 +190,22 @@ namespace JumaRenderEngine
         }
 
         VertexBuffer* vertexBuffer = createVertexBufferInternal();
-        if (!vertexBuffer->init(verticesData))
+        if (!vertexBuffer->init(verticesData, false))
+        {
+            delete vertexBuffer;
+            return nullptr;
+        }
+        return vertexBuffer;
+    }
+    VertexBuffer* RenderEngine::createDynamicVertexBuffer(VertexBufferData* verticesData)
+    {
+        if (registerVertexType(verticesData) == nullptr)
+        {
+            return nullptr;
+        }
+
+        VertexBuffer* vertexBuffer = createVertexBufferInternal();
+        if (!vertexBuffer->init(verticesData, true))
         {
             delete vertexBuffer;
             return nullptr;
@@ -168,16 +236,127 @@ namespace JumaRenderEngine
         return description;
     }
 
+    const GeometryArenaAllocation* RenderEngine::allocateGeometry(const VertexBufferData* verticesData)
+    {
+        const VertexDescription* description = registerVertexType(verticesData);
+        if (description == nullptr)
+        {
+            return nullptr;
+        }
+
+        const uint32 vertexCount = verticesData->getVertexCount();
+        const uint32 indexCount = verticesData->getIndexCount();
+        jarray<GeometryArena*>& arenas = m_GeometryArenas[verticesData->getVertexTypeName()];
+        for (const auto& arena : arenas)
+        {
+            if (arena->canAllocate(vertexCount, indexCount))
+            {
+                const GeometryArenaAllocation* allocation = arena->allocate(verticesData);
+                if (allocation != nullptr)
+                {
+                    return allocation;
+                }
+            }
+        }
+
+        GeometryArena* arena = createGeometryArenaInternal();
+        if (arena == nullptr)
+        {
+            return nullptr;
+        }
+        const uint32 vertexCapacity = math::max(GeometryArena::DefaultVertexCapacity, vertexCount);
+        const uint32 indexCapacity = math::max(GeometryArena::DefaultIndexCapacity, indexCount);
+        if (!arena->init(verticesData->getVertexTypeName(), description->size, vertexCapacity, indexCapacity))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to create geometry arena for vertex type {}"), verticesData->getVertexTypeName().toString());
+            delete arena;
+            return nullptr;
+        }
+        arenas.add(arena);
+        return arena->allocate(verticesData);
+    }
+    void RenderEngine::compactGeometryArenas(const float minFragmentation)
+    {
+        if (m_UploadBatchActive)
+        {
+            JUMA_RENDER_LOG(warning, JSTR("Can't compact geometry arenas while upload batch is recording"));
+            return;
+        }
+
+        for (auto& arenas : m_GeometryArenas)
+        {
+            for (int32 index = arenas.value.getSize() - 1; index >= 0; index--)
+            {
+                GeometryArena* arena = arenas.value[index];
+                if (arena->isEmpty() && (arenas.value.getSize() > 1))
+                {
+                    if (m_RenderPipeline != nullptr)
+                    {
+                        m_RenderPipeline->waitForRenderFinished();
+                    }
+                    delete arena;
+                    arenas.value.removeAt(index);
+                }
+                else if (arena->getFragmentation() >= minFragmentation)
+                {
+                    arena->compact();
+                }
+            }
+        }
+    }
+    void RenderEngine::clearGeometryArenas()
+    {
+        for (const auto& arenas : m_GeometryArenas)
+        {
+            for (const auto& arena : arenas.value)
+            {
+                delete arena;
+            }
+        }
+        m_GeometryArenas.clear();
+    }
+
     Texture* RenderEngine::createTexture(const math::uvector2& size, const TextureFormat format, const uint8* data)
     {
+        return createTexture(size, format, jarray<const uint8*>(1, data));
+    }
+    Texture* RenderEngine::createTexture(const math::uvector2& size, const TextureFormat format, const jarray<const uint8*>& mipLevelsData)
+    {
+        if (!isTextureFormatSupported(format))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Texture format {} is not supported"), static_cast<int32>(format));
+            return nullptr;
+        }
+
         Texture* texture = createTextureInternal();
-        if (!texture->init(size, format, data))
+        if (!texture->init(size, format, mipLevelsData))
         {
             delete texture;
             return nullptr;
         }
         return texture;
     }
+    TextureArray* RenderEngine::createTextureArray(const math::uvector2& size, const TextureFormat format, const jarray<const uint8*>& layersData)
+    {
+        if (!isTextureFormatSupported(format))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Texture format {} is not supported"), static_cast<int32>(format));
+            return nullptr;
+        }
+
+        TextureArray* textureArray = createTextureArrayInternal();
+        if (textureArray == nullptr)
+        {
+            JUMA_RENDER_LOG(error, JSTR("Texture arrays are not supported by render API"));
+            return nullptr;
+        }
+        if (!textureArray->init(size, format, layersData))
+        {
+            delete textureArray;
+            return nullptr;
+        }
+        return textureArray;
+    }
 
     Shader* RenderEngine::createShader(const jmap<ShaderStageFlags, jstring>& fileNames, jset<jstringID> vertexComponents, 
         jmap<jstringID, ShaderUniform> uniforms)
@@ -213,12 +392,56 @@ namespace JumaRenderEngine
     }
     RenderTarget* RenderEngine::createRenderTarget(const TextureFormat format, const math::uvector2& size, const TextureSamples samples)
     {
+        return createRenderTarget(jarray<TextureFormat>{ format }, size, samples);
+    }
+    RenderTarget* RenderEngine::createRenderTarget(const jarray<TextureFormat>& colorFormats, const math::uvector2& size, const TextureSamples samples)
+    {
+        if (colorFormats.getSize() > getMaxColorAttachmentCount())
+        {
+            JUMA_RENDER_LOG(error, JSTR("Render target can't have more than {} color attachments"), getMaxColorAttachmentCount());
+            return nullptr;
+        }
+        for (const auto& format : colorFormats)
+        {
+            if (!isRenderTargetFormatSupported(format))
+            {
+                JUMA_RENDER_LOG(error, JSTR("Render target format {} is not supported"), static_cast<int32>(format));
+                return nullptr;
+            }
+        }
+
         RenderTarget* renderTarget = createRenderTargetInternal();
-        if (!renderTarget->init(format, size, samples))
+        if (!renderTarget->init(colorFormats, size, samples))
         {
             delete renderTarget;
             return nullptr;
         }
         return renderTarget;
     }
+
+    bool RenderEngine::beginUploadBatch()
+    {
+        if (m_UploadBatchActive)
+        {
+            JUMA_RENDER_LOG(warning, JSTR("Upload batch already started"));
+            return false;
+        }
+        if (!beginUploadBatchInternal())
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to start upload batch"));
+            return false;
+        }
+        m_UploadBatchActive = true;
+        return true;
+    }
+    uint64 RenderEngine::endUploadBatch()
+    {
+        if (!m_UploadBatchActive)
+        {
+            JUMA_RENDER_LOG(warning, JSTR("Upload batch not started"));
+            return 0;
+        }
+        m_UploadBatchActive = false;
+        return endUploadBatchInternal();
+    }
 }
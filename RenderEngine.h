@@ -16,8 +16,14 @@
 
 namespace JumaRenderEngine
 {
+    class DynamicResolutionController;
+    class GeometryArena;
+    struct GeometryArenaAllocation;
     class RenderPipeline;
+    class ResidencyManager;
     class Texture;
+    class TextureArray;
+    class TextureStreamer;
     class RenderTarget;
     class Material;
     class Shader;
@@ -55,19 +61,49 @@ namespace JumaRenderEngine
         template<typename T, TEMPLATE_ENABLE(is_base<RenderPipeline, T>)>
         T* getRenderPipeline() const { return dynamic_cast<T*>(getRenderPipeline()); }
 
+        TextureStreamer* getTextureStreamer() const { return m_TextureStreamer; }
+        ResidencyManager* getResidencyManager() const { return m_ResidencyManager; }
+        DynamicResolutionController* getDynamicResolutionController() const { return m_DynamicResolutionController; }
+        // Device local memory allocated by render engine and budget for it, false if render API doesn't report it
+        virtual bool getGPUMemoryInfo(uint64& outUsage, uint64& outBudget) const { return false; }
+
         VertexBuffer* createVertexBuffer(VertexBufferData* verticesData);
+        VertexBuffer* createDynamicVertexBuffer(VertexBufferData* verticesData);
         const VertexDescription* findVertexType(const jstringID& vertexName) const { return m_RegisteredVertexTypes.find(vertexName); }
 
+        const GeometryArenaAllocation* allocateGeometry(const VertexBufferData* verticesData);
+        void compactGeometryArenas(float minFragmentation = 0.25f);
+
         virtual math::vector2 getScreenCoordinateModifier() const { return { 1.0f, 1.0f }; }
         virtual bool shouldFlipLoadedTextures() const { return false; }
 
+        bool isTextureFormatSupported(TextureFormat format) const { return isTextureFormatSupportedInternal(format); }
         Texture* createTexture(const math::uvector2& size, TextureFormat format, const uint8* data);
+        // Prebuilt mip chain, from the biggest level. Levels are not generated for compressed formats
+        // or when more than one level is provided
+        Texture* createTexture(const math::uvector2& size, TextureFormat format, const jarray<const uint8*>& mipLevelsData);
+        // Data of the first mip level for every layer
+        TextureArray* createTextureArray(const math::uvector2& size, TextureFormat format, const jarray<const uint8*>& layersData);
 
         Shader* createShader(const jmap<ShaderStageFlags, jstring>& fileNames, jset<jstringID> vertexComponents, 
             jmap<jstringID, ShaderUniform> uniforms = {});
         Material* createMaterial(Shader* shader);
 
+        bool isRenderTargetFormatSupported(TextureFormat format) const { return isRenderTargetFormatSupportedInternal(format); }
         RenderTarget* createRenderTarget(TextureFormat format, const math::uvector2& size, TextureSamples samples);
+        // Render target with multiple color attachments can't be multisampled
+        RenderTarget* createRenderTarget(const jarray<TextureFormat>& colorFormats, const math::uvector2& size, TextureSamples samples);
+        // Not more than RenderTarget::MaxColorAttachmentCount
+        virtual uint8 getMaxColorAttachmentCount() const { return 1; }
+
+        // Data of resources created between begin and end is uploaded in one submission,
+        // such resources must not be rendered before the batch is finished
+        bool beginUploadBatch();
+        // Returns ID of submitted batch, 0 if there is nothing to wait for
+        uint64 endUploadBatch();
+        bool isUploadBatchActive() const { return m_UploadBatchActive; }
+        virtual bool isUploadBatchFinished(uint64 batchID) { return true; }
+        virtual void waitForUploadBatch(uint64 batchID) {}
 
     protected:
 
@@ -80,10 +116,21 @@ namespace JumaRenderEngine
         virtual WindowController* createWindowController() = 0;
         virtual VertexBuffer* createVertexBufferInternal() = 0;
         virtual Texture* createTextureInternal() = 0;
+        virtual TextureArray* createTextureArrayInternal() { return nullptr; }
         virtual Shader* createShaderInternal() = 0;
         virtual Material* createMaterialInternal() = 0;
         virtual RenderTarget* createRenderTargetInternal() = 0;
         virtual RenderPipeline* createRenderPipelineInternal();
+        virtual GeometryArena* createGeometryArenaInternal() { return nullptr; }
+
+        virtual bool isTextureFormatSupportedInternal(const TextureFormat format) const { return !IsTextureFormatCompressed(format); }
+        virtual bool isRenderTargetFormatSupportedInternal(const TextureFormat format) const
+        {
+            return !IsTextureFormatCompressed(format) && !IsTextureFormatDepth(format);
+        }
+
+        virtual bool beginUploadBatchInternal() { return true; }
+        virtual uint64 endUploadBatchInternal() { return 0; }
 
         virtual void onRegisteredVertexType(const jstringID& vertexName) {}
 
@@ -93,7 +140,13 @@ namespace JumaRenderEngine
 
         WindowController* m_WindowController = nullptr;
         RenderPipeline* m_RenderPipeline = nullptr;
+        TextureStreamer* m_TextureStreamer = nullptr;
+        ResidencyManager* m_ResidencyManager = nullptr;
+        DynamicResolutionController* m_DynamicResolutionController = nullptr;
         jmap<jstringID, VertexDescription> m_RegisteredVertexTypes;
+        jmap<jstringID, jarray<GeometryArena*>> m_GeometryArenas;
+
+        bool m_UploadBatchActive = false;
 
 
         bool createRenderAssets();
@@ -102,6 +155,8 @@ namespace JumaRenderEngine
         
         const VertexDescription* registerVertexType(const VertexBufferData* verticesData);
 
+        void clearGeometryArenas();
+
         RenderTarget* createWindowRenderTarget(window_id windowID, TextureSamples samples);
     };
 }
@@ -8,10 +8,12 @@ namespace JumaRenderEngine
 {
     class RenderPipeline;
     class RenderTarget;
+    struct RenderTargetOperations;
 
     struct RenderOptions
     {
         RenderPipeline* renderPipeline = nullptr;
         RenderTarget* renderTarget = nullptr;
+        const RenderTargetOperations* renderTargetOperations = nullptr;
     };
 }
@@ -2,9 +2,13 @@
 
 #include "RenderPipeline.h"
 
+#include "DynamicResolutionController.h"
+#include "GeometryArena.h"
 #include "RenderEngine.h"
 #include "RenderOptions.h"
 #include "RenderTarget.h"
+#include "ResidencyManager.h"
+#include "TextureStreamer.h"
 #include "VertexBuffer.h"
 #include "window/WindowController.h"
 
@@ -99,7 +103,7 @@ namespace JumaRenderEngine
         return true;
     }
 
-    bool RenderPipeline::addPipelineStage(const jstringID& stageName, RenderTarget* renderTarget)
+    bool RenderPipeline::addPipelineStage(const jstringID& stageName, RenderTarget* renderTarget, const RenderTargetOperations& renderTargetOperations)
     {
         if ((stageName == jstringID_NONE) || (renderTarget == nullptr))
         {
@@ -111,12 +115,29 @@ namespace JumaRenderEngine
             JUMA_RENDER_LOG(error, JSTR("Stage already exists"));
             return false;
         }
+        if (!IsRenderTargetOperationsValid(renderTarget, renderTargetOperations))
+        {
+            return false;
+        }
 
         RenderPipelineStage& newStage = m_PipelineStages.add(stageName);
         newStage.renderTarget = renderTarget;
+        newStage.renderTargetOperations = renderTargetOperations;
         m_PipelineStagesQueueValid = false;
         return true;
     }
+    bool RenderPipeline::IsRenderTargetOperationsValid(const RenderTarget* renderTarget, const RenderTargetOperations& renderTargetOperations)
+    {
+        if (renderTargetOperations.colorLoadOperation == RenderTargetLoadOperation::Load)
+        {
+            if (renderTarget->isWindowRenderTarget() || (renderTarget->getSampleCount() != TextureSamples::X1))
+            {
+                JUMA_RENDER_LOG(error, JSTR("Color could be loaded only by offscreen render target without multisampling"));
+                return false;
+            }
+        }
+        return true;
+    }
     void RenderPipeline::removePipelineStage(const jstringID& stageName)
     {
         const RenderPipelineStage* stage = m_PipelineStages.find(stageName);
@@ -175,6 +196,33 @@ namespace JumaRenderEngine
         }
     }
 
+    bool RenderPipeline::setPipelineStageBatching(const jstringID& stageName, const bool enabled)
+    {
+        RenderPipelineStage* stage = m_PipelineStages.find(stageName);
+        if (stage == nullptr)
+        {
+            JUMA_RENDER_LOG(error, JSTR("There is no stage {}"), stageName.toString());
+            return false;
+        }
+        stage->batchRenderPrimitives = enabled;
+        return true;
+    }
+    bool RenderPipeline::setPipelineStageOperations(const jstringID& stageName, const RenderTargetOperations& renderTargetOperations)
+    {
+        RenderPipelineStage* stage = m_PipelineStages.find(stageName);
+        if (stage == nullptr)
+        {
+            JUMA_RENDER_LOG(error, JSTR("There is no stage {}"), stageName.toString());
+            return false;
+        }
+        if (!IsRenderTargetOperationsValid(stage->renderTarget, renderTargetOperations))
+        {
+            return false;
+        }
+        stage->renderTargetOperations = renderTargetOperations;
+        return true;
+    }
+
     bool RenderPipeline::addRenderPrimitive(const jstringID& stageName, const RenderPrimitive& primitive)
     {
         RenderPipelineStage* stage = m_PipelineStages.find(stageName);
@@ -199,6 +247,24 @@ namespace JumaRenderEngine
         {
             return false;
         }
+
+        // GPU time of the previous frames is known here, so new render scale is used by this frame
+        DynamicResolutionController* dynamicResolutionController = getRenderEngine()->getDynamicResolutionController();
+        if (dynamicResolutionController != nullptr)
+        {
+            dynamicResolutionController->update();
+        }
+        // Evicted and restored textures are uploaded by texture streamer in the same frame
+        ResidencyManager* residencyManager = getRenderEngine()->getResidencyManager();
+        if (residencyManager != nullptr)
+        {
+            residencyManager->update();
+        }
+        TextureStreamer* textureStreamer = getRenderEngine()->getTextureStreamer();
+        if (textureStreamer != nullptr)
+        {
+            textureStreamer->update();
+        }
         renderInternal();
         return true;
     }
@@ -215,14 +281,22 @@ namespace JumaRenderEngine
             {
                 const RenderPipelineStage* pipelineStage = getPipelineStage(renderQueueEntry.stage);
                 renderOptions->renderTarget = pipelineStage->renderTarget;
+                renderOptions->renderTargetOperations = &pipelineStage->renderTargetOperations;
                 if (!pipelineStage->renderTarget->onStartRender(renderOptions))
                 {
                     break;
                 }
 
-                for (const auto& renderPrimitive : pipelineStage->renderPrimitives)
+                if (pipelineStage->batchRenderPrimitives)
+                {
+                    renderPrimitivesBatched(renderOptions, pipelineStage->renderPrimitives);
+                }
+                else
                 {
-                    renderPrimitive.vertexBuffer->render(renderOptions, renderPrimitive.material);
+                    for (const auto& renderPrimitive : pipelineStage->renderPrimitives)
+                    {
+                        renderPrimitive.vertexBuffer->render(renderOptions, renderPrimitive.material);
+                    }
                 }
                 pipelineStage->renderTarget->onFinishRender(renderOptions);
             }
@@ -231,6 +305,65 @@ namespace JumaRenderEngine
         }
     }
 
+    void RenderPipeline::renderPrimitivesBatched(const RenderOptions* renderOptions, const jarray<RenderPrimitive>& primitives)
+    {
+        jarray<RenderPrimitiveBatch> batches;
+        int32 lastBatchIndex = -1;
+        for (const auto& renderPrimitive : primitives)
+        {
+            // Only indexed geometry from arenas could be drawn indirectly
+            const GeometryArenaAllocation* allocation = renderPrimitive.vertexBuffer->getGeometryAllocation();
+            if ((allocation == nullptr) || (allocation->indexCount == 0))
+            {
+                renderPrimitive.vertexBuffer->render(renderOptions, renderPrimitive.material);
+                continue;
+            }
+
+            // Sorted primitives usually go to the same batch as previous one
+            const bool sameAsLastBatch = batches.isValidIndex(lastBatchIndex) && 
+                (batches[lastBatchIndex].material == renderPrimitive.material) && (batches[lastBatchIndex].geometryArena == allocation->arena);
+            if (!sameAsLastBatch)
+            {
+                lastBatchIndex = -1;
+                for (int32 batchIndex = 0; batchIndex < batches.getSize(); batchIndex++)
+                {
+                    if ((batches[batchIndex].material == renderPrimitive.material) && (batches[batchIndex].geometryArena == allocation->arena))
+                    {
+                        lastBatchIndex = batchIndex;
+                        break;
+                    }
+                }
+                if (lastBatchIndex == -1)
+                {
+                    lastBatchIndex = batches.getSize();
+                    RenderPrimitiveBatch& batch = batches.addDefault();
+                    batch.material = renderPrimitive.material;
+                    batch.geometryArena = allocation->arena;
+                }
+            }
+            batches[lastBatchIndex].vertexBuffers.add(renderPrimitive.vertexBuffer);
+        }
+
+        for (const auto& batch : batches)
+        {
+            if (batch.vertexBuffers.getSize() == 1)
+            {
+                batch.vertexBuffers[0]->render(renderOptions, batch.material);
+            }
+            else
+            {
+                renderPrimitiveBatch(renderOptions, batch);
+            }
+        }
+    }
+    void RenderPipeline::renderPrimitiveBatch(const RenderOptions* renderOptions, const RenderPrimitiveBatch& batch)
+    {
+        for (const auto& vertexBuffer : batch.vertexBuffers)
+        {
+            vertexBuffer->render(renderOptions, batch.material);
+        }
+    }
+
     bool RenderPipeline::onStartRender(RenderOptions* renderOptions)
     {
         return getRenderEngine()->getWindowController()->onStartRender();
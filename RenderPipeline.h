@@ -5,6 +5,7 @@
 #include "renderEngine/juma_render_engine_core.h"
 #include "RenderEngineContextObject.h"
 
+#include "RenderTargetOperations.h"
 #include "jutils/jmap.h"
 #include "jutils/jset.h"
 #include "jutils/jstringID.h"
@@ -12,6 +13,7 @@
 
 namespace JumaRenderEngine
 {
+    class GeometryArena;
     class Material;
     class VertexBuffer;
     struct RenderOptions;
@@ -25,10 +27,20 @@ namespace JumaRenderEngine
     struct RenderPipelineStage
     {
         RenderTarget* renderTarget = nullptr;
+        RenderTargetOperations renderTargetOperations;
         jset<jstringID> dependencies;
 
+        // Draw primitives with the same material and geometry arena by one indirect call, draw order is not preserved
+        bool batchRenderPrimitives = false;
         jarray<RenderPrimitive> renderPrimitives;
     };
+    struct RenderPrimitiveBatch
+    {
+        Material* material = nullptr;
+        GeometryArena* geometryArena = nullptr;
+
+        jarray<VertexBuffer*> vertexBuffers;
+    };
     struct RenderPipelineStageQueueEntry
     {
         jstringID stage = jstringID_NONE;
@@ -50,10 +62,13 @@ namespace JumaRenderEngine
         const jmap<jstringID, RenderPipelineStage>& getPipelineStages() const { return m_PipelineStages; }
         const RenderPipelineStage* getPipelineStage(const jstringID& stageName) const { return m_PipelineStages.find(stageName); }
 
-        bool addPipelineStage(const jstringID& stageName, RenderTarget* renderTarget);
+        bool addPipelineStage(const jstringID& stageName, RenderTarget* renderTarget, 
+            const RenderTargetOperations& renderTargetOperations = RenderTargetOperations());
         void removePipelineStage(const jstringID& stageName);
         bool addPipelineStageDependency(const jstringID& stageName, const jstringID& dependencyStageName);
         void removePipelineStageDependency(const jstringID& stageName, const jstringID& dependencyStageName);
+        bool setPipelineStageBatching(const jstringID& stageName, bool enabled);
+        bool setPipelineStageOperations(const jstringID& stageName, const RenderTargetOperations& renderTargetOperations);
 
         bool addRenderPrimitive(const jstringID& stageName, const RenderPrimitive& primitive);
         void clearRenderPrimitives();
@@ -61,6 +76,9 @@ namespace JumaRenderEngine
         bool render();
         virtual void waitForRenderFinished() {}
 
+        // GPU time of the last finished frame, false if render API doesn't support it or there is no finished frame yet
+        virtual bool getGPUFrameTime(float& outMilliseconds) const { return false; }
+
     protected:
 
         virtual bool initInternal();
@@ -76,6 +94,8 @@ namespace JumaRenderEngine
         virtual bool onStartRender(RenderOptions* renderOptions);
         virtual void onFinishRender(RenderOptions* renderOptions);
 
+        virtual void renderPrimitiveBatch(const RenderOptions* renderOptions, const RenderPrimitiveBatch& batch);
+
     private:
 
         jmap<jstringID, RenderPipelineStage> m_PipelineStages;
@@ -87,7 +107,10 @@ namespace JumaRenderEngine
         bool init();
 
         void clearData();
+
+        static bool IsRenderTargetOperationsValid(const RenderTarget* renderTarget, const RenderTargetOperations& renderTargetOperations);
         
         void callRender(RenderOptions* renderOptions);
+        void renderPrimitivesBatched(const RenderOptions* renderOptions, const jarray<RenderPrimitive>& primitives);
     };
 }
@@ -2,7 +2,11 @@
 
 #include "RenderTarget.h"
 
+#include "DynamicResolutionController.h"
 #include "RenderEngine.h"
+#include "RenderOptions.h"
+#include "RenderTargetAttachment.h"
+#include "RenderTargetOperations.h"
 
 namespace JumaRenderEngine
 {
@@ -36,14 +40,45 @@ namespace JumaRenderEngine
         windowController->OnWindowPropertiesChanged.bind(this, &RenderTarget::onWindowPropertiesChanged);
         return true;
     }
-    bool RenderTarget::init(const TextureFormat format, const math::uvector2& size, const TextureSamples samples)
+    bool RenderTarget::init(const jarray<TextureFormat>& colorFormats, const math::uvector2& size, const TextureSamples samples)
     {
-        if ((size.x == 0) || (size.y == 0))
+        if ((size.x == 0) || (size.y == 0) || colorFormats.isEmpty() || (colorFormats.getSize() > MaxColorAttachmentCount))
         {
             JUMA_RENDER_LOG(error, JSTR("Invalid input params"));
             return false;
         }
+        const TextureFormat format = colorFormats[0];
+        if (IsTextureFormatDepth(format) && (samples != TextureSamples::X1))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Depth-only render target can't be multisampled"));
+            return false;
+        }
+        if (colorFormats.getSize() > 1)
+        {
+            if (samples != TextureSamples::X1)
+            {
+                JUMA_RENDER_LOG(error, JSTR("Render target with multiple color attachments can't be multisampled"));
+                return false;
+            }
+            for (const auto& colorFormat : colorFormats)
+            {
+                if (IsTextureFormatDepth(colorFormat))
+                {
+                    JUMA_RENDER_LOG(error, JSTR("Depth format can't be used by render target with multiple color attachments"));
+                    return false;
+                }
+            }
+        }
 
+        for (int32 index = 1; index < colorFormats.getSize(); index++)
+        {
+            RenderTargetAttachment* attachment = getRenderEngine()->createObject<RenderTargetAttachment>();
+            attachment->m_RenderTarget = this;
+            attachment->m_AttachmentIndex = static_cast<uint8>(index);
+            attachment->m_Format = colorFormats[index];
+            attachment->setSamplerType(getSamplerType());
+            m_AdditionalColorAttachments.add(attachment);
+        }
         m_Format = format;
         m_Size = size;
         m_TextureSamples = samples;
@@ -60,15 +95,75 @@ namespace JumaRenderEngine
 
     void RenderTarget::clearData()
     {
+        DynamicResolutionController* dynamicResolutionController = getRenderEngine()->getDynamicResolutionController();
+        if (dynamicResolutionController != nullptr)
+        {
+            dynamicResolutionController->removeRenderTarget(this);
+        }
         if (isWindowRenderTarget())
         {
             getRenderEngine()->getWindowController()->OnWindowPropertiesChanged.unbind(this, &RenderTarget::onWindowPropertiesChanged);
         }
 
+        for (const auto& attachment : m_AdditionalColorAttachments)
+        {
+            delete attachment;
+        }
+        m_AdditionalColorAttachments.clear();
+
         m_WindowID = window_id_INVALID;
         m_TextureSamples = TextureSamples::X1;
         m_Size = { 0, 0 };
         m_Format = TextureFormat::RGBA8;
+        m_RenderScale = 1.0f;
+    }
+
+    TextureFormat RenderTarget::getColorAttachmentFormat(const uint8 attachmentIndex) const
+    {
+        if (attachmentIndex == 0)
+        {
+            return m_Format;
+        }
+        return m_AdditionalColorAttachments.isValidIndex(attachmentIndex - 1) ? m_AdditionalColorAttachments[attachmentIndex - 1]->getFormat() : m_Format;
+    }
+    TextureBase* RenderTarget::getColorAttachment(const uint8 attachmentIndex)
+    {
+        if (attachmentIndex == 0)
+        {
+            return !isDepthOnly() ? this : nullptr;
+        }
+        return m_AdditionalColorAttachments.isValidIndex(attachmentIndex - 1) ? m_AdditionalColorAttachments[attachmentIndex - 1] : nullptr;
+    }
+
+    bool RenderTarget::setRenderScale(const float scale)
+    {
+        if (isWindowRenderTarget())
+        {
+            JUMA_RENDER_LOG(error, JSTR("Render scale is not supported by window render target"));
+            return false;
+        }
+        m_RenderScale = math::min(math::max(scale, MinRenderScale), 1.0f);
+        return true;
+    }
+    math::uvector2 RenderTarget::getRenderSize() const
+    {
+        if (m_RenderScale >= 1.0f)
+        {
+            return m_Size;
+        }
+        return {
+            math::max(static_cast<uint32>(static_cast<float>(m_Size.x) * m_RenderScale), 1u),
+            math::max(static_cast<uint32>(static_cast<float>(m_Size.y) * m_RenderScale), 1u)
+        };
+    }
+    math::vector2 RenderTarget::getUVScale() const
+    {
+        if ((m_Size.x == 0) || (m_Size.y == 0))
+        {
+            return { 1.0f, 1.0f };
+        }
+        const math::uvector2 renderSize = getRenderSize();
+        return { static_cast<float>(renderSize.x) / static_cast<float>(m_Size.x), static_cast<float>(renderSize.y) / static_cast<float>(m_Size.y) };
     }
 
     bool RenderTarget::update()
@@ -81,6 +176,7 @@ namespace JumaRenderEngine
                 return false;
             }
             m_Invalid = false;
+            m_MipsOutdated = false;
         }
         return true;
     }
@@ -98,6 +194,55 @@ namespace JumaRenderEngine
         }
     }
 
+    RenderTargetMemoryInfo RenderTarget::getMemoryInfo() const
+    {
+        const uint64 samplesNumber = GetTextureSamplesNumber(m_TextureSamples);
+        const uint64 colorSize = GetTextureDataSize(m_Format, m_Size.x, m_Size.y);
+        const uint64 depthSize = GetTextureDataSize(TextureFormat::DEPTH24_STENCIL8, m_Size.x, m_Size.y);
+
+        RenderTargetMemoryInfo memoryInfo;
+        if (isDepthOnly())
+        {
+            memoryInfo.residentMemorySize = colorSize;
+            memoryInfo.storedBytesPerRender = colorSize;
+            return memoryInfo;
+        }
+        memoryInfo.transientMemorySize = depthSize * samplesNumber;
+        if (samplesNumber > 1)
+        {
+            memoryInfo.transientMemorySize += colorSize * samplesNumber;
+        }
+        if (!isWindowRenderTarget())
+        {
+            memoryInfo.residentMemorySize = colorSize;
+            if (IsTextureFilterTypeUsingMips(getSamplerType().filterType))
+            {
+                math::uvector2 levelSize = { math::max(m_Size.x / 2, 1u), math::max(m_Size.y / 2, 1u) };
+                const int32 mipLevelCount = GetMipLevelCountByTextureSize(m_Size);
+                for (int32 mipLevel = 1; mipLevel < mipLevelCount; mipLevel++)
+                {
+                    memoryInfo.residentMemorySize += GetTextureDataSize(m_Format, levelSize.x, levelSize.y);
+                    levelSize = { math::max(levelSize.x / 2, 1u), math::max(levelSize.y / 2, 1u) };
+                }
+            }
+        }
+        memoryInfo.storedBytesPerRender = colorSize;
+        // Additional color attachments don't have mips
+        for (const auto& attachment : m_AdditionalColorAttachments)
+        {
+            const uint64 attachmentSize = GetTextureDataSize(attachment->getFormat(), m_Size.x, m_Size.y);
+            memoryInfo.residentMemorySize += attachmentSize;
+            memoryInfo.storedBytesPerRender += attachmentSize;
+        }
+        return memoryInfo;
+    }
+
+    const RenderTargetOperations& RenderTarget::GetRenderTargetOperations(const RenderOptions* renderOptions)
+    {
+        static const RenderTargetOperations defaultOperations;
+        return (renderOptions != nullptr) && (renderOptions->renderTargetOperations != nullptr) ? *renderOptions->renderTargetOperations : defaultOperations;
+    }
+
     bool RenderTarget::onStartRender(RenderOptions* renderOptions)
     {
         if (!update())
@@ -116,5 +261,9 @@ namespace JumaRenderEngine
         {
             getRenderEngine()->getWindowController()->onFinishWindowRender(getWindowID());
         }
+        else
+        {
+            m_MipsOutdated = true;
+        }
     }
 }
@@ -5,6 +5,7 @@
 #include "renderEngine/juma_render_engine_core.h"
 #include "TextureBase.h"
 
+#include "jutils/jarray.h"
 #include "jutils/math/vector2.h"
 #include "texture/TextureFormat.h"
 #include "texture/TextureSamples.h"
@@ -12,9 +13,23 @@
 
 namespace JumaRenderEngine
 {
+    class RenderTargetAttachment;
     class WindowController;
     struct WindowData;
     struct RenderOptions;
+    struct RenderTargetOperations;
+
+    struct RenderTargetMemoryInfo
+    {
+        // Sampled result image with its mips, swapchain images of window render target are not counted
+        uint64 residentMemorySize = 0;
+        // Attachments that are not stored after render: multisampled color and depth
+        uint64 transientMemorySize = 0;
+        // Transient attachments don't take physical memory
+        bool transientMemoryLazilyAllocated = false;
+        // Bytes written to memory at the end of every render
+        uint64 storedBytesPerRender = 0;
+    };
 
     class RenderTarget : public TextureBase
     {
@@ -30,6 +45,24 @@ namespace JumaRenderEngine
 
         math::uvector2 getSize() const { return m_Size; }
         TextureFormat getFormat() const { return m_Format; }
+        // Render target with depth format has only depth attachment, it's sampled as the result
+        bool isDepthOnly() const { return !isWindowRenderTarget() && IsTextureFormatDepth(m_Format); }
+
+        static constexpr uint8 MaxColorAttachmentCount = 8;
+
+        uint8 getColorAttachmentCount() const { return isDepthOnly() ? 0 : static_cast<uint8>(m_AdditionalColorAttachments.getSize() + 1); }
+        TextureFormat getColorAttachmentFormat(uint8 attachmentIndex) const;
+        // First attachment is the render target itself, every attachment could be set to material as texture
+        TextureBase* getColorAttachment(uint8 attachmentIndex);
+
+        static constexpr float MinRenderScale = 0.25f;
+
+        // Only part of the offscreen render target is rendered if scale is less than 1, allocated size is not changed
+        float getRenderScale() const { return m_RenderScale; }
+        bool setRenderScale(float scale);
+        math::uvector2 getRenderSize() const;
+        // Texture coordinates of the rendered part when sampling this render target
+        math::vector2 getUVScale() const;
 
         virtual bool onStartRender(RenderOptions* renderOptions);
         virtual void onFinishRender(RenderOptions* renderOptions);
@@ -37,24 +70,37 @@ namespace JumaRenderEngine
         void invalidate() { m_Invalid = true; }
         bool update();
 
+        virtual RenderTargetMemoryInfo getMemoryInfo() const;
+
+        // True if content was rendered after the last mips update and sampler uses mips
+        bool shouldUpdateMips() const { return m_MipsOutdated && !isDepthOnly() && IsTextureFilterTypeUsingMips(getSamplerType().filterType); }
+
     protected:
 
         virtual bool initInternal() { return true; }
 
         virtual bool recreateRenderTarget() { return false; }
 
+        // Default operations if render options don't have them
+        static const RenderTargetOperations& GetRenderTargetOperations(const RenderOptions* renderOptions);
+
+        void onMipsUpdated() { m_MipsOutdated = false; }
+
     private:
 
         window_id m_WindowID = window_id_INVALID;
         TextureSamples m_TextureSamples = TextureSamples::X1;
         math::uvector2 m_Size = { 0, 0 };
         TextureFormat m_Format = TextureFormat::RGBA8;
+        jarray<RenderTargetAttachment*> m_AdditionalColorAttachments;
+        float m_RenderScale = 1.0f;
 
         bool m_Invalid = true;
+        bool m_MipsOutdated = false;
 
 
         bool init(window_id windowID, TextureSamples samples);
-        bool init(TextureFormat format, const math::uvector2& size, TextureSamples samples);
+        bool init(const jarray<TextureFormat>& colorFormats, const math::uvector2& size, TextureSamples samples);
 
         void clearData();
 
@@ -0,0 +1,34 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#pragma once
+
+#include "renderEngine/juma_render_engine_core.h"
+#include "TextureBase.h"
+
+#include "texture/TextureFormat.h"
+
+namespace JumaRenderEngine
+{
+    class RenderTarget;
+
+    // Additional color attachment of the render target, could be set to material as texture.
+    // First color attachment is the render target itself
+    class RenderTargetAttachment final : public TextureBase
+    {
+        friend RenderTarget;
+
+    public:
+        RenderTargetAttachment() = default;
+        virtual ~RenderTargetAttachment() override = default;
+
+        RenderTarget* getRenderTarget() const { return m_RenderTarget; }
+        uint8 getAttachmentIndex() const { return m_AttachmentIndex; }
+        TextureFormat getFormat() const { return m_Format; }
+
+    private:
+
+        RenderTarget* m_RenderTarget = nullptr;
+        uint8 m_AttachmentIndex = 0;
+        TextureFormat m_Format = TextureFormat::RGBA8;
+    };
+}
@@ -0,0 +1,28 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#pragma once
+
+#include "renderEngine/juma_render_engine_core.h"
+
+#include "jutils/math/vector4.h"
+
+namespace JumaRenderEngine
+{
+    enum class RenderTargetLoadOperation : uint8 { Clear, Load, DontCare };
+    enum class RenderTargetStoreOperation : uint8 { Store, DontCare };
+
+    // What render target does with its attachments at the start and at the end of pipeline stage.
+    // Loaded attachment must be stored by the previous stage, multisampled color is never stored
+    struct RenderTargetOperations
+    {
+        RenderTargetLoadOperation colorLoadOperation = RenderTargetLoadOperation::Clear;
+        RenderTargetStoreOperation colorStoreOperation = RenderTargetStoreOperation::Store;
+        math::vector4 clearColor = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+        // Depth of depth-only render target is always stored, color operations are ignored for it
+        RenderTargetLoadOperation depthLoadOperation = RenderTargetLoadOperation::Clear;
+        RenderTargetStoreOperation depthStoreOperation = RenderTargetStoreOperation::DontCare;
+        float clearDepth = 1.0f;
+        uint8 clearStencil = 0;
+    };
+}
@@ -0,0 +1,293 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#include "ResidencyManager.h"
+
+#include <algorithm>
+
+#include "Material.h"
+#include "RenderEngine.h"
+#include "RenderPipeline.h"
+#include "RenderTarget.h"
+#include "Shader.h"
+#include "Texture.h"
+#include "TextureArray.h"
+#include "TextureStreamer.h"
+#include "jutils/jset.h"
+
+namespace JumaRenderEngine
+{
+    ResidencyManager::~ResidencyManager()
+    {
+        clearData();
+    }
+
+    bool ResidencyManager::init()
+    {
+        if (isValid())
+        {
+            JUMA_RENDER_LOG(error, JSTR("Residency manager already initialized"));
+            return false;
+        }
+
+        markAsInitialized();
+        return true;
+    }
+
+    void ResidencyManager::clearData()
+    {
+        m_TexturesLastUsedFrame.clear();
+        m_VertexBuffersLastUsedFrame.clear();
+        m_PendingEvictions.clear();
+        m_PendingRestorations.clear();
+        m_PendingEvictedMemorySize = 0;
+        m_PendingRestoredMemorySize = 0;
+        m_FrameIndex = 0;
+    }
+
+    bool ResidencyManager::getMemoryInfo(uint64& outUsage, uint64& outBudget) const
+    {
+        uint64 usage = 0;
+        uint64 budget = 0;
+        if (!getRenderEngine()->getGPUMemoryInfo(usage, budget))
+        {
+            // Without render API statistics only streamed textures are counted
+            const TextureStreamer* textureStreamer = getRenderEngine()->getTextureStreamer();
+            if (textureStreamer != nullptr)
+            {
+                for (const auto& textureID : textureStreamer->getTextureIDs())
+                {
+                    const Texture* texture = textureStreamer->getTexture(textureID);
+                    usage += texture != nullptr ? texture->getMemorySize() : 0;
+                }
+            }
+        }
+        if (m_Budget > 0)
+        {
+            budget = m_Budget;
+        }
+        if (budget == 0)
+        {
+            return false;
+        }
+
+        outUsage = usage;
+        outBudget = budget;
+        return true;
+    }
+
+    uint64 ResidencyManager::getLastUsedFrame(const TextureBase* texture) const
+    {
+        const uint64* frameIndex = m_TexturesLastUsedFrame.find(texture);
+        return frameIndex != nullptr ? *frameIndex : 0;
+    }
+    uint64 ResidencyManager::getLastUsedFrame(const VertexBuffer* vertexBuffer) const
+    {
+        const uint64* frameIndex = m_VertexBuffersLastUsedFrame.find(vertexBuffer);
+        return frameIndex != nullptr ? *frameIndex : 0;
+    }
+
+    void ResidencyManager::update()
+    {
+        if (!isValid())
+        {
+            return;
+        }
+
+        m_FrameIndex++;
+        collectUsage();
+        updateResidency();
+        if ((m_FrameIndex % UsageInfoLifetime) == 0)
+        {
+            removeOldUsageInfo();
+        }
+    }
+
+    void ResidencyManager::collectUsage()
+    {
+        const RenderPipeline* renderPipeline = getRenderEngine()->getRenderPipeline();
+        if (renderPipeline == nullptr)
+        {
+            return;
+        }
+
+        jset<const Material*> usedMaterials;
+        for (const auto& pipelineStage : renderPipeline->getPipelineStages())
+        {
+            if (pipelineStage.value.renderTarget != nullptr)
+            {
+                m_TexturesLastUsedFrame[pipelineStage.value.renderTarget] = m_FrameIndex;
+            }
+            for (const auto& renderPrimitive : pipelineStage.value.renderPrimitives)
+            {
+                m_VertexBuffersLastUsedFrame[renderPrimitive.vertexBuffer] = m_FrameIndex;
+                if ((renderPrimitive.material != nullptr) && !usedMaterials.contains(renderPrimitive.material))
+                {
+                    usedMaterials.add(renderPrimitive.material);
+                    markMaterialUsed(renderPrimitive.material);
+                }
+            }
+        }
+    }
+    void ResidencyManager::markMaterialUsed(const Material* material)
+    {
+        for (const auto& uniform : material->getShader()->getUniforms())
+        {
+            if (uniform.value.type == ShaderUniformType::Texture)
+            {
+                TextureBase* texture = nullptr;
+                if (material->getValue<ShaderUniformType::Texture>(uniform.key, texture) && (texture != nullptr))
+                {
+                    m_TexturesLastUsedFrame[texture] = m_FrameIndex;
+                }
+            }
+            else if (uniform.value.type == ShaderUniformType::TextureArray)
+            {
+                TextureArray* texture = nullptr;
+                if (material->getValue<ShaderUniformType::TextureArray>(uniform.key, texture) && (texture != nullptr))
+                {
+                    m_TexturesLastUsedFrame[texture] = m_FrameIndex;
+                }
+            }
+        }
+    }
+
+    void ResidencyManager::updatePendingResidencyChanges(const TextureStreamer* textureStreamer)
+    {
+        jarray<streamed_texture_id> finishedTextures;
+        for (const auto& eviction : m_PendingEvictions)
+        {
+            if (!textureStreamer->isResidencyChangePending(eviction.key))
+            {
+                finishedTextures.add(eviction.key);
+                m_PendingEvictedMemorySize -= math::min(m_PendingEvictedMemorySize, eviction.value);
+            }
+        }
+        for (const auto& textureID : finishedTextures)
+        {
+            m_PendingEvictions.remove(textureID);
+        }
+
+        finishedTextures.clear();
+        for (const auto& restoration : m_PendingRestorations)
+        {
+            if (!textureStreamer->isResidencyChangePending(restoration.key))
+            {
+                finishedTextures.add(restoration.key);
+                m_PendingRestoredMemorySize -= math::min(m_PendingRestoredMemorySize, restoration.value);
+            }
+        }
+        for (const auto& textureID : finishedTextures)
+        {
+            m_PendingRestorations.remove(textureID);
+        }
+    }
+    void ResidencyManager::updateResidency()
+    {
+        TextureStreamer* textureStreamer = getRenderEngine()->getTextureStreamer();
+        uint64 usage = 0;
+        uint64 budget = 0;
+        if ((textureStreamer == nullptr) || !getMemoryInfo(usage, budget))
+        {
+            return;
+        }
+        updatePendingResidencyChanges(textureStreamer);
+        usage = usage - math::min(usage, m_PendingEvictedMemorySize) + m_PendingRestoredMemorySize;
+
+        struct StreamedTextureInfo
+        {
+            streamed_texture_id textureID = streamed_texture_id_INVALID;
+            uint64 lastUsedFrame = 0;
+            uint64 residentMemorySize = 0;
+        };
+        jarray<StreamedTextureInfo> textures;
+        const bool overBudget = usage > budget;
+        for (const auto& textureID : textureStreamer->getTextureIDs())
+        {
+            if (m_PendingEvictions.contains(textureID) || m_PendingRestorations.contains(textureID))
+            {
+                continue;
+            }
+            const Texture* texture = textureStreamer->getTexture(textureID);
+            const uint64 lastUsedFrame = getLastUsedFrame(texture);
+            if (overBudget)
+            {
+                if ((textureStreamer->getState(textureID) == StreamedTextureState::Resident) && ((lastUsedFrame + MinUnusedFrameCount) < m_FrameIndex))
+                {
+                    textures.add({ textureID, lastUsedFrame, textureStreamer->getResidentMemorySize(textureID) });
+                }
+            }
+            else if (textureStreamer->isEvicted(textureID) && (lastUsedFrame == m_FrameIndex))
+            {
+                textures.add({ textureID, lastUsedFrame, textureStreamer->getResidentMemorySize(textureID) });
+            }
+        }
+        if (textures.isEmpty())
+        {
+            return;
+        }
+
+        if (overBudget)
+        {
+            // Least recently used first
+            std::sort(textures.getData(), textures.getData() + textures.getSize(), [](const StreamedTextureInfo& a, const StreamedTextureInfo& b)
+            {
+                return a.lastUsedFrame < b.lastUsedFrame;
+            });
+            for (const auto& texture : textures)
+            {
+                if (usage <= budget)
+                {
+                    break;
+                }
+                if (textureStreamer->evictTexture(texture.textureID))
+                {
+                    usage -= math::min(usage, texture.residentMemorySize);
+                    m_PendingEvictions.add(texture.textureID, texture.residentMemorySize);
+                    m_PendingEvictedMemorySize += texture.residentMemorySize;
+                }
+            }
+            return;
+        }
+
+        // Some space is kept free, so restored texture is not evicted right away
+        const uint64 restoreBudget = budget - budget / 10;
+        for (const auto& texture : textures)
+        {
+            if (((usage + texture.residentMemorySize) <= restoreBudget) && textureStreamer->restoreTexture(texture.textureID))
+            {
+                usage += texture.residentMemorySize;
+                m_PendingRestorations.add(texture.textureID, texture.residentMemorySize);
+                m_PendingRestoredMemorySize += texture.residentMemorySize;
+            }
+        }
+    }
+
+    void ResidencyManager::removeOldUsageInfo()
+    {
+        jarray<const TextureBase*> oldTextures;
+        for (const auto& texture : m_TexturesLastUsedFrame)
+        {
+            if ((texture.value + UsageInfoLifetime) < m_FrameIndex)
+            {
+                oldTextures.add(texture.key);
+            }
+        }
+        for (const auto& texture : oldTextures)
+        {
+            m_TexturesLastUsedFrame.remove(texture);
+        }
+
+        jarray<const VertexBuffer*> oldVertexBuffers;
+        for (const auto& vertexBuffer : m_VertexBuffersLastUsedFrame)
+        {
+            if ((vertexBuffer.value + UsageInfoLifetime) < m_FrameIndex)
+            {
+                oldVertexBuffers.add(vertexBuffer.key);
+            }
+        }
+        for (const auto& vertexBuffer : oldVertexBuffers)
+        {
+            m_VertexBuffersLastUsedFrame.remove(vertexBuffer);
+        }
+    }
+}
@@ -0,0 +1,74 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#pragma once
+
+#include "renderEngine/juma_render_engine_core.h"
+#include "RenderEngineContextObject.h"
+
+#include "TextureStreamer.h"
+#include "jutils/jmap.h"
+
+namespace JumaRenderEngine
+{
+    class Material;
+    class TextureBase;
+    class VertexBuffer;
+
+    // Tracks when textures and vertex buffers were last used by render pipeline. When GPU memory usage goes over the budget
+    // least recently used streamed textures are replaced with low resolution versions, they are loaded again when needed
+    class ResidencyManager : public RenderEngineContextObject
+    {
+        friend RenderEngine;
+
+    public:
+        ResidencyManager() = default;
+        virtual ~ResidencyManager() override;
+
+        // Textures used during this number of last frames are never evicted
+        static constexpr uint64 MinUnusedFrameCount = 3;
+        // Usage info of objects not used for this number of frames is removed
+        static constexpr uint64 UsageInfoLifetime = 1000;
+
+        // Zero means that the budget reported by render API is used
+        uint64 getBudget() const { return m_Budget; }
+        void setBudget(const uint64 budget) { m_Budget = budget; }
+        bool getMemoryInfo(uint64& outUsage, uint64& outBudget) const;
+
+        uint64 getFrameIndex() const { return m_FrameIndex; }
+        // Zero if object wasn't used recently
+        uint64 getLastUsedFrame(const TextureBase* texture) const;
+        uint64 getLastUsedFrame(const VertexBuffer* vertexBuffer) const;
+
+        void update();
+
+    protected:
+
+        virtual void clearInternal() override { clearData(); }
+
+    private:
+
+        uint64 m_Budget = 0;
+        uint64 m_FrameIndex = 0;
+
+        jmap<const TextureBase*, uint64> m_TexturesLastUsedFrame;
+        jmap<const VertexBuffer*, uint64> m_VertexBuffersLastUsedFrame;
+
+        // Evicted memory is freed and restored memory is allocated a few updates later,
+        // so these sizes are applied to reported usage until that happens
+        jmap<streamed_texture_id, uint64> m_PendingEvictions;
+        jmap<streamed_texture_id, uint64> m_PendingRestorations;
+        uint64 m_PendingEvictedMemorySize = 0;
+        uint64 m_PendingRestoredMemorySize = 0;
+
+
+        bool init();
+
+        void clearData();
+
+        void collectUsage();
+        void markMaterialUsed(const Material* material);
+        void updatePendingResidencyChanges(const TextureStreamer* textureStreamer);
+        void updateResidency();
+        void removeOldUsageInfo();
+    };
+}
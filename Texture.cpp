@@ -4,19 +4,76 @@
 
 namespace JumaRenderEngine
 {
-    bool Texture::init(const math::uvector2& size, const TextureFormat format, const uint8* data)
+    bool Texture::init(const math::uvector2& size, const TextureFormat format, const jarray<const uint8*>& mipLevelsData)
     {
-        if ((size.x == 0) || (size.y == 0) || (data == nullptr))
+        if ((size.x == 0) || (size.y == 0) || mipLevelsData.isEmpty() || (mipLevelsData.getSize() > GetMipLevelCountByTextureSize(size)))
         {
             JUMA_RENDER_LOG(error, JSTR("Invalid nput params"));
             return false;
         }
+        for (const auto& data : mipLevelsData)
+        {
+            if (data == nullptr)
+            {
+                JUMA_RENDER_LOG(error, JSTR("Invalid nput params"));
+                return false;
+            }
+        }
 
-        if (!initInternal(size, format, data))
+        if (!initInternal(size, format, mipLevelsData))
         {
             JUMA_RENDER_LOG(error, JSTR("Failed to initialize texture"));
             return false;
         }
+
+        m_Size = size;
+        m_Format = format;
+        m_MipLevelCount = static_cast<uint32>((mipLevelsData.getSize() == 1) && !IsTextureFormatCompressed(format) 
+            ? GetMipLevelCountByTextureSize(size) : mipLevelsData.getSize());
         return true;
     }
+
+    uint64 Texture::getMemorySize() const
+    {
+        uint64 memorySize = 0;
+        math::uvector2 levelSize = m_Size;
+        for (uint32 mipLevel = 0; mipLevel < m_MipLevelCount; mipLevel++)
+        {
+            memorySize += GetTextureDataSize(m_Format, levelSize.x, levelSize.y);
+            levelSize = { math::max(levelSize.x / 2, 1u), math::max(levelSize.y / 2, 1u) };
+        }
+        return memorySize;
+    }
+
+    bool Texture::updateRegion(const math::uvector2& offset, const math::uvector2& size, const uint32 mipLevel, const uint8* data)
+    {
+        if ((size.x == 0) || (size.y == 0) || (data == nullptr) || (mipLevel >= m_MipLevelCount))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Invalid input params"));
+            return false;
+        }
+        const math::uvector2 levelSize = { math::max(m_Size.x >> mipLevel, 1u), math::max(m_Size.y >> mipLevel, 1u) };
+        if (((offset.x + size.x) > levelSize.x) || ((offset.y + size.y) > levelSize.y))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Region is out of mip level {} bounds"), mipLevel);
+            return false;
+        }
+        if (IsTextureFormatCompressed(m_Format) || IsTextureFormatDepth(m_Format))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Region updates of compressed and depth textures are not supported"));
+            return false;
+        }
+
+        if (!updateRegionInternal(offset, size, mipLevel, data))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to update texture region"));
+            return false;
+        }
+        return true;
+    }
+    bool Texture::updateRegionInternal(const math::uvector2& offset, const math::uvector2& size, const uint32 mipLevel, const uint8* data)
+    {
+        JUMA_RENDER_LOG(error, JSTR("Texture region updates are not supported by render API"));
+        return false;
+    }
 }
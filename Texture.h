@@ -5,6 +5,7 @@
 #include "renderEngine/juma_render_engine_core.h"
 #include "TextureBase.h"
 
+#include "jutils/jarray.h"
 #include "texture/TextureFormat.h"
 
 namespace JumaRenderEngine
@@ -17,12 +18,30 @@ namespace JumaRenderEngine
         Texture() = default;
         virtual ~Texture() override = default;
 
+        const math::uvector2& getSize() const { return m_Size; }
+        TextureFormat getFormat() const { return m_Format; }
+        uint32 getMipLevelCount() const { return m_MipLevelCount; }
+        // Size of all mip levels, actual allocation could be bigger
+        uint64 getMemorySize() const;
+
+        // Data is tightly packed rows of the region. Update is visible from the next rendered frame,
+        // other mip levels are not regenerated
+        bool updateRegion(const math::uvector2& offset, const math::uvector2& size, uint32 mipLevel, const uint8* data);
+
     protected:
 
-        virtual bool initInternal(const math::uvector2& size, TextureFormat format, const uint8* data) = 0;
+        // Single mip level of uncompressed texture means that other levels should be generated
+        virtual bool initInternal(const math::uvector2& size, TextureFormat format, const jarray<const uint8*>& mipLevelsData) = 0;
+
+        virtual bool updateRegionInternal(const math::uvector2& offset, const math::uvector2& size, uint32 mipLevel, const uint8* data);
 
     private:
 
-        bool init(const math::uvector2& size, TextureFormat format, const uint8* data);
+        math::uvector2 m_Size = { 0, 0 };
+        TextureFormat m_Format = TextureFormat::RGBA8;
+        uint32 m_MipLevelCount = 0;
+
+
+        bool init(const math::uvector2& size, TextureFormat format, const jarray<const uint8*>& mipLevelsData);
     };
 }
@@ -0,0 +1,34 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#include "TextureArray.h"
+
+namespace JumaRenderEngine
+{
+    bool TextureArray::init(const math::uvector2& size, const TextureFormat format, const jarray<const uint8*>& layersData)
+    {
+        if ((size.x == 0) || (size.y == 0) || layersData.isEmpty() || IsTextureFormatCompressed(format) || IsTextureFormatDepth(format))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Invalid input params"));
+            return false;
+        }
+        for (const auto& data : layersData)
+        {
+            if (data == nullptr)
+            {
+                JUMA_RENDER_LOG(error, JSTR("Invalid input params"));
+                return false;
+            }
+        }
+
+        if (!initInternal(size, format, layersData))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to initialize texture array"));
+            return false;
+        }
+
+        m_Size = size;
+        m_LayerCount = static_cast<uint32>(layersData.getSize());
+        m_Format = format;
+        return true;
+    }
+}
@@ -0,0 +1,40 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#pragma once
+
+#include "renderEngine/juma_render_engine_core.h"
+#include "TextureBase.h"
+
+#include "jutils/jarray.h"
+#include "texture/TextureFormat.h"
+
+namespace JumaRenderEngine
+{
+    // Array of 2D textures with the same size and format, bound to the shader as one sampler2DArray
+    class TextureArray : public TextureBase
+    {
+        friend RenderEngine;
+
+    public:
+        TextureArray() = default;
+        virtual ~TextureArray() override = default;
+
+        math::uvector2 getSize() const { return m_Size; }
+        uint32 getLayerCount() const { return m_LayerCount; }
+        TextureFormat getFormat() const { return m_Format; }
+
+    protected:
+
+        // Mip levels of every layer are generated
+        virtual bool initInternal(const math::uvector2& size, TextureFormat format, const jarray<const uint8*>& layersData) = 0;
+
+    private:
+
+        math::uvector2 m_Size = { 0, 0 };
+        uint32 m_LayerCount = 0;
+        TextureFormat m_Format = TextureFormat::RGBA8;
+
+
+        bool init(const math::uvector2& size, TextureFormat format, const jarray<const uint8*>& layersData);
+    };
+}
@@ -0,0 +1,525 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#include "TextureStreamer.h"
+
+#include <algorithm>
+
+#include "Material.h"
+#include "RenderEngine.h"
+#include "Texture.h"
+
+namespace JumaRenderEngine
+{
+    TextureStreamer::~TextureStreamer()
+    {
+        clearData();
+    }
+
+    bool TextureStreamer::init()
+    {
+        if (isValid())
+        {
+            JUMA_RENDER_LOG(error, JSTR("Texture streamer already initialized"));
+            return false;
+        }
+
+        constexpr uint8 placeholderData[16] = {
+            128, 128, 128, 255,  96, 96, 96, 255,
+            96, 96, 96, 255,  128, 128, 128, 255
+        };
+        m_PlaceholderTexture = getRenderEngine()->createTexture({ 2, 2 }, TextureFormat::RGBA8, placeholderData);
+        if (m_PlaceholderTexture == nullptr)
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to create placeholder texture"));
+            return false;
+        }
+
+        m_StopLoadThread = false;
+        m_LoadThread = std::thread(&TextureStreamer::loadThreadFunction, this);
+        markAsInitialized();
+        return true;
+    }
+
+    void TextureStreamer::clearData()
+    {
+        if (m_LoadThread.joinable())
+        {
+            {
+                std::lock_guard lock(m_LoadMutex);
+                m_StopLoadThread = true;
+            }
+            m_LoadCondition.notify_all();
+            m_LoadThread.join();
+        }
+        m_LoadTasks.clear();
+        m_LoadResults.clear();
+
+        for (const auto& streamedTexture : m_Textures)
+        {
+            if (streamedTexture.value.uploadingTexture != nullptr)
+            {
+                getRenderEngine()->waitForUploadBatch(streamedTexture.value.uploadBatchID);
+                delete streamedTexture.value.uploadingTexture;
+            }
+            delete streamedTexture.value.texture;
+        }
+        m_Textures.clear();
+        for (const auto& texture : m_TexturesForDelete)
+        {
+            delete texture;
+        }
+        m_TexturesForDelete.clear();
+        for (const auto& texture : m_TexturesForDeleteNextUpdate)
+        {
+            delete texture;
+        }
+        m_TexturesForDeleteNextUpdate.clear();
+        m_UpdateIndex = 0;
+
+        if (m_PlaceholderTexture != nullptr)
+        {
+            delete m_PlaceholderTexture;
+            m_PlaceholderTexture = nullptr;
+        }
+    }
+
+    streamed_texture_id TextureStreamer::requestTexture(TextureLoadFunction loadFunction, const int32 priority)
+    {
+        if (!isValid() || (loadFunction == nullptr))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Invalid input params"));
+            return streamed_texture_id_INVALID;
+        }
+
+        const streamed_texture_id textureID = m_TextureIDs.getUID();
+        StreamedTexture& streamedTexture = m_Textures.add(textureID);
+        streamedTexture.priority = priority;
+        streamedTexture.loadFunction = std::move(loadFunction);
+        {
+            std::lock_guard lock(m_LoadMutex);
+            m_LoadTasks.add({ textureID, priority, streamedTexture.loadFunction });
+        }
+        m_LoadCondition.notify_one();
+        return textureID;
+    }
+    void TextureStreamer::setPriority(const streamed_texture_id textureID, const int32 priority)
+    {
+        StreamedTexture* streamedTexture = m_Textures.find(textureID);
+        if (streamedTexture == nullptr)
+        {
+            return;
+        }
+
+        streamedTexture->priority = priority;
+        std::lock_guard lock(m_LoadMutex);
+        for (auto& task : m_LoadTasks)
+        {
+            if (task.textureID == textureID)
+            {
+                task.priority = priority;
+                break;
+            }
+        }
+    }
+    void TextureStreamer::releaseTexture(const streamed_texture_id textureID)
+    {
+        StreamedTexture* streamedTexture = m_Textures.find(textureID);
+        if (streamedTexture == nullptr)
+        {
+            return;
+        }
+
+        {
+            std::lock_guard lock(m_LoadMutex);
+            for (int32 index = 0; index < m_LoadTasks.getSize(); index++)
+            {
+                if (m_LoadTasks[index].textureID == textureID)
+                {
+                    m_LoadTasks.removeAt(index);
+                    break;
+                }
+            }
+        }
+
+        for (const auto& binding : streamedTexture->materials)
+        {
+            binding.material->setParamValue<ShaderUniformType::Texture>(binding.paramName, m_PlaceholderTexture);
+        }
+        if (streamedTexture->uploadingTexture != nullptr)
+        {
+            getRenderEngine()->waitForUploadBatch(streamedTexture->uploadBatchID);
+            deleteTextureLater(streamedTexture->uploadingTexture);
+        }
+        deleteTextureLater(streamedTexture->texture);
+        m_Textures.remove(textureID);
+    }
+
+    StreamedTextureState TextureStreamer::getState(const streamed_texture_id textureID) const
+    {
+        const StreamedTexture* streamedTexture = m_Textures.find(textureID);
+        return streamedTexture != nullptr ? streamedTexture->state : StreamedTextureState::Failed;
+    }
+    Texture* TextureStreamer::getTexture(const streamed_texture_id textureID) const
+    {
+        const StreamedTexture* streamedTexture = m_Textures.find(textureID);
+        return (streamedTexture != nullptr) && (streamedTexture->texture != nullptr) ? streamedTexture->texture : m_PlaceholderTexture;
+    }
+
+    bool TextureStreamer::evictTexture(const streamed_texture_id textureID)
+    {
+        StreamedTexture* streamedTexture = m_Textures.find(textureID);
+        if ((streamedTexture == nullptr) || (streamedTexture->state != StreamedTextureState::Resident) || 
+            (streamedTexture->uploadingTexture != nullptr) || streamedTexture->loaded || streamedTexture->retainedLowResolutionData.data.isEmpty())
+        {
+            return false;
+        }
+
+        // Low resolution version goes through the usual upload path
+        streamedTexture->evicted = true;
+        streamedTexture->loaded = true;
+        streamedTexture->lowResolutionData = streamedTexture->retainedLowResolutionData;
+        return true;
+    }
+    bool TextureStreamer::restoreTexture(const streamed_texture_id textureID)
+    {
+        StreamedTexture* streamedTexture = m_Textures.find(textureID);
+        if ((streamedTexture == nullptr) || !streamedTexture->evicted || (streamedTexture->uploadingTexture != nullptr) || streamedTexture->loaded)
+        {
+            return false;
+        }
+
+        streamedTexture->evicted = false;
+        {
+            std::lock_guard lock(m_LoadMutex);
+            m_LoadTasks.add({ textureID, streamedTexture->priority, streamedTexture->loadFunction });
+        }
+        m_LoadCondition.notify_one();
+        return true;
+    }
+    bool TextureStreamer::isEvicted(const streamed_texture_id textureID) const
+    {
+        const StreamedTexture* streamedTexture = m_Textures.find(textureID);
+        return (streamedTexture != nullptr) && streamedTexture->evicted;
+    }
+    uint64 TextureStreamer::getResidentMemorySize(const streamed_texture_id textureID) const
+    {
+        const StreamedTexture* streamedTexture = m_Textures.find(textureID);
+        return streamedTexture != nullptr ? streamedTexture->residentMemorySize : 0;
+    }
+    bool TextureStreamer::isResidencyChangePending(const streamed_texture_id textureID) const
+    {
+        const StreamedTexture* streamedTexture = m_Textures.find(textureID);
+        if (streamedTexture == nullptr)
+        {
+            return false;
+        }
+        if (streamedTexture->loaded || (streamedTexture->uploadingTexture != nullptr) || (m_UpdateIndex < streamedTexture->replacedTextureDeleteUpdate))
+        {
+            return true;
+        }
+        // Restored texture is still loading on the streaming thread
+        return !streamedTexture->evicted && (streamedTexture->state == StreamedTextureState::LowResolution);
+    }
+
+    bool TextureStreamer::bindToMaterial(const streamed_texture_id textureID, Material* material, const jstringID& paramName)
+    {
+        StreamedTexture* streamedTexture = m_Textures.find(textureID);
+        if ((streamedTexture == nullptr) || (material == nullptr))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Invalid input params"));
+            return false;
+        }
+        if (!material->setParamValue<ShaderUniformType::Texture>(paramName, getTexture(textureID)))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to set texture param {}"), paramName.toString());
+            return false;
+        }
+
+        for (const auto& binding : streamedTexture->materials)
+        {
+            if ((binding.material == material) && (binding.paramName == paramName))
+            {
+                return true;
+            }
+        }
+        streamedTexture->materials.add({ material, paramName });
+        return true;
+    }
+    void TextureStreamer::unbindMaterial(Material* material)
+    {
+        for (auto& streamedTexture : m_Textures)
+        {
+            jarray<MaterialBinding>& bindings = streamedTexture.value.materials;
+            for (int32 index = bindings.getSize() - 1; index >= 0; index--)
+            {
+                if (bindings[index].material == material)
+                {
+                    bindings.removeAt(index);
+                }
+            }
+        }
+    }
+
+    void TextureStreamer::update()
+    {
+        if (!isValid())
+        {
+            return;
+        }
+
+        m_UpdateIndex++;
+
+        // Frame in flight doesn't use textures replaced before the previous update
+        for (const auto& texture : m_TexturesForDelete)
+        {
+            delete texture;
+        }
+        m_TexturesForDelete = m_TexturesForDeleteNextUpdate;
+        m_TexturesForDeleteNextUpdate.clear();
+
+        takeLoadResults();
+        finishUploads();
+        uploadTextures();
+        finishUploads();
+    }
+
+    void TextureStreamer::takeLoadResults()
+    {
+        jarray<LoadResult> loadResults;
+        {
+            std::lock_guard lock(m_LoadMutex);
+            if (m_LoadResults.isEmpty())
+            {
+                return;
+            }
+            loadResults = std::move(m_LoadResults);
+            m_LoadResults.clear();
+        }
+
+        for (auto& loadResult : loadResults)
+        {
+            StreamedTexture* streamedTexture = m_Textures.find(loadResult.textureID);
+            if (streamedTexture == nullptr)
+            {
+                // Released while loading
+                continue;
+            }
+            if (!loadResult.success)
+            {
+                JUMA_RENDER_LOG(error, JSTR("Failed to load streamed texture {}"), loadResult.textureID);
+                streamedTexture->state = StreamedTextureState::Failed;
+                continue;
+            }
+
+            streamedTexture->loaded = true;
+            streamedTexture->data = std::move(loadResult.data);
+            streamedTexture->retainedLowResolutionData = loadResult.lowResolutionData;
+            streamedTexture->lowResolutionData = std::move(loadResult.lowResolutionData);
+        }
+    }
+    void TextureStreamer::uploadTextures()
+    {
+        RenderEngine* renderEngine = getRenderEngine();
+        if (renderEngine->isUploadBatchActive())
+        {
+            // Can't track uploads of someone else's batch
+            return;
+        }
+
+        struct UploadCandidate
+        {
+            streamed_texture_id textureID = streamed_texture_id_INVALID;
+            int32 priority = 0;
+            bool lowResolution = false;
+        };
+        jarray<UploadCandidate> candidates;
+        for (const auto& streamedTexture : m_Textures)
+        {
+            const StreamedTexture& data = streamedTexture.value;
+            if (!data.loaded || (data.uploadingTexture != nullptr))
+            {
+                continue;
+            }
+            const bool lowResolution = ((data.state == StreamedTextureState::Loading) || data.evicted) && !data.lowResolutionData.data.isEmpty();
+            candidates.add({ streamedTexture.key, data.priority, lowResolution });
+        }
+        if (candidates.isEmpty())
+        {
+            return;
+        }
+        // Low resolution versions of all textures go first, then by priority
+        std::sort(candidates.getData(), candidates.getData() + candidates.getSize(), [](const UploadCandidate& a, const UploadCandidate& b)
+        {
+            return (a.lowResolution != b.lowResolution) ? a.lowResolution : (a.priority > b.priority);
+        });
+
+        if (!renderEngine->beginUploadBatch())
+        {
+            return;
+        }
+        jarray<StreamedTexture*> uploadedTextures;
+        uint64 uploadedSize = 0;
+        for (const auto& candidate : candidates)
+        {
+            StreamedTexture* streamedTexture = m_Textures.find(candidate.textureID);
+            TextureLoadData& data = candidate.lowResolution ? streamedTexture->lowResolutionData : streamedTexture->data;
+            const uint64 dataSize = static_cast<uint64>(data.data.getSize());
+            // At least one texture is uploaded every frame, so big textures are not starved
+            if ((uploadedSize > 0) && ((uploadedSize + dataSize) > m_UploadBudget))
+            {
+                continue;
+            }
+
+            Texture* texture = renderEngine->createTexture(data.size, data.format, data.data.getData());
+            if (texture == nullptr)
+            {
+                JUMA_RENDER_LOG(error, JSTR("Failed to create streamed texture {}"), candidate.textureID);
+                streamedTexture->state = StreamedTextureState::Failed;
+                streamedTexture->loaded = false;
+                streamedTexture->data = TextureLoadData();
+                streamedTexture->lowResolutionData = TextureLoadData();
+                continue;
+            }
+
+            streamedTexture->uploadingTexture = texture;
+            streamedTexture->uploadingState = candidate.lowResolution ? StreamedTextureState::LowResolution : StreamedTextureState::Resident;
+            data = TextureLoadData();
+            // Evicted texture has only low resolution data
+            if (!candidate.lowResolution || streamedTexture->data.data.isEmpty())
+            {
+                streamedTexture->loaded = false;
+                streamedTexture->lowResolutionData = TextureLoadData();
+            }
+            uploadedTextures.add(streamedTexture);
+            uploadedSize += dataSize;
+        }
+
+        const uint64 uploadBatchID = renderEngine->endUploadBatch();
+        for (const auto& streamedTexture : uploadedTextures)
+        {
+            streamedTexture->uploadBatchID = uploadBatchID;
+        }
+    }
+    void TextureStreamer::finishUploads()
+    {
+        RenderEngine* renderEngine = getRenderEngine();
+        for (auto& streamedTexture : m_Textures)
+        {
+            StreamedTexture& data = streamedTexture.value;
+            if ((data.uploadingTexture == nullptr) || !renderEngine->isUploadBatchFinished(data.uploadBatchID))
+            {
+                continue;
+            }
+
+            deleteTextureLater(data.texture);
+            data.replacedTextureDeleteUpdate = m_UpdateIndex + 2;
+            data.texture = data.uploadingTexture;
+            data.state = data.uploadingState;
+            data.uploadingTexture = nullptr;
+            data.uploadBatchID = 0;
+            if (data.state == StreamedTextureState::Resident)
+            {
+                data.residentMemorySize = data.texture->getMemorySize();
+            }
+            setMaterialsTexture(data);
+        }
+    }
+    void TextureStreamer::setMaterialsTexture(const StreamedTexture& streamedTexture) const
+    {
+        for (const auto& binding : streamedTexture.materials)
+        {
+            binding.material->setParamValue<ShaderUniformType::Texture>(binding.paramName, streamedTexture.texture);
+        }
+    }
+    void TextureStreamer::deleteTextureLater(Texture* texture)
+    {
+        if (texture != nullptr)
+        {
+            m_TexturesForDeleteNextUpdate.add(texture);
+        }
+    }
+
+    void TextureStreamer::loadThreadFunction()
+    {
+        while (true)
+        {
+            LoadTask task;
+            {
+                std::unique_lock lock(m_LoadMutex);
+                m_LoadCondition.wait(lock, [this]() { return m_StopLoadThread || !m_LoadTasks.isEmpty(); });
+                if (m_StopLoadThread)
+                {
+                    return;
+                }
+
+                int32 taskIndex = 0;
+                for (int32 index = 1; index < m_LoadTasks.getSize(); index++)
+                {
+                    if (m_LoadTasks[index].priority > m_LoadTasks[taskIndex].priority)
+                    {
+                        taskIndex = index;
+                    }
+                }
+                task = m_LoadTasks[taskIndex];
+                m_LoadTasks.removeAt(taskIndex);
+            }
+
+            LoadResult result;
+            result.textureID = task.textureID;
+            result.success = task.loadFunction(result.data) && (result.data.size.x > 0) && (result.data.size.y > 0) &&
+                (static_cast<uint32>(result.data.data.getSize()) == GetTextureDataSize(result.data.format, result.data.size.x, result.data.size.y));
+            if (result.success)
+            {
+                createLowResolutionData(result.data, result.lowResolutionData);
+            }
+
+            std::lock_guard lock(m_LoadMutex);
+            m_LoadResults.add(std::move(result));
+        }
+    }
+    bool TextureStreamer::createLowResolutionData(const TextureLoadData& data, TextureLoadData& outLowResolutionData)
+    {
+        // Box filter works only for formats with 8-bit channels
+        if (((data.format != TextureFormat::RGBA8) && (data.format != TextureFormat::BGRA8)) ||
+            (math::max(data.size.x, data.size.y) <= LowResolutionMaxSize))
+        {
+            return false;
+        }
+
+        constexpr uint32 pixelSize = 4;
+        const jarray<uint8>* srcPixels = &data.data;
+        math::uvector2 srcSize = data.size;
+        jarray<uint8> pixels;
+        while (math::max(srcSize.x, srcSize.y) > LowResolutionMaxSize)
+        {
+            const math::uvector2 dstSize = { math::max(srcSize.x / 2, 1u), math::max(srcSize.y / 2, 1u) };
+            jarray<uint8> dstPixels(static_cast<int32>(dstSize.x * dstSize.y * pixelSize), 0);
+            for (uint32 y = 0; y < dstSize.y; y++)
+            {
+                const uint32 srcY0 = math::min(y * 2, srcSize.y - 1);
+                const uint32 srcY1 = math::min(y * 2 + 1, srcSize.y - 1);
+                for (uint32 x = 0; x < dstSize.x; x++)
+                {
+                    const uint32 srcX0 = math::min(x * 2, srcSize.x - 1);
+                    const uint32 srcX1 = math::min(x * 2 + 1, srcSize.x - 1);
+                    for (uint32 channel = 0; channel < pixelSize; channel++)
+                    {
+                        const uint32 sum = (*srcPixels)[static_cast<int32>((srcY0 * srcSize.x + srcX0) * pixelSize + channel)]
+                            + (*srcPixels)[static_cast<int32>((srcY0 * srcSize.x + srcX1) * pixelSize + channel)]
+                            + (*srcPixels)[static_cast<int32>((srcY1 * srcSize.x + srcX0) * pixelSize + channel)]
+                            + (*srcPixels)[static_cast<int32>((srcY1 * srcSize.x + srcX1) * pixelSize + channel)];
+                        dstPixels[static_cast<int32>((y * dstSize.x + x) * pixelSize + channel)] = static_cast<uint8>((sum + 2) / 4);
+                    }
+                }
+            }
+            pixels = std::move(dstPixels);
+            srcPixels = &pixels;
+            srcSize = dstSize;
+        }
+
+        outLowResolutionData.size = srcSize;
+        outLowResolutionData.format = data.format;
+        outLowResolutionData.data = std::move(pixels);
+        return true;
+    }
+}
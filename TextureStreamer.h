@@ -0,0 +1,160 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#pragma once
+
+#include "renderEngine/juma_render_engine_core.h"
+#include "RenderEngineContextObject.h"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "jutils/jarray.h"
+#include "jutils/jmap.h"
+#include "jutils/jstringID.h"
+#include "jutils/juid.h"
+#include "jutils/math/vector2.h"
+#include "texture/TextureFormat.h"
+
+namespace JumaRenderEngine
+{
+    class Material;
+    class Texture;
+
+    using streamed_texture_id = uint32;
+    constexpr streamed_texture_id streamed_texture_id_INVALID = juid<streamed_texture_id>::invalidUID;
+
+    struct TextureLoadData
+    {
+        math::uvector2 size = { 0, 0 };
+        TextureFormat format = TextureFormat::RGBA8;
+        jarray<uint8> data;
+    };
+    // Called on the streaming thread, so it must not call render engine
+    using TextureLoadFunction = std::function<bool(TextureLoadData& outData)>;
+
+    enum class StreamedTextureState : uint8 { Loading, LowResolution, Resident, Failed };
+
+    // Loads textures on the background thread and uploads them within per frame budget.
+    // Materials bound to the streamed texture get placeholder, then low resolution version, then full texture
+    class TextureStreamer : public RenderEngineContextObject
+    {
+        friend RenderEngine;
+
+    public:
+        TextureStreamer() = default;
+        virtual ~TextureStreamer() override;
+
+        static constexpr uint32 DefaultUploadBudget = 8 * 1024 * 1024;
+        static constexpr uint32 LowResolutionMaxSize = 64;
+
+        uint32 getUploadBudget() const { return m_UploadBudget; }
+        void setUploadBudget(const uint32 bytesPerFrame) { m_UploadBudget = bytesPerFrame; }
+
+        // Higher priority is loaded and uploaded first
+        streamed_texture_id requestTexture(TextureLoadFunction loadFunction, int32 priority = 0);
+        void setPriority(streamed_texture_id textureID, int32 priority);
+        void releaseTexture(streamed_texture_id textureID);
+
+        jarray<streamed_texture_id> getTextureIDs() const { return m_Textures.getKeys(); }
+        StreamedTextureState getState(streamed_texture_id textureID) const;
+        // Placeholder until something is uploaded
+        Texture* getTexture(streamed_texture_id textureID) const;
+
+        // Replaces resident texture with its low resolution version, full texture is loaded again by restoreTexture()
+        bool evictTexture(streamed_texture_id textureID);
+        bool restoreTexture(streamed_texture_id textureID);
+        bool isEvicted(streamed_texture_id textureID) const;
+        // Memory size of the full texture, zero if it was never resident
+        uint64 getResidentMemorySize(streamed_texture_id textureID) const;
+        // True until eviction or restoration is uploaded and replaced texture is deleted
+        bool isResidencyChangePending(streamed_texture_id textureID) const;
+
+        bool bindToMaterial(streamed_texture_id textureID, Material* material, const jstringID& paramName);
+        // Must be called before destroying material bound to streamed textures
+        void unbindMaterial(Material* material);
+
+        void update();
+
+    protected:
+
+        virtual void clearInternal() override { clearData(); }
+
+    private:
+
+        struct MaterialBinding
+        {
+            Material* material = nullptr;
+            jstringID paramName = jstringID_NONE;
+        };
+        struct StreamedTexture
+        {
+            int32 priority = 0;
+            StreamedTextureState state = StreamedTextureState::Loading;
+
+            Texture* texture = nullptr;
+            jarray<MaterialBinding> materials;
+
+            TextureLoadFunction loadFunction;
+            bool loaded = false;
+            TextureLoadData data;
+            TextureLoadData lowResolutionData;
+
+            // Small enough to keep, used when texture is evicted
+            TextureLoadData retainedLowResolutionData;
+            bool evicted = false;
+            uint64 residentMemorySize = 0;
+
+            Texture* uploadingTexture = nullptr;
+            StreamedTextureState uploadingState = StreamedTextureState::Loading;
+            uint64 uploadBatchID = 0;
+            // Replaced texture is deleted at the start of this update
+            uint64 replacedTextureDeleteUpdate = 0;
+        };
+        struct LoadTask
+        {
+            streamed_texture_id textureID = streamed_texture_id_INVALID;
+            int32 priority = 0;
+            TextureLoadFunction loadFunction;
+        };
+        struct LoadResult
+        {
+            streamed_texture_id textureID = streamed_texture_id_INVALID;
+            bool success = false;
+            TextureLoadData data;
+            TextureLoadData lowResolutionData;
+        };
+
+        uint32 m_UploadBudget = DefaultUploadBudget;
+        uint64 m_UpdateIndex = 0;
+        Texture* m_PlaceholderTexture = nullptr;
+
+        juid<streamed_texture_id> m_TextureIDs;
+        jmap<streamed_texture_id, StreamedTexture> m_Textures;
+        // Could still be used by the frame in flight, deleted on the next update
+        jarray<Texture*> m_TexturesForDelete;
+        jarray<Texture*> m_TexturesForDeleteNextUpdate;
+
+        std::thread m_LoadThread;
+        std::mutex m_LoadMutex;
+        std::condition_variable m_LoadCondition;
+        bool m_StopLoadThread = false;
+        jarray<LoadTask> m_LoadTasks;
+        jarray<LoadResult> m_LoadResults;
+
+
+        bool init();
+
+        void clearData();
+
+        void loadThreadFunction();
+        static bool createLowResolutionData(const TextureLoadData& data, TextureLoadData& outLowResolutionData);
+
+        void takeLoadResults();
+        void uploadTextures();
+        void finishUploads();
+        void setMaterialsTexture(const StreamedTexture& streamedTexture) const;
+        void deleteTextureLater(Texture* texture);
+    };
+}
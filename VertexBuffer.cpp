@@ -11,9 +11,10 @@ namespace JumaRenderEngine
         clearData();
     }
 
-    bool VertexBuffer::init(VertexBufferData* verticesData)
+    bool VertexBuffer::init(VertexBufferData* verticesData, const bool dynamic)
     {
         m_VertexTypeName = verticesData->getVertexTypeName();
+        m_Dynamic = dynamic;
         if (!initInternal(verticesData))
         {
             JUMA_RENDER_LOG(error, JSTR("Failed to initialize vertex buffer"));
@@ -26,5 +27,39 @@ namespace JumaRenderEngine
     void VertexBuffer::clearData()
     {
         m_VertexTypeName = jstringID_NONE;
+        m_Dynamic = false;
+        m_DynamicSegmentIndex = 0;
+        m_DynamicSegmentRendered = false;
+    }
+
+    bool VertexBuffer::update(VertexBufferData* verticesData)
+    {
+        if (!m_Dynamic)
+        {
+            JUMA_RENDER_LOG(error, JSTR("Vertex buffer is not dynamic"));
+            return false;
+        }
+        if ((verticesData == nullptr) || (verticesData->getVertexTypeName() != m_VertexTypeName))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Invalid vertex buffer data"));
+            return false;
+        }
+
+        if (m_DynamicSegmentRendered)
+        {
+            m_DynamicSegmentIndex = (m_DynamicSegmentIndex + 1) % DynamicSegmentCount;
+            m_DynamicSegmentRendered = false;
+        }
+        if (!updateInternal(verticesData))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to update vertex buffer"));
+            return false;
+        }
+        return true;
+    }
+    bool VertexBuffer::updateInternal(VertexBufferData* verticesData)
+    {
+        JUMA_RENDER_LOG(warning, JSTR("Dynamic vertex buffers are not supported by this render API"));
+        return false;
     }
 }
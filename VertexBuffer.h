@@ -9,6 +9,7 @@
 
 namespace JumaRenderEngine
 {
+    struct GeometryArenaAllocation;
     struct RenderOptions;
     class Material;
     class VertexBufferData;
@@ -22,18 +23,35 @@ namespace JumaRenderEngine
         virtual ~VertexBuffer() override;
 
         const jstringID& getVertexTypeName() const { return m_VertexTypeName; }
+        bool isDynamic() const { return m_Dynamic; }
+        // Null if vertex buffer data is not stored in geometry arena
+        virtual const GeometryArenaAllocation* getGeometryAllocation() const { return nullptr; }
+
+        // Replace vertices and indices of the dynamic vertex buffer
+        bool update(VertexBufferData* verticesData);
 
         virtual void render(const RenderOptions* renderOptions, Material* material) = 0;
 
     protected:
 
-        bool init(VertexBufferData* verticesData);
+        // One segment could be read by the frame in flight while other one is written
+        static constexpr uint8 DynamicSegmentCount = 2;
+
+        bool init(VertexBufferData* verticesData, bool dynamic);
 
         virtual bool initInternal(VertexBufferData* verticesData) = 0;
+        virtual bool updateInternal(VertexBufferData* verticesData);
+
+        uint8 getDynamicSegmentIndex() const { return m_DynamicSegmentIndex; }
+        void markDynamicSegmentRendered() { m_DynamicSegmentRendered = true; }
 
     private:
 
         jstringID m_VertexTypeName = jstringID_NONE;
+        bool m_Dynamic = false;
+
+        uint8 m_DynamicSegmentIndex = 0;
+        bool m_DynamicSegmentRendered = false;
 
 
         void clearData();
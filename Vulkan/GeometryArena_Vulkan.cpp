@@ -0,0 +1,134 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#include "GeometryArena_Vulkan.h"
+
+#if defined(JUMARENDERENGINE_INCLUDE_RENDER_API_VULKAN)
+
+#include "RenderEngine_Vulkan.h"
+#include "RenderOptions_Vulkan.h"
+#include "vulkanObjects/VulkanCommandBuffer.h"
+#include "vulkanObjects/VulkanUploadBatch.h"
+
+namespace JumaRenderEngine
+{
+    GeometryArena_Vulkan::~GeometryArena_Vulkan()
+    {
+        clearVulkan();
+    }
+
+    bool GeometryArena_Vulkan::initInternal()
+    {
+        m_VertexBuffer = createBuffer(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, getVertexCapacity() * getVertexSize());
+        m_IndexBuffer = createBuffer(VK_BUFFER_USAGE_INDEX_BUFFER_BIT, getIndexCapacity() * sizeof(uint32));
+        if ((m_VertexBuffer == nullptr) || (m_IndexBuffer == nullptr))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to create vulkan buffers for geometry arena"));
+            clearVulkan();
+            return false;
+        }
+        return true;
+    }
+    VulkanBuffer* GeometryArena_Vulkan::createBuffer(const VkBufferUsageFlags usage, const uint32 size) const
+    {
+        RenderEngine_Vulkan* renderEngine = getRenderEngine<RenderEngine_Vulkan>();
+        VulkanBuffer* buffer = renderEngine->getVulkanBuffer();
+        if (!buffer->initGPU(usage | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, { VulkanQueueType::Graphics, VulkanQueueType::Transfer }, size, nullptr))
+        {
+            renderEngine->returnVulkanBuffer(buffer);
+            return nullptr;
+        }
+        return buffer;
+    }
+
+    void GeometryArena_Vulkan::clearInternal()
+    {
+        clearVulkan();
+        Super::clearInternal();
+    }
+    void GeometryArena_Vulkan::clearVulkan()
+    {
+        RenderEngine_Vulkan* renderEngine = getRenderEngine<RenderEngine_Vulkan>();
+        if (m_IndexBuffer != nullptr)
+        {
+            renderEngine->returnVulkanBuffer(m_IndexBuffer);
+            m_IndexBuffer = nullptr;
+        }
+        if (m_VertexBuffer != nullptr)
+        {
+            renderEngine->returnVulkanBuffer(m_VertexBuffer);
+            m_VertexBuffer = nullptr;
+        }
+    }
+
+    bool GeometryArena_Vulkan::uploadVertices(const uint32 firstVertex, const uint32 vertexCount, const void* data)
+    {
+        const uint32 vertexSize = getVertexSize();
+        return m_VertexBuffer->setData(data, vertexCount * vertexSize, firstVertex * vertexSize, true);
+    }
+    bool GeometryArena_Vulkan::uploadIndices(const uint32 firstIndex, const uint32 indexCount, const uint32* data)
+    {
+        return m_IndexBuffer->setData(data, indexCount * sizeof(uint32), firstIndex * sizeof(uint32), true);
+    }
+
+    bool GeometryArena_Vulkan::relocateData(const jarray<GeometryArenaRelocation>& vertexRelocations,
+        const jarray<GeometryArenaRelocation>& indexRelocations)
+    {
+        // Old buffers could still receive data from submitted upload batches
+        VulkanUploadBatch* uploadBatch = getRenderEngine<RenderEngine_Vulkan>()->getUploadBatch();
+        uploadBatch->wait(uploadBatch->getLastSubmittedValue());
+
+        const uint32 vertexSize = getVertexSize();
+        jarray<VkBufferCopy> vertexRegions;
+        vertexRegions.reserve(vertexRelocations.getSize());
+        for (const auto& relocation : vertexRelocations)
+        {
+            if (relocation.size > 0)
+            {
+                vertexRegions.add({ relocation.srcOffset * vertexSize, relocation.dstOffset * vertexSize, relocation.size * vertexSize });
+            }
+        }
+        jarray<VkBufferCopy> indexRegions;
+        indexRegions.reserve(indexRelocations.getSize());
+        for (const auto& relocation : indexRelocations)
+        {
+            if (relocation.size > 0)
+            {
+                indexRegions.add({ relocation.srcOffset * sizeof(uint32), relocation.dstOffset * sizeof(uint32), relocation.size * sizeof(uint32) });
+            }
+        }
+
+        VulkanBuffer* vertexBuffer = createBuffer(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, m_VertexBuffer->getSize());
+        VulkanBuffer* indexBuffer = createBuffer(VK_BUFFER_USAGE_INDEX_BUFFER_BIT, m_IndexBuffer->getSize());
+        RenderEngine_Vulkan* renderEngine = getRenderEngine<RenderEngine_Vulkan>();
+        if ((vertexBuffer == nullptr) || (indexBuffer == nullptr) ||
+            !m_VertexBuffer->copyData(vertexBuffer, vertexRegions, true) || !m_IndexBuffer->copyData(indexBuffer, indexRegions, true))
+        {
+            renderEngine->returnVulkanBuffer(vertexBuffer);
+            renderEngine->returnVulkanBuffer(indexBuffer);
+            return false;
+        }
+
+        renderEngine->returnVulkanBuffer(m_VertexBuffer);
+        renderEngine->returnVulkanBuffer(m_IndexBuffer);
+        m_VertexBuffer = vertexBuffer;
+        m_IndexBuffer = indexBuffer;
+        return true;
+    }
+
+    void GeometryArena_Vulkan::bindBuffers(const RenderOptions_Vulkan* renderOptions) const
+    {
+        if (renderOptions->boundGeometryArena == this)
+        {
+            return;
+        }
+
+        VkCommandBuffer commandBuffer = renderOptions->commandBuffer->get();
+        VkBuffer vertexBuffer = m_VertexBuffer->get();
+        constexpr VkDeviceSize offset = 0;
+        vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, &offset);
+        vkCmdBindIndexBuffer(commandBuffer, m_IndexBuffer->get(), 0, VK_INDEX_TYPE_UINT32);
+        renderOptions->boundGeometryArena = this;
+    }
+}
+
+#endif
@@ -0,0 +1,50 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#pragma once
+
+#include "renderEngine/juma_render_engine_core.h"
+
+#if defined(JUMARENDERENGINE_INCLUDE_RENDER_API_VULKAN)
+
+#include "renderEngine/GeometryArena.h"
+
+#include <vulkan/vulkan_core.h>
+
+namespace JumaRenderEngine
+{
+    struct RenderOptions_Vulkan;
+    class VulkanBuffer;
+
+    class GeometryArena_Vulkan final : public GeometryArena
+    {
+        using Super = GeometryArena;
+
+    public:
+        GeometryArena_Vulkan() = default;
+        virtual ~GeometryArena_Vulkan() override;
+
+        void bindBuffers(const RenderOptions_Vulkan* renderOptions) const;
+
+    protected:
+
+        virtual bool initInternal() override;
+        virtual void clearInternal() override;
+
+        virtual bool uploadVertices(uint32 firstVertex, uint32 vertexCount, const void* data) override;
+        virtual bool uploadIndices(uint32 firstIndex, uint32 indexCount, const uint32* data) override;
+        virtual bool relocateData(const jarray<GeometryArenaRelocation>& vertexRelocations,
+            const jarray<GeometryArenaRelocation>& indexRelocations) override;
+
+    private:
+
+        VulkanBuffer* m_VertexBuffer = nullptr;
+        VulkanBuffer* m_IndexBuffer = nullptr;
+
+
+        VulkanBuffer* createBuffer(VkBufferUsageFlags usage, uint32 size) const;
+
+        void clearVulkan();
+    };
+}
+
+#endif
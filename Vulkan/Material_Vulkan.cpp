@@ -7,7 +7,9 @@
 #include "RenderEngine_Vulkan.h"
 #include "RenderTarget_Vulkan.h"
 #include "RenderOptions_Vulkan.h"
+#include "renderEngine/RenderTargetAttachment.h"
 #include "Shader_Vulkan.h"
+#include "TextureArray_Vulkan.h"
 #include "Texture_Vulkan.h"
 #include "VertexBuffer_Vulkan.h"
 #include "vulkanObjects/VulkanCommandBuffer.h"
@@ -46,6 +48,7 @@ namespace JumaRenderEngine
             switch (uniform.value.type)
             {
             case ShaderUniformType::Texture: 
+            case ShaderUniformType::TextureArray:
                 imageUniformCount++;
                 break;
             default: ;
@@ -234,6 +237,7 @@ namespace JumaRenderEngine
                         continue;
                     }
                     VulkanImage* vulkanImage = nullptr;
+                    RenderTarget_Vulkan* renderTarget = nullptr;
                     {
                         Texture_Vulkan* texture = dynamic_cast<Texture_Vulkan*>(value);
                         if (texture != nullptr)
@@ -242,17 +246,34 @@ namespace JumaRenderEngine
                         }
                         else
                         {
-                            RenderTarget_Vulkan* renderTarget = dynamic_cast<RenderTarget_Vulkan*>(value);
+                            renderTarget = dynamic_cast<RenderTarget_Vulkan*>(value);
                             if (renderTarget != nullptr)
                             {
                                 vulkanImage = renderTarget->getResultImage();
                             }
+                            else
+                            {
+                                const RenderTargetAttachment* attachment = dynamic_cast<RenderTargetAttachment*>(value);
+                                renderTarget = attachment != nullptr ? dynamic_cast<RenderTarget_Vulkan*>(attachment->getRenderTarget()) : nullptr;
+                                if (renderTarget != nullptr)
+                                {
+                                    vulkanImage = renderTarget->getResultImage(attachment->getAttachmentIndex());
+                                }
+                            }
                         }
                         if (vulkanImage == nullptr)
                         {
                             continue;
                         }
                     }
+                    if (renderTarget != nullptr)
+                    {
+                        m_RenderTargetParamVersions[uniform.key] = renderTarget->getFramebuffersVersion();
+                    }
+                    else
+                    {
+                        m_RenderTargetParamVersions.remove(uniform.key);
+                    }
 
                     VkDescriptorImageInfo& imageInfo = imageInfos.addDefault();
                     imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
@@ -268,6 +289,33 @@ namespace JumaRenderEngine
                     descriptorWrite.pImageInfo = &imageInfo;
                 }
                 break;
+            case ShaderUniformType::TextureArray:
+                {
+                    ShaderUniformInfo<ShaderUniformType::TextureArray>::value_type value;
+                    if (!params.getValue<ShaderUniformType::TextureArray>(uniform.key, value))
+                    {
+                        continue;
+                    }
+                    const TextureArray_Vulkan* textureArray = dynamic_cast<TextureArray_Vulkan*>(value);
+                    if ((textureArray == nullptr) || (textureArray->getVulkanImage() == nullptr))
+                    {
+                        continue;
+                    }
+
+                    VkDescriptorImageInfo& imageInfo = imageInfos.addDefault();
+                    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                    imageInfo.imageView = textureArray->getVulkanImage()->getImageView();
+                    imageInfo.sampler = renderEngine->getTextureSampler(value->getSamplerType());
+                    VkWriteDescriptorSet& descriptorWrite = descriptorWrites.addDefault();
+                    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                    descriptorWrite.dstSet = m_DescriptorSet;
+                    descriptorWrite.dstBinding = uniform.value.shaderLocation;
+                    descriptorWrite.dstArrayElement = 0;
+                    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                    descriptorWrite.descriptorCount = 1;
+                    descriptorWrite.pImageInfo = &imageInfo;
+                }
+                break;
 
             default: ;
             }
@@ -291,6 +339,31 @@ namespace JumaRenderEngine
         }
         return true;
     }
+    void Material_Vulkan::updateRenderTargetParams()
+    {
+        // Render targets could recreate their images (and pooled images could be given to other render targets),
+        // so descriptors with old images should be written again
+        const MaterialParamsStorage& params = getMaterialParams();
+        for (const auto& paramVersion : m_RenderTargetParamVersions)
+        {
+            ShaderUniformInfo<ShaderUniformType::Texture>::value_type value;
+            if (!params.getValue<ShaderUniformType::Texture>(paramVersion.key, value))
+            {
+                continue;
+            }
+            const RenderTarget_Vulkan* renderTarget = dynamic_cast<RenderTarget_Vulkan*>(value);
+            if (renderTarget == nullptr)
+            {
+                // Additional color attachments are released together with the main one
+                const RenderTargetAttachment* attachment = dynamic_cast<RenderTargetAttachment*>(value);
+                renderTarget = attachment != nullptr ? dynamic_cast<RenderTarget_Vulkan*>(attachment->getRenderTarget()) : nullptr;
+            }
+            if ((renderTarget != nullptr) && (renderTarget->getFramebuffersVersion() != paramVersion.value))
+            {
+                markParamForUpdate(paramVersion.key);
+            }
+        }
+    }
 
     void Material_Vulkan::clearVulkan()
     {
@@ -321,6 +394,7 @@ namespace JumaRenderEngine
             }
             m_UniformBuffers.clear();
         }
+        m_RenderTargetParamVersions.clear();
     }
 
     bool Material_Vulkan::bindMaterial(const RenderOptions* renderOptions, VertexBuffer_Vulkan* vertexBuffer)
@@ -423,12 +497,19 @@ namespace JumaRenderEngine
         colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
         colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
         colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+        VkPipelineColorBlendAttachmentState colorBlendAttachments[1 + VulkanRenderPassDescription::MaxAdditionalColorAttachmentCount];
+        const uint8 colorAttachmentCount = renderPass->getDescription().getColorAttachmentCount();
+        for (uint8 index = 0; index < colorAttachmentCount; index++)
+        {
+            colorBlendAttachments[index] = colorBlendAttachment;
+        }
         VkPipelineColorBlendStateCreateInfo colorBlending{};
         colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
         colorBlending.logicOpEnable = VK_FALSE;
         colorBlending.logicOp = VK_LOGIC_OP_COPY;
-        colorBlending.attachmentCount = 1;
-        colorBlending.pAttachments = &colorBlendAttachment;
+        // Depth-only render pass has no color attachment to blend
+        colorBlending.attachmentCount = colorAttachmentCount;
+        colorBlending.pAttachments = colorBlendAttachments;
         colorBlending.blendConstants[0] = 0.0f;
         colorBlending.blendConstants[1] = 0.0f;
         colorBlending.blendConstants[2] = 0.0f;
@@ -444,8 +525,23 @@ namespace JumaRenderEngine
         dynamicState.dynamicStateCount = 2;
         dynamicState.pDynamicStates = dynamicStates;
 
+        // Without render pass object pipeline gets attachment formats directly
+        const VulkanRenderPassDescription& renderPassDescription = renderPass->getDescription();
+        VkFormat colorAttachmentFormats[1 + VulkanRenderPassDescription::MaxAdditionalColorAttachmentCount];
+        for (uint8 index = 0; index < colorAttachmentCount; index++)
+        {
+            colorAttachmentFormats[index] = index == 0 ? renderPassDescription.colorFormat : renderPassDescription.additionalColorFormats[index - 1];
+        }
+        VkPipelineRenderingCreateInfo renderingInfo{};
+        renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+        renderingInfo.colorAttachmentCount = colorAttachmentCount;
+        renderingInfo.pColorAttachmentFormats = colorAttachmentFormats;
+        renderingInfo.depthAttachmentFormat = renderPassDescription.shouldUseDepth ? renderPassDescription.depthFormat : VK_FORMAT_UNDEFINED;
+        renderingInfo.stencilAttachmentFormat = renderPassDescription.hasStencil() ? renderPassDescription.depthFormat : VK_FORMAT_UNDEFINED;
+
         VkGraphicsPipelineCreateInfo pipelineInfo{};
         pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pipelineInfo.pNext = renderPass->isDynamicRendering() ? &renderingInfo : nullptr;
         pipelineInfo.stageCount = static_cast<uint32>(shaderStageInfos.getSize());
         pipelineInfo.pStages = shaderStageInfos.getData();
         pipelineInfo.pVertexInputState = &vertexInputInfo;
@@ -477,6 +573,7 @@ namespace JumaRenderEngine
 
     bool Material_Vulkan::bindDescriptorSet(VkCommandBuffer commandBuffer)
     {
+        updateRenderTargetParams();
         if (!updateDescriptorSetData())
         {
             return false;
@@ -50,11 +50,14 @@ namespace JumaRenderEngine
         jmap<VulkanRenderPipelineID, VkPipeline> m_RenderPipelines;
 
         jmap<uint32, VulkanBuffer*> m_UniformBuffers;
+        // Framebuffers version of the render target for each param that was written with its image
+        jmap<jstringID, uint32> m_RenderTargetParamVersions;
 
         
         bool createDescriptorSet();
         bool initDescriptorSetData();
         bool updateDescriptorSetData();
+        void updateRenderTargetParams();
 
         void clearVulkan();
 
@@ -6,15 +6,19 @@
 
 #if defined(JUMARENDERENGINE_INCLUDE_RENDER_API_VULKAN)
 
+#include "GeometryArena_Vulkan.h"
 #include "Material_Vulkan.h"
 #include "RenderPipeline_Vulkan.h"
 #include "RenderTarget_Vulkan.h"
 #include "Shader_Vulkan.h"
+#include "TextureArray_Vulkan.h"
 #include "Texture_Vulkan.h"
 #include "VertexBuffer_Vulkan.h"
 #include "renderEngine/window/Vulkan/WindowController_Vulkan.h"
 #include "renderEngine/window/Vulkan/WindowControllerInfo_Vulkan.h"
 #include "vulkanObjects/VulkanCommandPool.h"
+#include "vulkanObjects/VulkanStagingRing.h"
+#include "vulkanObjects/VulkanUploadBatch.h"
 
 #ifdef JDEBUG
 VkResult CreateDebugUtilsMessengerEXT(VkInstance instance, const VkDebugUtilsMessengerCreateInfoEXT* pCreateInfo, 
@@ -56,6 +60,10 @@ namespace JumaRenderEngine
     {
         return createObject<Texture_Vulkan>();
     }
+    TextureArray* RenderEngine_Vulkan::createTextureArrayInternal()
+    {
+        return createObject<TextureArray_Vulkan>();
+    }
     Shader* RenderEngine_Vulkan::createShaderInternal()
     {
         return createObject<Shader_Vulkan>();
@@ -72,6 +80,85 @@ namespace JumaRenderEngine
     {
         return createObject<RenderPipeline_Vulkan>();
     }
+    GeometryArena* RenderEngine_Vulkan::createGeometryArenaInternal()
+    {
+        return createObject<GeometryArena_Vulkan>();
+    }
+
+    bool RenderEngine_Vulkan::isTextureFormatSupportedInternal(const TextureFormat format) const
+    {
+        // Textures are sampled with linear filters, mips of uncompressed textures are generated by linear blit
+        if (IsTextureFormatCompressed(format))
+        {
+            // Compressed formats can't be used without device feature even if format properties report support
+            const bool formatETC2 = (format == TextureFormat::ETC2_RGB8) || (format == TextureFormat::ETC2_RGBA8);
+            return (formatETC2 ? m_TextureCompressionETC2Enabled : m_TextureCompressionBCEnabled) && 
+                isFormatFeatureSupported(format, VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT);
+        }
+        return isFormatFeatureSupported(format, VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT | 
+            VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT);
+    }
+    bool RenderEngine_Vulkan::isRenderTargetFormatSupportedInternal(const TextureFormat format) const
+    {
+        // Depth-only render target is sampled without mips, but with the same linear filters as other render targets
+        if (IsTextureFormatDepth(format))
+        {
+            return isFormatFeatureSupported(format, 
+                VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT);
+        }
+        // Result image of the render target is sampled with linear filters and its mips are generated by linear blit
+        return Super::isRenderTargetFormatSupportedInternal(format) && isFormatFeatureSupported(format, 
+            VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT | 
+            VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT);
+    }
+    bool RenderEngine_Vulkan::isFormatFeatureSupported(const TextureFormat format, const VkFormatFeatureFlags features) const
+    {
+        const VkFormat vulkanFormat = GetVulkanFormatByTextureFormat(format);
+        if (vulkanFormat == VK_FORMAT_UNDEFINED)
+        {
+            return false;
+        }
+        VkFormatProperties formatProperties;
+        vkGetPhysicalDeviceFormatProperties(m_PhysicalDevice, vulkanFormat, &formatProperties);
+        return (formatProperties.optimalTilingFeatures & features) == features;
+    }
+
+    bool RenderEngine_Vulkan::getGPUMemoryInfo(uint64& outUsage, uint64& outBudget) const
+    {
+        if (m_Allocator == nullptr)
+        {
+            return false;
+        }
+
+        const VkPhysicalDeviceMemoryProperties* memoryProperties = nullptr;
+        vmaGetMemoryProperties(m_Allocator, &memoryProperties);
+        VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
+        vmaGetHeapBudgets(m_Allocator, budgets);
+
+        uint64 usage = 0;
+        uint64 budget = 0;
+        for (uint32 heapIndex = 0; heapIndex < memoryProperties->memoryHeapCount; heapIndex++)
+        {
+            if ((memoryProperties->memoryHeaps[heapIndex].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0)
+            {
+                usage += budgets[heapIndex].usage;
+                budget += budgets[heapIndex].budget;
+            }
+        }
+        outUsage = usage;
+        outBudget = budget;
+        return budget > 0;
+    }
+    uint8 RenderEngine_Vulkan::getMaxColorAttachmentCount() const
+    {
+        if (m_PhysicalDevice == nullptr)
+        {
+            return Super::getMaxColorAttachmentCount();
+        }
+        VkPhysicalDeviceProperties deviceProperties;
+        vkGetPhysicalDeviceProperties(m_PhysicalDevice, &deviceProperties);
+        return static_cast<uint8>(math::min(deviceProperties.limits.maxColorAttachments, static_cast<uint32>(RenderTarget::MaxColorAttachmentCount)));
+    }
 
     bool RenderEngine_Vulkan::initInternal(const jmap<window_id, WindowProperties>& windows)
     {
@@ -99,6 +186,12 @@ namespace JumaRenderEngine
             JUMA_RENDER_LOG(error, JSTR("Failed to create command pools"));
             return false;
         }
+        if (!createUploadBatch())
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to create upload batch"));
+            return false;
+        }
+        m_StagingRing = createObject<VulkanStagingRing>();
         if (!getWindowController<WindowController_Vulkan>()->createWindowSwapchains())
         {
             JUMA_RENDER_LOG(error, JSTR("Failed to create vulkan swapchains"));
@@ -387,16 +480,72 @@ namespace JumaRenderEngine
             queueInfos.add(queueInfo);
         }
 
+        VkPhysicalDeviceFeatures supportedFeatures;
+        vkGetPhysicalDeviceFeatures(m_PhysicalDevice, &supportedFeatures);
+        m_MultiDrawIndirectSupported = supportedFeatures.multiDrawIndirect == VK_TRUE;
+        m_TextureCompressionBCEnabled = supportedFeatures.textureCompressionBC == VK_TRUE;
+        m_TextureCompressionETC2Enabled = supportedFeatures.textureCompressionETC2 == VK_TRUE;
+
         VkPhysicalDeviceFeatures deviceFeatures{};
         deviceFeatures.samplerAnisotropy = VK_TRUE;
         deviceFeatures.sampleRateShading = VK_TRUE;
+        deviceFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+        deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+        deviceFeatures.textureCompressionETC2 = supportedFeatures.textureCompressionETC2;
+        VkPhysicalDeviceVulkan12Features deviceFeatures12{};
+        deviceFeatures12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        deviceFeatures12.timelineSemaphore = VK_TRUE;
+
+        // Render pass objects are used if device doesn't support Vulkan 1.3
+        VkPhysicalDeviceProperties deviceProperties;
+        vkGetPhysicalDeviceProperties(m_PhysicalDevice, &deviceProperties);
+        if (deviceProperties.apiVersion >= VK_API_VERSION_1_3)
+        {
+            VkPhysicalDeviceVulkan13Features supportedFeatures13{};
+            supportedFeatures13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+            VkPhysicalDeviceFeatures2 supportedFeatures2{};
+            supportedFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            supportedFeatures2.pNext = &supportedFeatures13;
+            vkGetPhysicalDeviceFeatures2(m_PhysicalDevice, &supportedFeatures2);
+            m_DynamicRenderingEnabled = supportedFeatures13.dynamicRendering == VK_TRUE;
+        }
+        VkPhysicalDeviceVulkan13Features deviceFeatures13{};
+        deviceFeatures13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+        deviceFeatures13.dynamicRendering = VK_TRUE;
+        if (m_DynamicRenderingEnabled)
+        {
+            deviceFeatures12.pNext = &deviceFeatures13;
+        }
+
+        // Memory budget extension gives real usage and budget of the heaps, VMA estimates them otherwise
+        jarray<const char*> extensions;
+        for (const auto& extension : m_RequiredExtensions)
+        {
+            extensions.add(extension);
+        }
+        uint32 availableExtensionCount = 0;
+        vkEnumerateDeviceExtensionProperties(m_PhysicalDevice, nullptr, &availableExtensionCount, nullptr);
+        jarray<VkExtensionProperties> availableExtensions(static_cast<int32>(availableExtensionCount));
+        vkEnumerateDeviceExtensionProperties(m_PhysicalDevice, nullptr, &availableExtensionCount, availableExtensions.getData());
+        bool memoryBudgetSupported = false;
+        for (const auto& extension : availableExtensions)
+        {
+            if (strcmp(extension.extensionName, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) == 0)
+            {
+                memoryBudgetSupported = true;
+                extensions.add(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+                break;
+            }
+        }
+
         VkDeviceCreateInfo deviceInfo{};
 	    deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        deviceInfo.pNext = &deviceFeatures12;
 	    deviceInfo.queueCreateInfoCount = static_cast<uint32>(queueInfos.getSize());
 	    deviceInfo.pQueueCreateInfos = queueInfos.getData();
 	    deviceInfo.pEnabledFeatures = &deviceFeatures;
-	    deviceInfo.enabledExtensionCount = m_RequiredExtensionCount;
-	    deviceInfo.ppEnabledExtensionNames = m_RequiredExtensions;
+	    deviceInfo.enabledExtensionCount = static_cast<uint32>(extensions.getSize());
+	    deviceInfo.ppEnabledExtensionNames = extensions.getData();
 	    deviceInfo.enabledLayerCount = 0;
         VkResult result = vkCreateDevice(m_PhysicalDevice, &deviceInfo, nullptr, &m_Device);
         if (result != VK_SUCCESS)
@@ -406,6 +555,7 @@ namespace JumaRenderEngine
         }
 
         VmaAllocatorCreateInfo allocatorInfo{};
+        allocatorInfo.flags = memoryBudgetSupported ? VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT : 0;
         allocatorInfo.vulkanApiVersion = VK_API_VERSION_1_3;
         allocatorInfo.instance = m_VulkanInstance;
         allocatorInfo.physicalDevice = m_PhysicalDevice;
@@ -448,6 +598,18 @@ namespace JumaRenderEngine
         return true;
     }
 
+    bool RenderEngine_Vulkan::createUploadBatch()
+    {
+        VulkanUploadBatch* uploadBatch = createObject<VulkanUploadBatch>();
+        if (!uploadBatch->init())
+        {
+            delete uploadBatch;
+            return false;
+        }
+        m_UploadBatch = uploadBatch;
+        return true;
+    }
+
     void RenderEngine_Vulkan::clearInternal()
     {
         clearVulkan();
@@ -480,6 +642,22 @@ namespace JumaRenderEngine
         m_RenderPassTypes.clear();
         m_RenderPassTypeIDs.reset();
 
+        if (m_StagingRing != nullptr)
+        {
+            delete m_StagingRing;
+            m_StagingRing = nullptr;
+        }
+        if (m_UploadBatch != nullptr)
+        {
+            delete m_UploadBatch;
+            m_UploadBatch = nullptr;
+        }
+
+        m_ImagePool.clear();
+        m_PooledImagesInUse.clear();
+        m_ReleasedPooledImages.clear();
+        m_ImagePoolFrameIndex = 0;
+        m_ImagePoolStats = VulkanImagePoolStats();
         m_UnusedVulkanImages.clear();
         m_UnusedVulkanBuffers.clear();
         m_VulkanImages.clear();
@@ -505,6 +683,8 @@ namespace JumaRenderEngine
             m_Device = nullptr;
         }
         m_PhysicalDevice = nullptr;
+        m_MultiDrawIndirectSupported = false;
+        m_DynamicRenderingEnabled = false;
 
         clearData();
 
@@ -558,13 +738,106 @@ namespace JumaRenderEngine
         {
             return;
         }
+
+        const VulkanImageDescription* description = m_PooledImagesInUse.find(image);
+        if (description != nullptr)
+        {
+            if (m_ImagePoolStats.pooledImageCount < ImagePoolMaxSize)
+            {
+                m_ImagePool[*description].add({ image, m_ImagePoolFrameIndex });
+                m_ImagePoolStats.pooledImageCount++;
+                m_PooledImagesInUse.remove(image);
+                return;
+            }
+            // Render target could be recreated in the middle of the frame, so image is destroyed after it
+            m_PooledImagesInUse.remove(image);
+            m_ReleasedPooledImages.addUnique(image);
+            return;
+        }
         image->clear();
         m_UnusedVulkanImages.addUnique(image);
     }
 
+    VulkanImage* RenderEngine_Vulkan::getPooledVulkanImage(const VulkanImageDescription& description)
+    {
+        jarray<PooledVulkanImage>* pooledImages = m_ImagePool.find(description);
+        if (pooledImages != nullptr)
+        {
+            for (int32 index = pooledImages->getSize() - 1; index >= 0; index--)
+            {
+                // Image released during current frame could still be used by it
+                const PooledVulkanImage& pooledImage = (*pooledImages)[index];
+                if (pooledImage.releaseFrameIndex < m_ImagePoolFrameIndex)
+                {
+                    VulkanImage* image = pooledImage.image;
+                    pooledImages->removeAt(index);
+                    m_PooledImagesInUse.add(image, description);
+                    m_ImagePoolStats.pooledImageCount--;
+                    m_ImagePoolStats.hitCount++;
+                    return image;
+                }
+            }
+        }
+
+        VulkanImage* image = getVulkanImage();
+        if (!image->init(description.usage, { VulkanQueueType::Graphics }, description.size, description.sampleCount, description.format, description.mipLevels) || 
+            !image->createImageView(description.aspectFlags) || !image->createAttachmentImageView(description.aspectFlags))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to create pooled vulkan image"));
+            returnVulkanImage(image);
+            return nullptr;
+        }
+        m_PooledImagesInUse.add(image, description);
+        m_ImagePoolStats.missCount++;
+        return image;
+    }
+    void RenderEngine_Vulkan::updateImagePool()
+    {
+        m_ImagePoolFrameIndex++;
+        for (const auto& image : m_ReleasedPooledImages)
+        {
+            image->clear();
+            m_UnusedVulkanImages.addUnique(image);
+        }
+        m_ReleasedPooledImages.clear();
+        for (auto& pooledImages : m_ImagePool)
+        {
+            for (int32 index = pooledImages.value.getSize() - 1; index >= 0; index--)
+            {
+                VulkanImage* image = pooledImages.value[index].image;
+                if ((m_ImagePoolFrameIndex - pooledImages.value[index].releaseFrameIndex) > ImagePoolMaxUnusedFrames)
+                {
+                    pooledImages.value.removeAt(index);
+                    image->clear();
+                    m_UnusedVulkanImages.addUnique(image);
+                    m_ImagePoolStats.pooledImageCount--;
+                    m_ImagePoolStats.agedOutCount++;
+                }
+            }
+        }
+    }
+
+    bool RenderEngine_Vulkan::beginUploadBatchInternal()
+    {
+        return m_UploadBatch->begin();
+    }
+    uint64 RenderEngine_Vulkan::endUploadBatchInternal()
+    {
+        return m_UploadBatch->submit();
+    }
+    bool RenderEngine_Vulkan::isUploadBatchFinished(const uint64 batchID)
+    {
+        return m_UploadBatch->isFinished(batchID);
+    }
+    void RenderEngine_Vulkan::waitForUploadBatch(const uint64 batchID)
+    {
+        m_UploadBatch->wait(batchID);
+    }
+
     VulkanRenderPass* RenderEngine_Vulkan::getRenderPass(const VulkanRenderPassDescription& description)
     {
-        if ((description.colorFormat == VK_FORMAT_UNDEFINED) || (description.shouldUseDepth && (description.depthFormat == VK_FORMAT_UNDEFINED)))
+        // Depth-only render pass is the one without color format
+        if ((description.isDepthOnly() && !description.shouldUseDepth) || (description.shouldUseDepth && (description.depthFormat == VK_FORMAT_UNDEFINED)))
         {
             return nullptr;
         }
@@ -608,6 +881,19 @@ namespace JumaRenderEngine
             case VertexComponentType::Vec2: attribute.format = VK_FORMAT_R32G32_SFLOAT; break;
             case VertexComponentType::Vec3: attribute.format = VK_FORMAT_R32G32B32_SFLOAT; break;
             case VertexComponentType::Vec4: attribute.format = VK_FORMAT_R32G32B32A32_SFLOAT; break;
+            case VertexComponentType::Half: attribute.format = VK_FORMAT_R16_SFLOAT; break;
+            case VertexComponentType::Half2: attribute.format = VK_FORMAT_R16G16_SFLOAT; break;
+            case VertexComponentType::Half4: attribute.format = VK_FORMAT_R16G16B16A16_SFLOAT; break;
+            case VertexComponentType::UByte2_Norm: attribute.format = VK_FORMAT_R8G8_UNORM; break;
+            case VertexComponentType::UByte4_Norm: attribute.format = VK_FORMAT_R8G8B8A8_UNORM; break;
+            case VertexComponentType::Byte2_Norm: attribute.format = VK_FORMAT_R8G8_SNORM; break;
+            case VertexComponentType::Byte4_Norm: attribute.format = VK_FORMAT_R8G8B8A8_SNORM; break;
+            case VertexComponentType::UShort2_Norm: attribute.format = VK_FORMAT_R16G16_UNORM; break;
+            case VertexComponentType::UShort4_Norm: attribute.format = VK_FORMAT_R16G16B16A16_UNORM; break;
+            case VertexComponentType::Short2_Norm: attribute.format = VK_FORMAT_R16G16_SNORM; break;
+            case VertexComponentType::Short4_Norm: attribute.format = VK_FORMAT_R16G16B16A16_SNORM; break;
+            case VertexComponentType::UInt_10_10_10_2_Norm: attribute.format = VK_FORMAT_A2B10G10R10_UNORM_PACK32; break;
+            case VertexComponentType::Int_10_10_10_2_Norm: attribute.format = VK_FORMAT_A2B10G10R10_SNORM_PACK32; break;
             default: continue;
             }
             attribute.location = componentDescriprion.shaderLocation;
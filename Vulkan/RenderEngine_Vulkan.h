@@ -14,12 +14,15 @@
 #include "renderEngine/texture/TextureSamplerType.h"
 #include "vulkanObjects/VulkanBuffer.h"
 #include "vulkanObjects/VulkanImage.h"
+#include "vulkanObjects/VulkanImageDescription.h"
 #include "vulkanObjects/VulkanQueueType.h"
 #include "vulkanObjects/VulkanRenderPass.h"
 
 namespace JumaRenderEngine
 {
     class VulkanCommandPool;
+    class VulkanStagingRing;
+    class VulkanUploadBatch;
 
     struct VulkanQueueDescription
     {
@@ -48,6 +51,9 @@ namespace JumaRenderEngine
         VkPhysicalDevice getPhysicalDevice() const { return m_PhysicalDevice; }
         VkDevice getDevice() const { return m_Device; }
         VmaAllocator getAllocator() const { return m_Allocator; }
+        bool isMultiDrawIndirectSupported() const { return m_MultiDrawIndirectSupported; }
+        // Render passes are replaced by vkCmdBeginRendering(), pipelines depend only on attachment formats
+        bool isDynamicRenderingEnabled() const { return m_DynamicRenderingEnabled; }
 
         const VulkanQueueDescription* getQueue(const VulkanQueueType type) const { return !m_QueueIndices.isEmpty() ? &m_Queues[m_QueueIndices[type]] : nullptr; }
         VulkanCommandPool* getCommandPool(const VulkanQueueType type) const { return !m_CommandPools.isEmpty() ? m_CommandPools[type] : nullptr; }
@@ -55,7 +61,24 @@ namespace JumaRenderEngine
         VulkanBuffer* getVulkanBuffer();
         VulkanImage* getVulkanImage();
         void returnVulkanBuffer(VulkanBuffer* buffer);
+        // Pooled images are kept alive with their views after return, until reused or aged out
         void returnVulkanImage(VulkanImage* image);
+
+        static constexpr uint64 ImagePoolMaxUnusedFrames = 120;
+        static constexpr uint32 ImagePoolMaxSize = 32;
+
+        // Initialized image with image view and attachment image view
+        VulkanImage* getPooledVulkanImage(const VulkanImageDescription& description);
+        const VulkanImagePoolStats& getImagePoolStats() const { return m_ImagePoolStats; }
+        // Called when previous frame is finished on GPU, so images released before it could be reused
+        void updateImagePool();
+
+        VulkanUploadBatch* getUploadBatch() const { return m_UploadBatch; }
+        // Not null only between beginUploadBatch() and endUploadBatch()
+        VulkanUploadBatch* getActiveUploadBatch() const { return isUploadBatchActive() ? m_UploadBatch : nullptr; }
+        virtual bool isUploadBatchFinished(uint64 batchID) override;
+        virtual void waitForUploadBatch(uint64 batchID) override;
+        VulkanStagingRing* getStagingRing() const { return m_StagingRing; }
         
         VulkanRenderPass* getRenderPass(const VulkanRenderPassDescription& description);
 
@@ -63,6 +86,9 @@ namespace JumaRenderEngine
 
         VkSampler getTextureSampler(TextureSamplerType samplerType);
 
+        virtual bool getGPUMemoryInfo(uint64& outUsage, uint64& outBudget) const override;
+        virtual uint8 getMaxColorAttachmentCount() const override;
+
     protected:
 
         virtual bool initInternal(const jmap<window_id, WindowProperties>& windows) override;
@@ -71,10 +97,18 @@ namespace JumaRenderEngine
         virtual WindowController* createWindowController() override;
         virtual VertexBuffer* createVertexBufferInternal() override;
         virtual Texture* createTextureInternal() override;
+        virtual TextureArray* createTextureArrayInternal() override;
         virtual Shader* createShaderInternal() override;
         virtual Material* createMaterialInternal() override;
         virtual RenderTarget* createRenderTargetInternal() override;
         virtual RenderPipeline* createRenderPipelineInternal() override;
+        virtual GeometryArena* createGeometryArenaInternal() override;
+
+        virtual bool isTextureFormatSupportedInternal(TextureFormat format) const override;
+        virtual bool isRenderTargetFormatSupportedInternal(TextureFormat format) const override;
+
+        virtual bool beginUploadBatchInternal() override;
+        virtual uint64 endUploadBatchInternal() override;
 
         virtual void onRegisteredVertexType(const jstringID& vertexName) override;
 
@@ -93,15 +127,33 @@ namespace JumaRenderEngine
         VkPhysicalDevice m_PhysicalDevice = nullptr;
         VkDevice m_Device = nullptr;
         VmaAllocator m_Allocator = nullptr;
+        bool m_MultiDrawIndirectSupported = false;
+        bool m_TextureCompressionBCEnabled = false;
+        bool m_TextureCompressionETC2Enabled = false;
+        bool m_DynamicRenderingEnabled = false;
 
         jmap<VulkanQueueType, int32> m_QueueIndices;
         jarray<VulkanQueueDescription> m_Queues;
         jmap<VulkanQueueType, VulkanCommandPool*> m_CommandPools;
+        VulkanUploadBatch* m_UploadBatch = nullptr;
+        VulkanStagingRing* m_StagingRing = nullptr;
 
         jlist<VulkanBuffer> m_VulkanBuffers;
         jlist<VulkanImage> m_VulkanImages;
         jarray<VulkanBuffer*> m_UnusedVulkanBuffers;
         jarray<VulkanImage*> m_UnusedVulkanImages;
+
+        struct PooledVulkanImage
+        {
+            VulkanImage* image = nullptr;
+            uint64 releaseFrameIndex = 0;
+        };
+        jmap<VulkanImageDescription, jarray<PooledVulkanImage>, VulkanImageDescription::predicate> m_ImagePool;
+        jmap<VulkanImage*, VulkanImageDescription> m_PooledImagesInUse;
+        // Released when pool is full, but could be used by current frame
+        jarray<VulkanImage*> m_ReleasedPooledImages;
+        uint64 m_ImagePoolFrameIndex = 0;
+        VulkanImagePoolStats m_ImagePoolStats;
         
         juid<render_pass_type_id> m_RenderPassTypeIDs;
         jmap<VulkanRenderPassDescription, render_pass_type_id, VulkanRenderPassDescription::compatible_predicate> m_RenderPassTypes;
@@ -120,6 +172,9 @@ namespace JumaRenderEngine
             jmap<VulkanQueueType, int32>& outQueueIndices, jarray<VulkanQueueDescription>& outQueues);
         bool createDevice();
         bool createCommandPools();
+        bool createUploadBatch();
+
+        bool isFormatFeatureSupported(TextureFormat format, VkFormatFeatureFlags features) const;
 
         void clearVulkan();
     };
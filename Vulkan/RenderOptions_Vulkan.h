@@ -10,6 +10,7 @@
 
 namespace JumaRenderEngine
 {
+    class GeometryArena_Vulkan;
     class VulkanCommandBuffer;
     class VulkanRenderPass;
 
@@ -17,6 +18,9 @@ namespace JumaRenderEngine
     {
         const VulkanRenderPass* renderPass = nullptr;
         VulkanCommandBuffer* commandBuffer = nullptr;
+
+        // Vertex and index buffers bound to the command buffer
+        mutable const GeometryArena_Vulkan* boundGeometryArena = nullptr;
     };
 }
 
@@ -4,13 +4,18 @@
 
 #if defined(JUMARENDERENGINE_INCLUDE_RENDER_API_VULKAN)
 
+#include "GeometryArena_Vulkan.h"
+#include "Material_Vulkan.h"
 #include "RenderEngine_Vulkan.h"
 #include "RenderOptions_Vulkan.h"
+#include "VertexBuffer_Vulkan.h"
 #include "renderEngine/RenderTarget.h"
 #include "renderEngine/window/Vulkan/WindowController_Vulkan.h"
 #include "vulkanObjects/VulkanCommandBuffer.h"
 #include "vulkanObjects/VulkanCommandPool.h"
+#include "vulkanObjects/VulkanStagingRing.h"
 #include "vulkanObjects/VulkanSwapchain.h"
+#include "vulkanObjects/VulkanUploadBatch.h"
 
 namespace JumaRenderEngine
 {
@@ -48,15 +53,48 @@ namespace JumaRenderEngine
             return false;
         }
 
+        VkPhysicalDeviceProperties deviceProperties;
+        vkGetPhysicalDeviceProperties(getRenderEngine<RenderEngine_Vulkan>()->getPhysicalDevice(), &deviceProperties);
+        if (deviceProperties.limits.timestampComputeAndGraphics == VK_TRUE)
+        {
+            VkQueryPoolCreateInfo queryPoolInfo{};
+            queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+            queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+            queryPoolInfo.queryCount = 2;
+            result = vkCreateQueryPool(device, &queryPoolInfo, nullptr, &m_TimestampQueryPool);
+            if (result != VK_SUCCESS)
+            {
+                JUMA_RENDER_ERROR_LOG(result, JSTR("Failed to create vulkan timestamp query pool, GPU frame time is not available"));
+                m_TimestampQueryPool = nullptr;
+            }
+            m_TimestampPeriod = deviceProperties.limits.timestampPeriod;
+        }
+
         return true;
     }
 
     void RenderPipeline_Vulkan::clearVulkan()
     {
-        VkDevice device = getRenderEngine<RenderEngine_Vulkan>()->getDevice();
+        RenderEngine_Vulkan* renderEngine = getRenderEngine<RenderEngine_Vulkan>();
+        VkDevice device = renderEngine->getDevice();
+
+        for (const auto& buffer : m_IndirectCommandBuffers)
+        {
+            renderEngine->returnVulkanBuffer(buffer);
+        }
+        m_IndirectCommandBuffers.clear();
+        m_IndirectCommandBufferIndex = 0;
+        m_IndirectCommandCount = 0;
 
         m_SwapchainImageReadySemaphores.clear();
         m_Swapchains.clear();
+        if (m_TimestampQueryPool != nullptr)
+        {
+            vkDestroyQueryPool(device, m_TimestampQueryPool, nullptr);
+            m_TimestampQueryPool = nullptr;
+        }
+        m_TimestampsWritten = false;
+        m_GPUFrameTime = -1.0f;
         if (m_RenderCommandBuffer != nullptr)
         {
             m_RenderCommandBuffer->returnToCommandPool();
@@ -88,6 +126,8 @@ namespace JumaRenderEngine
 
         // Wait for prev render frame finished
         waitForPreviousRenderFinish();
+        m_IndirectCommandBufferIndex = 0;
+        m_IndirectCommandCount = 0;
 
         // Acquire next swapchain images
         const WindowController* windowController = getRenderEngine()->getWindowController();
@@ -130,18 +170,152 @@ namespace JumaRenderEngine
         waitForPreviousRenderFinish();
     }
 
+    bool RenderPipeline_Vulkan::getGPUFrameTime(float& outMilliseconds) const
+    {
+        if (m_GPUFrameTime < 0.0f)
+        {
+            return false;
+        }
+        outMilliseconds = m_GPUFrameTime;
+        return true;
+    }
+
+    void RenderPipeline_Vulkan::renderPrimitiveBatch(const RenderOptions* renderOptions, const RenderPrimitiveBatch& batch)
+    {
+        jarray<VkDrawIndexedIndirectCommand> commands;
+        commands.reserve(batch.vertexBuffers.getSize());
+        for (const auto& vertexBuffer : batch.vertexBuffers)
+        {
+            const GeometryArenaAllocation* allocation = vertexBuffer->getGeometryAllocation();
+            VkDrawIndexedIndirectCommand& command = commands.addDefault();
+            command.indexCount = allocation->indexCount;
+            command.instanceCount = 1;
+            command.firstIndex = allocation->firstIndex;
+            command.vertexOffset = static_cast<int32>(allocation->firstVertex);
+            command.firstInstance = 0;
+        }
+
+        uint32 indirectOffset = 0;
+        const VulkanBuffer* indirectBuffer = writeIndirectCommands(commands, indirectOffset);
+        if (indirectBuffer == nullptr)
+        {
+            JUMA_RENDER_LOG(warning, JSTR("Failed to write indirect draw commands, drawing primitives one by one"));
+            Super::renderPrimitiveBatch(renderOptions, batch);
+            return;
+        }
+
+        // All vertex buffers of the batch have the same vertex type, so any of them could be used for pipeline
+        VertexBuffer_Vulkan* vertexBuffer = dynamic_cast<VertexBuffer_Vulkan*>(batch.vertexBuffers[0]);
+        Material_Vulkan* material = dynamic_cast<Material_Vulkan*>(batch.material);
+        if (!material->bindMaterial(renderOptions, vertexBuffer))
+        {
+            return;
+        }
+
+        const RenderOptions_Vulkan* optionsVulkan = reinterpret_cast<const RenderOptions_Vulkan*>(renderOptions);
+        dynamic_cast<const GeometryArena_Vulkan*>(batch.geometryArena)->bindBuffers(optionsVulkan);
+
+        VkCommandBuffer commandBuffer = optionsVulkan->commandBuffer->get();
+        constexpr uint32 commandSize = sizeof(VkDrawIndexedIndirectCommand);
+        const uint32 commandCount = static_cast<uint32>(commands.getSize());
+        if (getRenderEngine<RenderEngine_Vulkan>()->isMultiDrawIndirectSupported())
+        {
+            vkCmdDrawIndexedIndirect(commandBuffer, indirectBuffer->get(), indirectOffset, commandCount, commandSize);
+        }
+        else
+        {
+            for (uint32 commandIndex = 0; commandIndex < commandCount; commandIndex++)
+            {
+                vkCmdDrawIndexedIndirect(commandBuffer, indirectBuffer->get(), indirectOffset + commandIndex * commandSize, 1, commandSize);
+            }
+        }
+
+        material->unbindMaterial(renderOptions, vertexBuffer);
+    }
+    VulkanBuffer* RenderPipeline_Vulkan::writeIndirectCommands(const jarray<VkDrawIndexedIndirectCommand>& commands, uint32& outOffset)
+    {
+        constexpr uint32 commandSize = sizeof(VkDrawIndexedIndirectCommand);
+        const uint32 commandCount = static_cast<uint32>(commands.getSize());
+        if (m_IndirectCommandBuffers.isValidIndex(m_IndirectCommandBufferIndex))
+        {
+            const uint32 bufferCapacity = m_IndirectCommandBuffers[m_IndirectCommandBufferIndex]->getSize() / commandSize;
+            if ((m_IndirectCommandCount + commandCount) > bufferCapacity)
+            {
+                m_IndirectCommandBufferIndex++;
+                m_IndirectCommandCount = 0;
+            }
+        }
+
+        // Buffers after current one are not used in this frame, so too small one could be replaced
+        RenderEngine_Vulkan* renderEngine = getRenderEngine<RenderEngine_Vulkan>();
+        VulkanBuffer* buffer = m_IndirectCommandBuffers.isValidIndex(m_IndirectCommandBufferIndex) ? m_IndirectCommandBuffers[m_IndirectCommandBufferIndex] : nullptr;
+        if ((buffer == nullptr) || ((buffer->getSize() / commandSize) < commandCount))
+        {
+            VulkanBuffer* newBuffer = renderEngine->getVulkanBuffer();
+            if (!newBuffer->initMapped(VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, { VulkanQueueType::Graphics }, 
+                math::max(commandCount, IndirectCommandBufferCapacity) * commandSize))
+            {
+                JUMA_RENDER_LOG(error, JSTR("Failed to create indirect command buffer"));
+                renderEngine->returnVulkanBuffer(newBuffer);
+                return nullptr;
+            }
+
+            if (buffer != nullptr)
+            {
+                renderEngine->returnVulkanBuffer(buffer);
+                m_IndirectCommandBuffers[m_IndirectCommandBufferIndex] = newBuffer;
+            }
+            else
+            {
+                m_IndirectCommandBufferIndex = m_IndirectCommandBuffers.getSize();
+                m_IndirectCommandBuffers.add(newBuffer);
+            }
+            buffer = newBuffer;
+        }
+
+        const uint32 offset = m_IndirectCommandCount * commandSize;
+        if (!buffer->setMappedData(commands.getData(), commandCount * commandSize, offset) || !buffer->flushMappedData(false))
+        {
+            return nullptr;
+        }
+        m_IndirectCommandCount += commandCount;
+        outOffset = offset;
+        return buffer;
+    }
+
     void RenderPipeline_Vulkan::waitForPreviousRenderFinish()
     {
         if (m_RenderCommandBuffer != nullptr)
         {
-            vkWaitForFences(getRenderEngine<RenderEngine_Vulkan>()->getDevice(), 1, &m_RenderFinishedFence, VK_TRUE, UINT64_MAX);
+            VkDevice device = getRenderEngine<RenderEngine_Vulkan>()->getDevice();
+            vkWaitForFences(device, 1, &m_RenderFinishedFence, VK_TRUE, UINT64_MAX);
             m_RenderCommandBuffer->returnToCommandPool();
             m_RenderCommandBuffer = nullptr;
+
+            if (m_TimestampsWritten)
+            {
+                // Frame is finished, so results are available without waiting
+                uint64 timestamps[2];
+                const VkResult result = vkGetQueryPoolResults(device, m_TimestampQueryPool, 0, 2, sizeof(timestamps), timestamps, sizeof(uint64), VK_QUERY_RESULT_64_BIT);
+                if ((result == VK_SUCCESS) && (timestamps[1] >= timestamps[0]))
+                {
+                    m_GPUFrameTime = static_cast<float>(static_cast<double>(timestamps[1] - timestamps[0]) * m_TimestampPeriod / 1000000.0);
+                }
+                else
+                {
+                    // Don't report time of the previous frame again
+                    m_GPUFrameTime = -1.0f;
+                }
+                m_TimestampsWritten = false;
+            }
         }
+        getRenderEngine<RenderEngine_Vulkan>()->getStagingRing()->onFrameFinished();
+        getRenderEngine<RenderEngine_Vulkan>()->updateImagePool();
     }
     bool RenderPipeline_Vulkan::startRecordingRenderCommandBuffer(RenderOptions* renderOptions)
     {
-        VulkanCommandBuffer* commandBuffer = getRenderEngine<RenderEngine_Vulkan>()->getCommandPool(VulkanQueueType::Graphics)->getCommandBuffer();
+        RenderEngine_Vulkan* renderEngine = getRenderEngine<RenderEngine_Vulkan>();
+        VulkanCommandBuffer* commandBuffer = renderEngine->getCommandPool(VulkanQueueType::Graphics)->getCommandBuffer();
         if (commandBuffer == nullptr)
         {
             JUMA_RENDER_LOG(error, JSTR("Failed to create render command buffer"));
@@ -160,12 +334,30 @@ namespace JumaRenderEngine
             return false;
         }
 
+        if (m_TimestampQueryPool != nullptr)
+        {
+            vkCmdResetQueryPool(commandBuffer->get(), m_TimestampQueryPool, 0, 2);
+            // Swapchain image ready semaphores are waited at color attachment output stage, so writing
+            // start timestamp at the same stage excludes time spent waiting for the image (vsync)
+            vkCmdWriteTimestamp(commandBuffer->get(), VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, m_TimestampQueryPool, 0);
+        }
+
+        // Texture region updates are applied before any render pass of the frame
+        renderEngine->getStagingRing()->recordCopies(commandBuffer->get());
+
         reinterpret_cast<RenderOptions_Vulkan*>(renderOptions)->commandBuffer = commandBuffer;
         return true;
     }
     bool RenderPipeline_Vulkan::finishRecordingRenderCommandBuffer(RenderOptions* renderOptions)
     {
+        RenderEngine_Vulkan* renderEngine = getRenderEngine<RenderEngine_Vulkan>();
+        renderEngine->getStagingRing()->onFrameRecorded();
+
         VulkanCommandBuffer* commandBuffer = reinterpret_cast<RenderOptions_Vulkan*>(renderOptions)->commandBuffer;
+        if (m_TimestampQueryPool != nullptr)
+        {
+            vkCmdWriteTimestamp(commandBuffer->get(), VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_TimestampQueryPool, 1);
+        }
         const VkResult result = vkEndCommandBuffer(commandBuffer->get());
         if (result != VK_SUCCESS)
         {
@@ -174,14 +366,28 @@ namespace JumaRenderEngine
             return false;
         }
 
-        RenderEngine_Vulkan* renderEngine = getRenderEngine<RenderEngine_Vulkan>();
         vkResetFences(renderEngine->getDevice(), 1, &m_RenderFinishedFence);
 
-        const jarray<VkPipelineStageFlags> waitStages(m_SwapchainImageReadySemaphores.getSize(), VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+        jarray<VkSemaphore> waitSemaphores = m_SwapchainImageReadySemaphores;
+        jarray<VkPipelineStageFlags> waitStages(m_SwapchainImageReadySemaphores.getSize(), VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+        // Values are ignored for binary semaphores
+        jarray<uint64> waitValues(m_SwapchainImageReadySemaphores.getSize(), 0);
+        const VulkanUploadBatch* uploadBatch = renderEngine->getUploadBatch();
+        if (uploadBatch->getLastSubmittedValue() > 0)
+        {
+            waitSemaphores.add(uploadBatch->getSemaphore());
+            waitStages.add(VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+            waitValues.add(uploadBatch->getLastSubmittedValue());
+        }
+        VkTimelineSemaphoreSubmitInfo timelineInfo{};
+        timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timelineInfo.waitSemaphoreValueCount = static_cast<uint32>(waitValues.getSize());
+        timelineInfo.pWaitSemaphoreValues = waitValues.getData();
         VkSubmitInfo submitInfo{};
         submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submitInfo.waitSemaphoreCount = m_SwapchainImageReadySemaphores.getSize();
-        submitInfo.pWaitSemaphores = m_SwapchainImageReadySemaphores.getData();
+        submitInfo.pNext = &timelineInfo;
+        submitInfo.waitSemaphoreCount = waitSemaphores.getSize();
+        submitInfo.pWaitSemaphores = waitSemaphores.getData();
         submitInfo.pWaitDstStageMask = waitStages.getData();
         submitInfo.signalSemaphoreCount = 1;
         submitInfo.pSignalSemaphores = &m_RenderFinishedSemaphore;
@@ -192,6 +398,7 @@ namespace JumaRenderEngine
             return false;
         }
         m_RenderCommandBuffer = commandBuffer;
+        m_TimestampsWritten = m_TimestampQueryPool != nullptr;
 
         if (!m_Swapchains.isEmpty())
         {
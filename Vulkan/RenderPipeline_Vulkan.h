@@ -12,6 +12,7 @@
 
 namespace JumaRenderEngine
 {
+    class VulkanBuffer;
     class VulkanCommandBuffer;
     class VulkanSwapchain;
 
@@ -25,6 +26,8 @@ namespace JumaRenderEngine
 
         virtual void waitForRenderFinished() override;
 
+        virtual bool getGPUFrameTime(float& outMilliseconds) const override;
+
     protected:
 
         virtual bool initInternal() override;
@@ -34,14 +37,29 @@ namespace JumaRenderEngine
         virtual bool onStartRender(RenderOptions* renderOptions) override;
         virtual void onFinishRender(RenderOptions* renderOptions) override;
 
+        virtual void renderPrimitiveBatch(const RenderOptions* renderOptions, const RenderPrimitiveBatch& batch) override;
+
     private:
 
+        static constexpr uint32 IndirectCommandBufferCapacity = 4096;
+
         VkFence m_RenderFinishedFence = nullptr;
         VkSemaphore m_RenderFinishedSemaphore = nullptr;
 
         VulkanCommandBuffer* m_RenderCommandBuffer = nullptr;
         jarray<VulkanSwapchain*> m_Swapchains;
         jarray<VkSemaphore> m_SwapchainImageReadySemaphores;
+
+        // Filled during frame recording, reused after the frame is finished
+        jarray<VulkanBuffer*> m_IndirectCommandBuffers;
+        int32 m_IndirectCommandBufferIndex = 0;
+        uint32 m_IndirectCommandCount = 0;
+
+        // Timestamps at the start and at the end of the frame command buffer
+        VkQueryPool m_TimestampQueryPool = nullptr;
+        float m_TimestampPeriod = 0.0f;
+        bool m_TimestampsWritten = false;
+        float m_GPUFrameTime = -1.0f;
         
 
         void clearVulkan();
@@ -49,6 +67,8 @@ namespace JumaRenderEngine
         void waitForPreviousRenderFinish();
         bool startRecordingRenderCommandBuffer(RenderOptions* renderOptions);
         bool finishRecordingRenderCommandBuffer(RenderOptions* renderOptions);
+
+        VulkanBuffer* writeIndirectCommands(const jarray<VkDrawIndexedIndirectCommand>& commands, uint32& outOffset);
     };
 }
 
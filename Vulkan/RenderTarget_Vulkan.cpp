@@ -54,8 +54,21 @@ namespace JumaRenderEngine
     bool RenderTarget_Vulkan::createFramebuffers()
     {
         VulkanRenderPassDescription renderPassDescription;
-        renderPassDescription.colorFormat = GetVulkanFormatByTextureFormat(getFormat());
-        renderPassDescription.depthFormat = VK_FORMAT_D24_UNORM_S8_UINT;
+        if (isDepthOnly())
+        {
+            renderPassDescription.colorFormat = VK_FORMAT_UNDEFINED;
+            renderPassDescription.depthFormat = GetVulkanFormatByTextureFormat(getFormat());
+            renderPassDescription.depthStoreOp = VK_ATTACHMENT_STORE_OP_STORE;
+        }
+        else
+        {
+            renderPassDescription.colorFormat = GetVulkanFormatByTextureFormat(getFormat());
+            renderPassDescription.depthFormat = VK_FORMAT_D24_UNORM_S8_UINT;
+            for (uint8 attachmentIndex = 1; attachmentIndex < getColorAttachmentCount(); attachmentIndex++)
+            {
+                renderPassDescription.additionalColorFormats[attachmentIndex - 1] = GetVulkanFormatByTextureFormat(getColorAttachmentFormat(attachmentIndex));
+            }
+        }
         renderPassDescription.sampleCount = GetVulkanSampleCountByTextureSamples(getSampleCount());
         renderPassDescription.shouldUseDepth = true;
         renderPassDescription.renderToSwapchain = false;
@@ -66,8 +79,10 @@ namespace JumaRenderEngine
             return false;
         }
 
+        // Mips are generated in the attachment itself, so they are allocated only when sampler uses them
+        const uint32 resultMipLevels = shouldResultImageHaveMips() ? GetMipLevelCountByTextureSize(getSize()) : 1;
         VulkanFramebufferData framebufferData;
-        if (!m_RenderPass->createVulkanFramebuffer(getSize(), framebufferData))
+        if (!m_RenderPass->createVulkanFramebuffer(getSize(), resultMipLevels, framebufferData))
         {
             JUMA_RENDER_LOG(error, JSTR("Failed to create vulkan framebuffer"));
             return false;
@@ -144,22 +159,52 @@ namespace JumaRenderEngine
                 renderEngine->returnVulkanImage(framebuffer.colorAttachment);
                 renderEngine->returnVulkanImage(framebuffer.depthAttachment);
                 renderEngine->returnVulkanImage(framebuffer.resolveAttachment);
-                renderEngine->returnVulkanImage(framebuffer.resultImage);
+                for (const auto& image : framebuffer.additionalColorAttachments)
+                {
+                    renderEngine->returnVulkanImage(image);
+                }
             }
             m_Framebuffers.clear();
+            m_FramebuffersVersion++;
         }
         m_RenderPass = nullptr;
         m_FramebuffersValidForRender = false;
     }
 
-    VulkanImage* RenderTarget_Vulkan::getResultImage() const
+    VulkanImage* RenderTarget_Vulkan::getResultImage(const uint8 attachmentIndex) const
     {
         if (!isWindowRenderTarget() && !m_Framebuffers.isEmpty())
         {
-            return m_Framebuffers[0].resultImage;
+            const VulkanFramebufferData& framebuffer = m_Framebuffers[0];
+            if (attachmentIndex > 0)
+            {
+                return framebuffer.additionalColorAttachments.isValidIndex(attachmentIndex - 1) ? framebuffer.additionalColorAttachments[attachmentIndex - 1] : nullptr;
+            }
+            if (isDepthOnly())
+            {
+                return framebuffer.depthAttachment;
+            }
+            return framebuffer.resolveAttachment != nullptr ? framebuffer.resolveAttachment : framebuffer.colorAttachment;
         }
         return nullptr;
     }
+    bool RenderTarget_Vulkan::shouldResultImageHaveMips() const
+    {
+        // Mips are generated by blit, which is not used for depth
+        return !isDepthOnly() && IsTextureFilterTypeUsingMips(getSamplerType().filterType);
+    }
+    RenderTargetMemoryInfo RenderTarget_Vulkan::getMemoryInfo() const
+    {
+        RenderTargetMemoryInfo memoryInfo = Super::getMemoryInfo();
+        if (!m_Framebuffers.isEmpty())
+        {
+            const VulkanFramebufferData& framebuffer = m_Framebuffers[0];
+            const bool colorTransient = framebuffer.resolveAttachment != nullptr;
+            memoryInfo.transientMemoryLazilyAllocated = (!colorTransient || framebuffer.colorAttachment->isLazilyAllocated()) 
+                && ((framebuffer.depthAttachment == nullptr) || framebuffer.depthAttachment->isLazilyAllocated());
+        }
+        return memoryInfo;
+    }
     int32 RenderTarget_Vulkan::getRequiredFramebufferIndex() const
     {
         if (m_Framebuffers.isEmpty())
@@ -187,6 +232,13 @@ namespace JumaRenderEngine
 
     bool RenderTarget_Vulkan::onStartRender(RenderOptions* renderOptions)
     {
+        if (!isWindowRenderTarget() && !m_Framebuffers.isEmpty())
+        {
+            if (shouldResultImageHaveMips() != (getResultImage()->getMipLevels() > 1))
+            {
+                invalidate();
+            }
+        }
         if (!Super::onStartRender(renderOptions))
         {
             return false;
@@ -198,8 +250,28 @@ namespace JumaRenderEngine
             return false;
         }
 
+        // Render passes with different load and store operations are compatible with the same framebuffer,
+        // dynamic rendering gets operations directly
+        const RenderTargetOperations& operations = GetRenderTargetOperations(renderOptions);
+        const VulkanRenderPass* renderPass = m_RenderPass;
+        if (!m_RenderPass->isDynamicRendering())
+        {
+            VulkanRenderPassDescription renderPassDescription = m_RenderPass->getDescription();
+            renderPassDescription.colorLoadOp = GetVulkanAttachmentLoadOp(operations.colorLoadOperation);
+            renderPassDescription.colorStoreOp = GetVulkanAttachmentStoreOp(operations.colorStoreOperation);
+            renderPassDescription.depthLoadOp = GetVulkanAttachmentLoadOp(operations.depthLoadOperation);
+            // Depth is the result of depth-only render target, so it's always stored
+            renderPassDescription.depthStoreOp = isDepthOnly() ? VK_ATTACHMENT_STORE_OP_STORE : GetVulkanAttachmentStoreOp(operations.depthStoreOperation);
+            renderPass = getRenderEngine<RenderEngine_Vulkan>()->getRenderPass(renderPassDescription);
+            if (renderPass == nullptr)
+            {
+                JUMA_RENDER_LOG(error, JSTR("Failed to get vulkan render pass"));
+                return false;
+            }
+        }
+
         RenderOptions_Vulkan* renderOptionsVulkan = reinterpret_cast<RenderOptions_Vulkan*>(renderOptions);
-        renderOptionsVulkan->renderPass = m_RenderPass;
+        renderOptionsVulkan->renderPass = renderPass;
 
         const VulkanFramebufferData& framebuffer = m_Framebuffers[framebufferIndex];
         VkCommandBuffer commandBuffer = renderOptionsVulkan->commandBuffer->get();
@@ -207,30 +279,66 @@ namespace JumaRenderEngine
         {
             if (!isWindowRenderTarget())
             {
-                VulkanImage* resutAttachmentImage = framebuffer.resolveAttachment != nullptr ? framebuffer.resolveAttachment : framebuffer.colorAttachment;
-                resutAttachmentImage->changeImageLayout(commandBuffer,
-                    VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-                    VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
-                framebuffer.resultImage->changeImageLayout(commandBuffer, 
+                // Render pass leaves result in this layout, so every mip level should be in it from the start
+                getResultImage()->changeImageLayout(commandBuffer,
                     VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
                     VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+                for (const auto& image : framebuffer.additionalColorAttachments)
+                {
+                    image->changeImageLayout(commandBuffer,
+                        VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+                }
+            }
+            // Depth could be loaded by render pass, so it should be in attachment layout
+            for (const auto& framebufferData : m_Framebuffers)
+            {
+                if ((framebufferData.depthAttachment != nullptr) && !isDepthOnly())
+                {
+                    framebufferData.depthAttachment->changeImageLayout(commandBuffer,
+                        VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, 
+                        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT);
+                }
             }
             m_FramebuffersValidForRender = true;
         }
 
-        const math::uvector2 size = getSize();
-        VkClearValue clearValues[2];
-        clearValues[0].color = { { 1.0f, 1.0f, 1.0f, 1.0f } };
-        clearValues[1].depthStencil = { 1.0f, 0 };
-        VkRenderPassBeginInfo renderPassInfo{};
-        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-        renderPassInfo.renderPass = m_RenderPass->get();
-        renderPassInfo.framebuffer = framebuffer.framebuffer;
-        renderPassInfo.renderArea.offset = { 0, 0 };
-        renderPassInfo.renderArea.extent = { size.x, size.y };
-        renderPassInfo.clearValueCount = 2;
-        renderPassInfo.pClearValues = clearValues;
-        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+        const math::uvector2 size = getRenderSize();
+        if (renderPass->isDynamicRendering())
+        {
+            beginDynamicRendering(commandBuffer, framebuffer, operations);
+        }
+        else
+        {
+            // Additional color attachments are placed after depth attachment
+            VkClearValue clearValues[2 + VulkanRenderPassDescription::MaxAdditionalColorAttachmentCount];
+            uint32 clearValueCount;
+            if (isDepthOnly())
+            {
+                clearValues[0].depthStencil = { operations.clearDepth, operations.clearStencil };
+                clearValueCount = 1;
+            }
+            else
+            {
+                clearValues[0].color = { { operations.clearColor.x, operations.clearColor.y, operations.clearColor.z, operations.clearColor.w } };
+                clearValues[1].depthStencil = { operations.clearDepth, operations.clearStencil };
+                clearValueCount = 2;
+                for (int32 index = 0; index < framebuffer.additionalColorAttachments.getSize(); index++)
+                {
+                    clearValues[clearValueCount++].color = clearValues[0].color;
+                }
+            }
+            VkRenderPassBeginInfo renderPassInfo{};
+            renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+            renderPassInfo.renderPass = renderPass->get();
+            renderPassInfo.framebuffer = framebuffer.framebuffer;
+            renderPassInfo.renderArea.offset = { 0, 0 };
+            renderPassInfo.renderArea.extent = { size.x, size.y };
+            renderPassInfo.clearValueCount = clearValueCount;
+            renderPassInfo.pClearValues = clearValues;
+            vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+        }
 
         VkViewport viewport;
         viewport.x = 0.0f;
@@ -246,33 +354,159 @@ namespace JumaRenderEngine
         vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
         return true;
     }
+    void RenderTarget_Vulkan::beginDynamicRendering(VkCommandBuffer commandBuffer, const VulkanFramebufferData& framebuffer, 
+        const RenderTargetOperations& operations) const
+    {
+        // Offscreen results are left for sampling between renders, so they are loaded from this layout
+        const bool loadColor = operations.colorLoadOperation == RenderTargetLoadOperation::Load;
+        const VkImageLayout colorOldLayout = loadColor && !isWindowRenderTarget() ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+        constexpr VkPipelineStageFlags colorSrcStages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        const VkAccessFlags colorDstAccess = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | (loadColor ? VK_ACCESS_COLOR_ATTACHMENT_READ_BIT : 0);
+
+        VkRenderingAttachmentInfo colorAttachments[1 + VulkanRenderPassDescription::MaxAdditionalColorAttachmentCount];
+        uint32 colorAttachmentCount = 0;
+        if (!isDepthOnly())
+        {
+            // Multisampled attachment is only resolved, so it never leaves tile memory
+            const bool multisampled = framebuffer.resolveAttachment != nullptr;
+            framebuffer.colorAttachment->changeImageLayout(commandBuffer,
+                multisampled ? VK_IMAGE_LAYOUT_UNDEFINED : colorOldLayout, 0, colorSrcStages,
+                VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, colorDstAccess, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+            VkRenderingAttachmentInfo& colorAttachment = colorAttachments[colorAttachmentCount++];
+            colorAttachment = {};
+            colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+            colorAttachment.imageView = framebuffer.colorAttachment->getAttachmentImageView();
+            colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            colorAttachment.loadOp = GetVulkanAttachmentLoadOp(operations.colorLoadOperation);
+            colorAttachment.storeOp = multisampled ? VK_ATTACHMENT_STORE_OP_DONT_CARE : GetVulkanAttachmentStoreOp(operations.colorStoreOperation);
+            colorAttachment.clearValue.color = { { operations.clearColor.x, operations.clearColor.y, operations.clearColor.z, operations.clearColor.w } };
+            if (multisampled)
+            {
+                framebuffer.resolveAttachment->changeImageLayout(commandBuffer,
+                    VK_IMAGE_LAYOUT_UNDEFINED, 0, colorSrcStages,
+                    VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+                colorAttachment.resolveMode = VK_RESOLVE_MODE_AVERAGE_BIT;
+                colorAttachment.resolveImageView = framebuffer.resolveAttachment->getAttachmentImageView();
+                colorAttachment.resolveImageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            }
+            for (const auto& image : framebuffer.additionalColorAttachments)
+            {
+                image->changeImageLayout(commandBuffer,
+                    colorOldLayout, 0, colorSrcStages,
+                    VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, colorDstAccess, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+                VkRenderingAttachmentInfo& additionalColorAttachment = colorAttachments[colorAttachmentCount++];
+                additionalColorAttachment = colorAttachment;
+                additionalColorAttachment.imageView = image->getAttachmentImageView();
+            }
+        }
+
+        VkRenderingAttachmentInfo depthAttachment{};
+        if (framebuffer.depthAttachment != nullptr)
+        {
+            if (isDepthOnly())
+            {
+                const bool loadDepth = operations.depthLoadOperation == RenderTargetLoadOperation::Load;
+                framebuffer.depthAttachment->changeImageLayout(commandBuffer,
+                    loadDepth ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                    VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                    VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT);
+            }
+            else
+            {
+                // Depth always stays in attachment layout, only previous writes have to be finished
+                framebuffer.depthAttachment->changeImageLayout(commandBuffer,
+                    VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                    VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                    VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT);
+            }
+            depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+            depthAttachment.imageView = framebuffer.depthAttachment->getImageView();
+            depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+            depthAttachment.loadOp = GetVulkanAttachmentLoadOp(operations.depthLoadOperation);
+            // Depth is the result of depth-only render target, so it's always stored
+            depthAttachment.storeOp = isDepthOnly() ? VK_ATTACHMENT_STORE_OP_STORE : GetVulkanAttachmentStoreOp(operations.depthStoreOperation);
+            depthAttachment.clearValue.depthStencil = { operations.clearDepth, operations.clearStencil };
+        }
+
+        const math::uvector2 size = getRenderSize();
+        VkRenderingInfo renderingInfo{};
+        renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+        renderingInfo.renderArea.offset = { 0, 0 };
+        renderingInfo.renderArea.extent = { size.x, size.y };
+        renderingInfo.layerCount = 1;
+        renderingInfo.colorAttachmentCount = colorAttachmentCount;
+        renderingInfo.pColorAttachments = colorAttachments;
+        renderingInfo.pDepthAttachment = framebuffer.depthAttachment != nullptr ? &depthAttachment : nullptr;
+        renderingInfo.pStencilAttachment = (framebuffer.depthAttachment != nullptr) && m_RenderPass->getDescription().hasStencil() ? &depthAttachment : nullptr;
+        vkCmdBeginRendering(commandBuffer, &renderingInfo);
+    }
+    void RenderTarget_Vulkan::endDynamicRendering(VkCommandBuffer commandBuffer, const VulkanFramebufferData& framebuffer) const
+    {
+        vkCmdEndRendering(commandBuffer);
+
+        if (isDepthOnly())
+        {
+            framebuffer.depthAttachment->changeImageLayout(commandBuffer,
+                VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+            return;
+        }
+
+        VulkanImage* resultImage = framebuffer.resolveAttachment != nullptr ? framebuffer.resolveAttachment : framebuffer.colorAttachment;
+        if (isWindowRenderTarget())
+        {
+            resultImage->changeImageLayout(commandBuffer,
+                VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, 0, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+            return;
+        }
+        // Result is sampled right after the render, without copy into separate image
+        resultImage->changeImageLayout(commandBuffer,
+            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT, 
+            VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT);
+        for (const auto& image : framebuffer.additionalColorAttachments)
+        {
+            image->changeImageLayout(commandBuffer,
+                VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+        }
+    }
+
     void RenderTarget_Vulkan::onFinishRender(RenderOptions* renderOptions)
     {
         VkCommandBuffer commandBuffer = reinterpret_cast<RenderOptions_Vulkan*>(renderOptions)->commandBuffer->get();
-        vkCmdEndRenderPass(commandBuffer);
-
-        if (!isWindowRenderTarget())
+        const int32 framebufferIndex = getRequiredFramebufferIndex();
+        if (m_RenderPass->isDynamicRendering() && m_Framebuffers.isValidIndex(framebufferIndex))
         {
-            const VulkanFramebufferData& framebuffer = m_Framebuffers[0];
-            VulkanImage* resultAttachment = framebuffer.resolveAttachment != nullptr ? framebuffer.resolveAttachment : framebuffer.colorAttachment;
+            endDynamicRendering(commandBuffer, m_Framebuffers[framebufferIndex]);
+        }
+        else
+        {
+            vkCmdEndRenderPass(commandBuffer);
+        }
 
-            resultAttachment->changeImageLayout(commandBuffer,
-                VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_ACCESS_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT
-            );
-            framebuffer.resultImage->changeImageLayout(commandBuffer,
-                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT
+        // Render pass already left result image ready for sampling, only mips have to be updated
+        VulkanImage* resultImage = getResultImage();
+        const bool shouldGenerateMips = (resultImage != nullptr) && (resultImage->getMipLevels() > 1) 
+            && (GetRenderTargetOperations(renderOptions).colorStoreOperation == RenderTargetStoreOperation::Store);
+        if (shouldGenerateMips)
+        {
+            resultImage->changeImageLayout(commandBuffer,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT
             );
-            framebuffer.resultImage->copyImage(commandBuffer, resultAttachment, 0, 0,
-                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
-            resultAttachment->changeImageLayout(commandBuffer,
-                VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_ACCESS_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
+            // Texels outside of the render area are left from previous frames, so they shouldn't get into mips
+            resultImage->generateMipmaps(commandBuffer, getRenderSize(),
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
             );
         }
 
         Super::onFinishRender(renderOptions);
+        if (shouldGenerateMips)
+        {
+            onMipsUpdated();
+        }
     }
 }
 
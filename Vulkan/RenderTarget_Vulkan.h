@@ -15,6 +15,7 @@ namespace JumaRenderEngine
 {
     class VulkanSwapchain;
     class VulkanRenderPass;
+    struct RenderTargetOperations;
 
     class RenderTarget_Vulkan final : public RenderTarget
     {
@@ -24,7 +25,11 @@ namespace JumaRenderEngine
         RenderTarget_Vulkan() = default;
         virtual ~RenderTarget_Vulkan() override;
 
-        VulkanImage* getResultImage() const;
+        VulkanImage* getResultImage(uint8 attachmentIndex = 0) const;
+        // Changed every time when framebuffer images are released, so materials know that their descriptors are outdated
+        uint32 getFramebuffersVersion() const { return m_FramebuffersVersion; }
+
+        virtual RenderTargetMemoryInfo getMemoryInfo() const override;
 
         virtual bool onStartRender(RenderOptions* renderOptions) override;
         virtual void onFinishRender(RenderOptions* renderOptions) override;
@@ -40,6 +45,7 @@ namespace JumaRenderEngine
         VulkanRenderPass* m_RenderPass = nullptr;
         jarray<VulkanFramebufferData> m_Framebuffers;
         bool m_FramebuffersValidForRender = false;
+        uint32 m_FramebuffersVersion = 0;
 
 
         bool initRenderTarget() { return createFramebuffers(); }
@@ -52,6 +58,11 @@ namespace JumaRenderEngine
 
         int32 getRequiredFramebufferIndex() const;
 
+        // Layouts are changed by barriers instead of render pass
+        void beginDynamicRendering(VkCommandBuffer commandBuffer, const VulkanFramebufferData& framebuffer, const RenderTargetOperations& operations) const;
+        void endDynamicRendering(VkCommandBuffer commandBuffer, const VulkanFramebufferData& framebuffer) const;
+        bool shouldResultImageHaveMips() const;
+
         void onSwapchainRecreated(VulkanSwapchain* swapchain);
     };
 }
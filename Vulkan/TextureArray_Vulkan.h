@@ -0,0 +1,36 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#pragma once
+
+#include "renderEngine/juma_render_engine_core.h"
+
+#if defined(JUMARENDERENGINE_INCLUDE_RENDER_API_VULKAN)
+
+#include "renderEngine/TextureArray.h"
+
+namespace JumaRenderEngine
+{
+    class VulkanImage;
+
+    class TextureArray_Vulkan final : public TextureArray
+    {
+    public:
+        TextureArray_Vulkan() = default;
+        virtual ~TextureArray_Vulkan() override;
+
+        VulkanImage* getVulkanImage() const { return m_Image; }
+
+    protected:
+
+        virtual bool initInternal(const math::uvector2& size, TextureFormat format, const jarray<const uint8*>& layersData) override;
+
+    private:
+
+        VulkanImage* m_Image = nullptr;
+
+
+        void clearVulkan();
+    };
+}
+
+#endif
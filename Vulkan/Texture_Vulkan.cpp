@@ -6,6 +6,7 @@
 
 #include "RenderEngine_Vulkan.h"
 #include "vulkanObjects/VulkanCommandPool.h"
+#include "vulkanObjects/VulkanStagingRing.h"
 
 namespace JumaRenderEngine
 {
@@ -14,14 +15,17 @@ namespace JumaRenderEngine
         clearVulkan();
     }
 
-    bool Texture_Vulkan::initInternal(const math::uvector2& size, const TextureFormat format, const uint8* data)
+    bool Texture_Vulkan::initInternal(const math::uvector2& size, const TextureFormat format, const jarray<const uint8*>& mipLevelsData)
     {
         RenderEngine_Vulkan* renderEngine = getRenderEngine<RenderEngine_Vulkan>();
 
+        // Compressed images can't be blitted, so only provided mip levels are used
+        const bool generateMips = (mipLevelsData.getSize() == 1) && !IsTextureFormatCompressed(format);
+        const uint32 mipLevels = generateMips ? GetMipLevelCountByTextureSize(size) : static_cast<uint32>(mipLevelsData.getSize());
         VulkanImage* image = renderEngine->getVulkanImage();
         const bool imageInitialized = image->init(
-            VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, 
-            { VulkanQueueType::Graphics, VulkanQueueType::Transfer }, size, VK_SAMPLE_COUNT_1_BIT, GetVulkanFormatByTextureFormat(format)
+            VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | (generateMips ? VK_IMAGE_USAGE_TRANSFER_SRC_BIT : 0), 
+            { VulkanQueueType::Graphics, VulkanQueueType::Transfer }, size, VK_SAMPLE_COUNT_1_BIT, GetVulkanFormatByTextureFormat(format), mipLevels
         );
         if (!imageInitialized)
         {
@@ -30,7 +34,7 @@ namespace JumaRenderEngine
             return false;
         }
 
-        const bool setImageDataSuccess = image->setImageData(data, 
+        const bool setImageDataSuccess = image->setImageData(mipLevelsData, 
             VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
         if (!setImageDataSuccess)
@@ -50,11 +54,28 @@ namespace JumaRenderEngine
         return true;
     }
 
+    bool Texture_Vulkan::updateRegionInternal(const math::uvector2& offset, const math::uvector2& size, const uint32 mipLevel, const uint8* data)
+    {
+        VkBufferImageCopy copyRegion{};
+        copyRegion.bufferRowLength = 0;
+        copyRegion.bufferImageHeight = 0;
+        copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        copyRegion.imageSubresource.mipLevel = mipLevel;
+        copyRegion.imageSubresource.baseArrayLayer = 0;
+        copyRegion.imageSubresource.layerCount = 1;
+        copyRegion.imageOffset = { static_cast<int32>(offset.x), static_cast<int32>(offset.y), 0 };
+        copyRegion.imageExtent = { size.x, size.y, 1 };
+        const uint32 dataSize = GetTextureDataSize(getFormat(), size.x, size.y);
+        return getRenderEngine<RenderEngine_Vulkan>()->getStagingRing()->addImageCopy(m_Image, copyRegion, data, dataSize);
+    }
+
     void Texture_Vulkan::clearVulkan()
     {
         if (m_Image != nullptr)
         {
-            getRenderEngine<RenderEngine_Vulkan>()->returnVulkanImage(m_Image);
+            RenderEngine_Vulkan* renderEngine = getRenderEngine<RenderEngine_Vulkan>();
+            renderEngine->getStagingRing()->removeImageCopies(m_Image);
+            renderEngine->returnVulkanImage(m_Image);
             m_Image = nullptr;
         }
     }
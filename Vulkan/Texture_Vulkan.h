@@ -22,7 +22,9 @@ namespace JumaRenderEngine
 
     protected:
 
-        virtual bool initInternal(const math::uvector2& size, TextureFormat format, const uint8* data) override;
+        virtual bool initInternal(const math::uvector2& size, TextureFormat format, const jarray<const uint8*>& mipLevelsData) override;
+
+        virtual bool updateRegionInternal(const math::uvector2& offset, const math::uvector2& size, uint32 mipLevel, const uint8* data) override;
 
     private:
 
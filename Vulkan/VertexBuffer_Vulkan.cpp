@@ -4,9 +4,11 @@
 
 #if defined(JUMARENDERENGINE_INCLUDE_RENDER_API_VULKAN)
 
+#include "GeometryArena_Vulkan.h"
 #include "Material_Vulkan.h"
 #include "RenderEngine_Vulkan.h"
 #include "RenderOptions_Vulkan.h"
+#include "renderEngine/RenderPipeline.h"
 #include "renderEngine/vertex/VertexBufferData.h"
 #include "vulkanObjects/VulkanCommandBuffer.h"
 
@@ -19,72 +21,134 @@ namespace JumaRenderEngine
 
     bool VertexBuffer_Vulkan::initInternal(VertexBufferData* verticesData)
     {
-        RenderEngine_Vulkan* renderEngine = getRenderEngine<RenderEngine_Vulkan>();
+        if (isDynamic())
+        {
+            return updateInternal(verticesData);
+        }
 
-        const uint32 vertexCount = verticesData->getVertexCount();
-        if (vertexCount == 0)
+        const GeometryArenaAllocation* allocation = getRenderEngine()->allocateGeometry(verticesData);
+        if (allocation == nullptr)
         {
-            JUMA_RENDER_LOG(error, JSTR("Empty vertex buffer data"));
+            JUMA_RENDER_LOG(error, JSTR("Failed to allocate vertex buffer data in geometry arena"));
             return false;
         }
-        const VertexDescription* vertexDescription = renderEngine->findVertexType(getVertexTypeName());
 
-        VulkanBuffer* vertexBuffer = renderEngine->getVulkanBuffer();
-        vertexBuffer->initGPU(
-            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, { VulkanQueueType::Graphics, VulkanQueueType::Transfer }, 
-            vertexDescription->size * vertexCount, verticesData->getVertices()
-        );
-        if (!vertexBuffer->isValid())
+        m_GeometryAllocation = allocation;
+        return true;
+    }
+
+    void VertexBuffer_Vulkan::clearVulkan()
+    {
+        if (m_GeometryAllocation != nullptr)
         {
-            JUMA_RENDER_LOG(error, JSTR("Failed to initialize vulkan vertex buffer"));
-            renderEngine->returnVulkanBuffer(vertexBuffer);
-            return false;
+            m_GeometryAllocation->arena->free(m_GeometryAllocation);
+            m_GeometryAllocation = nullptr;
         }
 
+        RenderEngine_Vulkan* renderEngine = getRenderEngine<RenderEngine_Vulkan>();
+        if (m_DynamicVertexBuffer != nullptr)
+        {
+            renderEngine->returnVulkanBuffer(m_DynamicVertexBuffer);
+            m_DynamicVertexBuffer = nullptr;
+        }
+        if (m_DynamicIndexBuffer != nullptr)
+        {
+            renderEngine->returnVulkanBuffer(m_DynamicIndexBuffer);
+            m_DynamicIndexBuffer = nullptr;
+        }
+        m_DynamicVertexCapacity = 0;
+        m_DynamicIndexCapacity = 0;
+        m_DynamicVertexCount = 0;
+        m_DynamicIndexCount = 0;
+    }
+
+    bool VertexBuffer_Vulkan::updateInternal(VertexBufferData* verticesData)
+    {
+        const VertexDescription* vertexDescription = getRenderEngine()->findVertexType(getVertexTypeName());
+        const uint32 vertexCount = verticesData->getVertexCount();
         const uint32 indexCount = verticesData->getIndexCount();
-        if (indexCount > 0)
+        if (!reserveDynamicBuffers(vertexCount, indexCount))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to reserve dynamic vulkan buffers"));
+            return false;
+        }
+
+        const uint32 segmentIndex = getDynamicSegmentIndex();
+        if (vertexCount > 0)
         {
-            VulkanBuffer* indexBuffer = renderEngine->getVulkanBuffer();
-            indexBuffer->initGPU(
-                VK_BUFFER_USAGE_INDEX_BUFFER_BIT, { VulkanQueueType::Graphics, VulkanQueueType::Transfer }, 
-                sizeof(uint32) * vertexCount, verticesData->getIndices()
-            );
-            if (!indexBuffer->isValid())
+            const uint32 offset = segmentIndex * m_DynamicVertexCapacity * vertexDescription->size;
+            if (!m_DynamicVertexBuffer->setMappedData(verticesData->getVertices(), vertexCount * vertexDescription->size, offset) ||
+                !m_DynamicVertexBuffer->flushMappedData(false))
             {
-                JUMA_RENDER_LOG(error, JSTR("Failed to initialize vulkan index buffer"));
-                renderEngine->returnVulkanBuffer(vertexBuffer);
-                renderEngine->returnVulkanBuffer(indexBuffer);
+                JUMA_RENDER_LOG(error, JSTR("Failed to write vertices to dynamic vulkan buffer"));
                 return false;
             }
-
-            m_IndexBuffer = indexBuffer;
-            m_RenderElementsCount = indexCount;
         }
-        else
+        if (indexCount > 0)
         {
-            m_RenderElementsCount = vertexCount;
+            const uint32 offset = segmentIndex * m_DynamicIndexCapacity * sizeof(uint32);
+            if (!m_DynamicIndexBuffer->setMappedData(verticesData->getIndices(), indexCount * sizeof(uint32), offset) ||
+                !m_DynamicIndexBuffer->flushMappedData(false))
+            {
+                JUMA_RENDER_LOG(error, JSTR("Failed to write indices to dynamic vulkan buffer"));
+                return false;
+            }
         }
 
-        m_VertexBuffer = vertexBuffer;
+        m_DynamicVertexCount = vertexCount;
+        m_DynamicIndexCount = indexCount;
         return true;
     }
+    bool VertexBuffer_Vulkan::reserveDynamicBuffers(const uint32 vertexCount, const uint32 indexCount)
+    {
+        const bool shouldGrow = (vertexCount > m_DynamicVertexCapacity) || (indexCount > m_DynamicIndexCapacity);
+        if (!shouldGrow)
+        {
+            return true;
+        }
 
-    void VertexBuffer_Vulkan::clearVulkan()
+        // Old buffers could still be read by the frame in flight
+        RenderEngine_Vulkan* renderEngine = getRenderEngine<RenderEngine_Vulkan>();
+        if (((m_DynamicVertexBuffer != nullptr) || (m_DynamicIndexBuffer != nullptr)) && (renderEngine->getRenderPipeline() != nullptr))
+        {
+            renderEngine->getRenderPipeline()->waitForRenderFinished();
+        }
+
+        const VertexDescription* vertexDescription = renderEngine->findVertexType(getVertexTypeName());
+        return reserveDynamicBuffer(renderEngine, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, vertexDescription->size, vertexCount, 
+                m_DynamicVertexBuffer, m_DynamicVertexCapacity)
+            && reserveDynamicBuffer(renderEngine, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, sizeof(uint32), indexCount, 
+                m_DynamicIndexBuffer, m_DynamicIndexCapacity);
+    }
+    bool VertexBuffer_Vulkan::reserveDynamicBuffer(RenderEngine_Vulkan* renderEngine, const VkBufferUsageFlags usage, const uint32 elementSize, 
+        const uint32 elementCount, VulkanBuffer*& buffer, uint32& capacity)
     {
-        if (m_VertexBuffer != nullptr)
+        if (elementCount <= capacity)
         {
-            RenderEngine_Vulkan* renderEngine = getRenderEngine<RenderEngine_Vulkan>();
-            renderEngine->returnVulkanBuffer(m_VertexBuffer);
-            renderEngine->returnVulkanBuffer(m_IndexBuffer);
+            return true;
+        }
 
-            m_VertexBuffer = nullptr;
-            m_IndexBuffer = nullptr;
-            m_RenderElementsCount = 0;
+        const uint32 newCapacity = math::max(elementCount, capacity * 2);
+        VulkanBuffer* newBuffer = renderEngine->getVulkanBuffer();
+        if (!newBuffer->initMapped(usage, { VulkanQueueType::Graphics }, newCapacity * elementSize * DynamicSegmentCount))
+        {
+            renderEngine->returnVulkanBuffer(newBuffer);
+            return false;
         }
+
+        renderEngine->returnVulkanBuffer(buffer);
+        buffer = newBuffer;
+        capacity = newCapacity;
+        return true;
     }
 
     void VertexBuffer_Vulkan::render(const RenderOptions* renderOptions, Material* material)
     {
+        if (isDynamic() && (m_DynamicVertexCount == 0))
+        {
+            return;
+        }
+
         Material_Vulkan* materialVulan = dynamic_cast<Material_Vulkan*>(material);
         if (!materialVulan->bindMaterial(renderOptions, this))
         {
@@ -92,22 +156,47 @@ namespace JumaRenderEngine
         }
 
         const RenderOptions_Vulkan* optionsVulkan = reinterpret_cast<const RenderOptions_Vulkan*>(renderOptions);
+        if (isDynamic())
+        {
+            renderDynamic(optionsVulkan);
+            materialVulan->unbindMaterial(renderOptions, this);
+            return;
+        }
+
         VkCommandBuffer commandBuffer = optionsVulkan->commandBuffer->get();
+        dynamic_cast<const GeometryArena_Vulkan*>(m_GeometryAllocation->arena)->bindBuffers(optionsVulkan);
+        if (m_GeometryAllocation->indexCount == 0)
+        {
+            vkCmdDraw(commandBuffer, m_GeometryAllocation->vertexCount, 1, m_GeometryAllocation->firstVertex, 0);
+        }
+        else
+        {
+            vkCmdDrawIndexed(commandBuffer, m_GeometryAllocation->indexCount, 1, 
+                m_GeometryAllocation->firstIndex, static_cast<int32>(m_GeometryAllocation->firstVertex), 0);
+        }
+
+        materialVulan->unbindMaterial(renderOptions, this);
+    }
+    void VertexBuffer_Vulkan::renderDynamic(const RenderOptions_Vulkan* renderOptions)
+    {
+        VkCommandBuffer commandBuffer = renderOptions->commandBuffer->get();
 
-        VkBuffer vertexBuffer = m_VertexBuffer->get();
+        const uint32 segmentIndex = getDynamicSegmentIndex();
+        VkBuffer vertexBuffer = m_DynamicVertexBuffer->get();
         constexpr VkDeviceSize offset = 0;
         vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, &offset);
-        if (m_IndexBuffer == nullptr)
+        if (m_DynamicIndexCount == 0)
         {
-            vkCmdDraw(commandBuffer, m_RenderElementsCount, 1, 0, 0);
+            vkCmdDraw(commandBuffer, m_DynamicVertexCount, 1, segmentIndex * m_DynamicVertexCapacity, 0);
         }
         else
         {
-            vkCmdBindIndexBuffer(commandBuffer, m_IndexBuffer->get(), 0, VK_INDEX_TYPE_UINT32);
-            vkCmdDrawIndexed(commandBuffer, m_RenderElementsCount, 1, 0, 0, 0);
+            vkCmdBindIndexBuffer(commandBuffer, m_DynamicIndexBuffer->get(), 0, VK_INDEX_TYPE_UINT32);
+            vkCmdDrawIndexed(commandBuffer, m_DynamicIndexCount, 1, 
+                segmentIndex * m_DynamicIndexCapacity, static_cast<int32>(segmentIndex * m_DynamicVertexCapacity), 0);
         }
-
-        materialVulan->unbindMaterial(renderOptions, this);
+        renderOptions->boundGeometryArena = nullptr;
+        markDynamicSegmentRendered();
     }
 }
 
@@ -8,8 +8,13 @@
 
 #include "renderEngine/VertexBuffer.h"
 
+#include <vulkan/vulkan_core.h>
+
 namespace JumaRenderEngine
 {
+    struct GeometryArenaAllocation;
+    struct RenderOptions_Vulkan;
+    class RenderEngine_Vulkan;
     class VulkanBuffer;
 
     class VertexBuffer_Vulkan final : public VertexBuffer
@@ -18,21 +23,34 @@ namespace JumaRenderEngine
         VertexBuffer_Vulkan() = default;
         virtual ~VertexBuffer_Vulkan() override;
 
+        virtual const GeometryArenaAllocation* getGeometryAllocation() const override { return m_GeometryAllocation; }
+
         virtual void render(const RenderOptions* renderOptions, Material* material) override;
 
     protected:
 
         virtual bool initInternal(VertexBufferData* verticesData) override;
+        virtual bool updateInternal(VertexBufferData* verticesData) override;
 
     private:
 
-        VulkanBuffer* m_VertexBuffer = nullptr;
-        VulkanBuffer* m_IndexBuffer = nullptr;
+        const GeometryArenaAllocation* m_GeometryAllocation = nullptr;
 
-        uint32 m_RenderElementsCount = 0;
+        VulkanBuffer* m_DynamicVertexBuffer = nullptr;
+        VulkanBuffer* m_DynamicIndexBuffer = nullptr;
+        uint32 m_DynamicVertexCapacity = 0;
+        uint32 m_DynamicIndexCapacity = 0;
+        uint32 m_DynamicVertexCount = 0;
+        uint32 m_DynamicIndexCount = 0;
 
 
         void clearVulkan();
+
+        bool reserveDynamicBuffers(uint32 vertexCount, uint32 indexCount);
+        static bool reserveDynamicBuffer(RenderEngine_Vulkan* renderEngine, VkBufferUsageFlags usage, uint32 elementSize, uint32 elementCount, 
+            VulkanBuffer*& buffer, uint32& capacity);
+
+        void renderDynamic(const RenderOptions_Vulkan* renderOptions);
     };
 }
 
@@ -5,6 +5,7 @@
 #if defined(JUMARENDERENGINE_INCLUDE_RENDER_API_VULKAN)
 
 #include "VulkanCommandPool.h"
+#include "VulkanUploadBatch.h"
 #include "jutils/jarray.h"
 #include "renderEngine/Vulkan/RenderEngine_Vulkan.h"
 
@@ -102,16 +103,13 @@ namespace JumaRenderEngine
         m_BufferSize = size;
         m_Mapable = false;
 
-        VulkanBuffer* stagingBuffer = renderEngine->getVulkanBuffer();
-        if (!stagingBuffer->initStaging(size) || !stagingBuffer->setData(data, size, 0, true) || !stagingBuffer->copyData(this, true))
+        if ((data != nullptr) && !setDataGPU(data, size, 0))
         {
             JUMA_RENDER_LOG(error, JSTR("Failed to copy data to GPU vulkan buffer"));
-            renderEngine->returnVulkanBuffer(stagingBuffer);
             clearVulkan();
             return false;
         }
 
-        renderEngine->returnVulkanBuffer(stagingBuffer);
         markAsInitialized();
         return true;
     }
@@ -188,12 +186,71 @@ namespace JumaRenderEngine
         return true;
     }
 
+    bool VulkanBuffer::initMapped(const VkBufferUsageFlags usage, const std::initializer_list<VulkanQueueType> accessedQueues, const uint32 size)
+    {
+        if (isValid())
+        {
+            JUMA_RENDER_LOG(error, JSTR("Vulkan buffer already initialized"));
+            return false;
+        }
+        if (size == 0)
+        {
+            JUMA_RENDER_LOG(error, JSTR("Size param is zero"));
+            return false;
+        }
+
+        RenderEngine_Vulkan* renderEngine = getRenderEngine<RenderEngine_Vulkan>();
+
+        jarray<uint32> accessedQueueFamilies;
+        for (const auto& queue : accessedQueues)
+        {
+            accessedQueueFamilies.addUnique(renderEngine->getQueue(queue)->familyIndex);
+        }
+
+        VkBufferCreateInfo bufferInfo{};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = size;
+        bufferInfo.usage = usage;
+        if (accessedQueueFamilies.getSize() > 1)
+        {
+            bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+            bufferInfo.queueFamilyIndexCount = static_cast<uint32>(accessedQueueFamilies.getSize());
+            bufferInfo.pQueueFamilyIndices = accessedQueueFamilies.getData();
+        }
+        else
+        {
+            bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            bufferInfo.queueFamilyIndexCount = 0;
+            bufferInfo.pQueueFamilyIndices = nullptr;
+        }
+        VmaAllocationCreateInfo allocationInfo{};
+        allocationInfo.usage = VMA_MEMORY_USAGE_AUTO;
+        allocationInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+        allocationInfo.requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+        allocationInfo.preferredFlags = VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        VmaAllocationInfo allocationResultInfo;
+        const VkResult result = vmaCreateBuffer(renderEngine->getAllocator(), &bufferInfo, &allocationInfo, &m_Buffer, &m_Allocation, &allocationResultInfo);
+        if (result != VK_SUCCESS)
+        {
+            JUMA_RENDER_ERROR_LOG(result, JSTR("Failed to create mapped vulkan buffer"));
+            return false;
+        }
+
+        m_BufferSize = size;
+        m_MappedData = allocationResultInfo.pMappedData;
+        m_Mapable = true;
+        m_PersistentlyMapped = true;
+        markAsInitialized();
+        return true;
+    }
+
     void VulkanBuffer::clearVulkan()
     {
         RenderEngine_Vulkan* renderEngine = getRenderEngine<RenderEngine_Vulkan>();
 
         m_MappedData = nullptr;
         m_Mapable = false;
+        m_PersistentlyMapped = false;
         if (m_StagingBuffer != nullptr)
         {
             renderEngine->returnVulkanBuffer(m_StagingBuffer);
@@ -298,6 +355,12 @@ namespace JumaRenderEngine
             JUMA_RENDER_LOG(warning, JSTR("Vulkan buffer data not mapped"));
             return false;
         }
+        if (m_PersistentlyMapped)
+        {
+            // Memory stays mapped, only make writes visible for non-coherent memory
+            vmaFlushAllocation(getRenderEngine<RenderEngine_Vulkan>()->getAllocator(), m_Allocation, 0, VK_WHOLE_SIZE);
+            return true;
+        }
         vmaUnmapMemory(getRenderEngine<RenderEngine_Vulkan>()->getAllocator(), m_Allocation);
         m_MappedData = nullptr;
         return true;
@@ -324,6 +387,10 @@ namespace JumaRenderEngine
             }
             return true;
         }
+        if (!m_Mapable)
+        {
+            return setDataGPU(data, size, offset);
+        }
         return setDataInternal(data, size, offset);
     }
     bool VulkanBuffer::setDataInternal(const void* data, const uint32 size, const uint32 offset)
@@ -346,8 +413,49 @@ namespace JumaRenderEngine
         return true;
     }
 
-    bool VulkanBuffer::copyData(const VulkanBuffer* destinationBuffer, const bool waitForFinish)
+    bool VulkanBuffer::setDataGPU(const void* data, const uint32 size, const uint32 offset)
+    {
+        RenderEngine_Vulkan* renderEngine = getRenderEngine<RenderEngine_Vulkan>();
+        VulkanBuffer* stagingBuffer = renderEngine->getVulkanBuffer();
+        VulkanUploadBatch* uploadBatch = renderEngine->getActiveUploadBatch();
+        if (uploadBatch != nullptr)
+        {
+            VkCommandBuffer commandBuffer = uploadBatch->getTransferCommandBuffer();
+            if ((commandBuffer == nullptr) || !stagingBuffer->initStaging(size) || !stagingBuffer->setDataInternal(data, size, 0))
+            {
+                JUMA_RENDER_LOG(error, JSTR("Failed to record copy to GPU vulkan buffer"));
+                renderEngine->returnVulkanBuffer(stagingBuffer);
+                return false;
+            }
+
+            const VkBufferCopy copyRegion = { 0, offset, size };
+            vkCmdCopyBuffer(commandBuffer, stagingBuffer->get(), m_Buffer, 1, &copyRegion);
+            uploadBatch->addStagingBuffer(stagingBuffer);
+            return true;
+        }
+
+        if (!stagingBuffer->initStaging(size) || !stagingBuffer->setDataInternal(data, size, 0) || 
+            !stagingBuffer->copyData(this, { { 0, offset, size } }, true))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to copy data to GPU vulkan buffer"));
+            renderEngine->returnVulkanBuffer(stagingBuffer);
+            return false;
+        }
+        renderEngine->returnVulkanBuffer(stagingBuffer);
+        return true;
+    }
+
+    bool VulkanBuffer::copyData(const VulkanBuffer* destinationBuffer, const bool waitForFinish) const
+    {
+        return copyData(destinationBuffer, { { 0, 0, m_BufferSize } }, waitForFinish);
+    }
+    bool VulkanBuffer::copyData(const VulkanBuffer* destinationBuffer, const jarray<VkBufferCopy>& regions, const bool waitForFinish) const
     {
+        if (regions.isEmpty())
+        {
+            return true;
+        }
+
         VulkanCommandPool* commandPool = getRenderEngine<RenderEngine_Vulkan>()->getCommandPool(VulkanQueueType::Transfer);
         VulkanCommandBuffer* commandBuffer = commandPool != nullptr ? commandPool->getCommandBuffer() : nullptr;
         if (commandBuffer == nullptr)
@@ -361,11 +469,7 @@ namespace JumaRenderEngine
         beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
         vkBeginCommandBuffer(commandBuffer->get(), &beginInfo);
 
-        VkBufferCopy copyRegion;
-        copyRegion.srcOffset = 0;
-        copyRegion.dstOffset = 0;
-        copyRegion.size = m_BufferSize;
-        vkCmdCopyBuffer(commandBuffer->get(), m_Buffer, destinationBuffer->get(), 1, &copyRegion);
+        vkCmdCopyBuffer(commandBuffer->get(), m_Buffer, destinationBuffer->get(), static_cast<uint32>(regions.getSize()), regions.getData());
 
         vkEndCommandBuffer(commandBuffer->get());
 
@@ -11,6 +11,7 @@
 #include <vma/vk_mem_alloc.h>
 
 #include "VulkanQueueType.h"
+#include "jutils/jarray.h"
 
 namespace JumaRenderEngine
 {
@@ -22,18 +23,22 @@ namespace JumaRenderEngine
 
         // Temp buffer for passing data to GPU
         bool initStaging(uint32 size);
-        // Only on GPU, not updated at all
+        // Only on GPU, updated through temporary staging buffers. Data could be null
         bool initGPU(VkBufferUsageFlags usage, std::initializer_list<VulkanQueueType> accessedQueues, uint32 size, const void* data);
         // GPU buffer, frequently writing from CPU directly. If not possible - it will be GPU with staging buffer
         bool initAccessedGPU(VkBufferUsageFlags usage, std::initializer_list<VulkanQueueType> accessedQueues, uint32 size);
+        // Host visible buffer, persistently mapped until cleared
+        bool initMapped(VkBufferUsageFlags usage, std::initializer_list<VulkanQueueType> accessedQueues, uint32 size);
 
         VkBuffer get() const { return m_Buffer; }
+        uint32 getSize() const { return m_BufferSize; }
 
         bool initMappedData();
         bool setMappedData(const void* data, uint32 size, uint32 offset = 0);
         bool flushMappedData(bool waitForFinish);
         
         bool setData(const void* data, uint32 size, uint32 offset, bool waitForFinish);
+        bool copyData(const VulkanBuffer* destinationBuffer, const jarray<VkBufferCopy>& regions, bool waitForFinish) const;
 
     protected:
 
@@ -49,12 +54,14 @@ namespace JumaRenderEngine
         VulkanBuffer* m_StagingBuffer = nullptr;
         void* m_MappedData = nullptr;
         bool m_Mapable = false;
+        bool m_PersistentlyMapped = false;
 
 
         void clearVulkan();
 
         bool setDataInternal(const void* data, uint32 size, uint32 offset);
-        bool copyData(const VulkanBuffer* destinationBuffer, bool waitForFinish);
+        bool setDataGPU(const void* data, uint32 size, uint32 offset);
+        bool copyData(const VulkanBuffer* destinationBuffer, bool waitForFinish) const;
     };
 }
 
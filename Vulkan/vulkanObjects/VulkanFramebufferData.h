@@ -8,6 +8,8 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include "jutils/jarray.h"
+
 namespace JumaRenderEngine
 {
     class VulkanImage;
@@ -19,8 +21,7 @@ namespace JumaRenderEngine
         VulkanImage* colorAttachment = nullptr;
         VulkanImage* depthAttachment = nullptr;
         VulkanImage* resolveAttachment = nullptr;
-
-        VulkanImage* resultImage = nullptr;
+        jarray<VulkanImage*> additionalColorAttachments;
     };
 }
 
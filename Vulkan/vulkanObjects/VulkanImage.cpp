@@ -5,22 +5,37 @@
 #if defined(JUMARENDERENGINE_INCLUDE_RENDER_API_VULKAN)
 
 #include "VulkanCommandPool.h"
+#include "VulkanUploadBatch.h"
 #include "renderEngine/TextureBase.h"
 #include "renderEngine/Vulkan/RenderEngine_Vulkan.h"
 
 namespace JumaRenderEngine
 {
-    constexpr uint32 GetTextureFormatSizeByVulkanFormat(const VkFormat format)
+    constexpr bool GetTextureFormatByVulkanFormat(const VkFormat format, TextureFormat& outFormat)
     {
         switch (format)
         {
-        case VK_FORMAT_R8G8B8A8_SRGB: return GetTextureFormatSize(TextureFormat::RGBA8);
-        case VK_FORMAT_B8G8R8A8_SRGB: return GetTextureFormatSize(TextureFormat::BGRA8);
-        case VK_FORMAT_D32_SFLOAT: return GetTextureFormatSize(TextureFormat::DEPTH32);
-        case VK_FORMAT_D24_UNORM_S8_UINT: return GetTextureFormatSize(TextureFormat::DEPTH24_STENCIL8);
+        case VK_FORMAT_R8G8B8A8_SRGB: outFormat = TextureFormat::RGBA8; return true;
+        case VK_FORMAT_B8G8R8A8_SRGB: outFormat = TextureFormat::BGRA8; return true;
+        case VK_FORMAT_R8_UNORM: outFormat = TextureFormat::R8; return true;
+        case VK_FORMAT_R8G8_UNORM: outFormat = TextureFormat::RG8; return true;
+        case VK_FORMAT_R16_SFLOAT: outFormat = TextureFormat::R16F; return true;
+        case VK_FORMAT_R16G16_SFLOAT: outFormat = TextureFormat::RG16F; return true;
+        case VK_FORMAT_R16G16B16A16_SFLOAT: outFormat = TextureFormat::RGBA16F; return true;
+        case VK_FORMAT_R32_SFLOAT: outFormat = TextureFormat::R32F; return true;
+        case VK_FORMAT_B10G11R11_UFLOAT_PACK32: outFormat = TextureFormat::R11G11B10F; return true;
+        case VK_FORMAT_D32_SFLOAT: outFormat = TextureFormat::DEPTH32; return true;
+        case VK_FORMAT_D24_UNORM_S8_UINT: outFormat = TextureFormat::DEPTH24_STENCIL8; return true;
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK: outFormat = TextureFormat::BC1_RGBA; return true;
+        case VK_FORMAT_BC3_SRGB_BLOCK: outFormat = TextureFormat::BC3_RGBA; return true;
+        case VK_FORMAT_BC4_UNORM_BLOCK: outFormat = TextureFormat::BC4_R; return true;
+        case VK_FORMAT_BC5_UNORM_BLOCK: outFormat = TextureFormat::BC5_RG; return true;
+        case VK_FORMAT_BC7_SRGB_BLOCK: outFormat = TextureFormat::BC7_RGBA; return true;
+        case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK: outFormat = TextureFormat::ETC2_RGB8; return true;
+        case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK: outFormat = TextureFormat::ETC2_RGBA8; return true;
         default: ;
         }
-        return 0;
+        return false;
     }
 
     VulkanImage::~VulkanImage()
@@ -37,6 +52,11 @@ namespace JumaRenderEngine
             vkDestroyImageView(renderEngine->getDevice(), m_ImageView, nullptr);
             m_ImageView = nullptr;
         }
+        if (m_AttachmentImageView != nullptr)
+        {
+            vkDestroyImageView(renderEngine->getDevice(), m_AttachmentImageView, nullptr);
+            m_AttachmentImageView = nullptr;
+        }
         if (m_Allocation != nullptr)
         {
             vmaDestroyImage(renderEngine->getAllocator(), m_Image, m_Allocation);
@@ -46,16 +66,24 @@ namespace JumaRenderEngine
 
         m_Size = { 0, 0 };
         m_Format = VK_FORMAT_UNDEFINED;
+        m_LayerCount = 1;
+        m_LazilyAllocated = false;
+        m_AspectFlags = VK_IMAGE_ASPECT_COLOR_BIT;
     }
 
     bool VulkanImage::init(const VkImageUsageFlags usage, const std::initializer_list<VulkanQueueType> accessedQueues,
-        const math::uvector2& size, const VkSampleCountFlagBits sampleCount, const VkFormat format, const uint32 mipLevels)
+        const math::uvector2& size, const uint32 layerCount, const VkSampleCountFlagBits sampleCount, const VkFormat format, const uint32 mipLevels)
     {
         if (isValid())
         {
             JUMA_RENDER_LOG(warning, JSTR("Vulkan image already initialized"));
             return false;
         }
+        if (layerCount == 0)
+        {
+            JUMA_RENDER_LOG(error, JSTR("Invalid input params"));
+            return false;
+        }
 
         const RenderEngine_Vulkan* renderEngine = getRenderEngine<RenderEngine_Vulkan>();
         jarray<uint32> accessedQueueFamilies;
@@ -72,7 +100,7 @@ namespace JumaRenderEngine
         imageInfo.extent.height = size.y;
         imageInfo.extent.depth = 1;
         imageInfo.mipLevels = mipLevels;
-        imageInfo.arrayLayers = 1;
+        imageInfo.arrayLayers = layerCount;
         imageInfo.format = format;
         imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
         imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -95,7 +123,20 @@ namespace JumaRenderEngine
         allocationInfo.flags = 0;
         allocationInfo.usage = VMA_MEMORY_USAGE_AUTO;
         allocationInfo.preferredFlags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
-        const VkResult result = vmaCreateImage(renderEngine->getAllocator(), &imageInfo, &allocationInfo, &m_Image, &m_Allocation, nullptr);
+        bool lazilyAllocated = false;
+        VkResult result = VK_ERROR_FEATURE_NOT_PRESENT;
+        if (usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT)
+        {
+            // Lazily allocated memory is usually available only on tiled GPUs
+            allocationInfo.usage = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED;
+            result = vmaCreateImage(renderEngine->getAllocator(), &imageInfo, &allocationInfo, &m_Image, &m_Allocation, nullptr);
+            lazilyAllocated = result == VK_SUCCESS;
+            allocationInfo.usage = VMA_MEMORY_USAGE_AUTO;
+        }
+        if (!lazilyAllocated)
+        {
+            result = vmaCreateImage(renderEngine->getAllocator(), &imageInfo, &allocationInfo, &m_Image, &m_Allocation, nullptr);
+        }
         if (result != VK_SUCCESS)
         {
             JUMA_RENDER_ERROR_LOG(result, JSTR("Failed to create vulkan image"));
@@ -105,9 +146,16 @@ namespace JumaRenderEngine
         m_Size = size;
         m_Format = format;
         m_MipLevels = mipLevels;
+        m_LayerCount = layerCount;
+        m_LazilyAllocated = lazilyAllocated;
         markAsInitialized();
         return true;
     }
+    bool VulkanImage::init(const VkImageUsageFlags usage, const std::initializer_list<VulkanQueueType> accessedQueues,
+        const math::uvector2& size, const VkSampleCountFlagBits sampleCount, const VkFormat format, const uint32 mipLevels)
+    {
+        return init(usage, accessedQueues, size, 1, sampleCount, format, mipLevels);
+    }
     bool VulkanImage::init(const VkImageUsageFlags usage, const std::initializer_list<VulkanQueueType> accessedQueues,
         const math::uvector2& size, const VkSampleCountFlagBits sampleCount, const VkFormat format)
     {
@@ -135,7 +183,7 @@ namespace JumaRenderEngine
         return true;
     }
 
-    bool VulkanImage::createImageView(const VkImageAspectFlags aspectFlags)
+    bool VulkanImage::createImageView(const VkImageAspectFlags aspectFlags, const VkImageViewType viewType)
     {
         if (!isValid())
         {
@@ -147,11 +195,34 @@ namespace JumaRenderEngine
             JUMA_RENDER_LOG(warning, JSTR("Vulkan image view already created"));
             return false;
         }
-
+        if (!createImageViewInternal(aspectFlags, viewType, m_MipLevels, m_ImageView))
+        {
+            return false;
+        }
+        m_AspectFlags = aspectFlags;
+        return true;
+    }
+    bool VulkanImage::createAttachmentImageView(const VkImageAspectFlags aspectFlags)
+    {
+        if (!isValid())
+        {
+            JUMA_RENDER_LOG(error, JSTR("Vulkan image not initialized"));
+            return false;
+        }
+        if (m_AttachmentImageView != nullptr)
+        {
+            JUMA_RENDER_LOG(warning, JSTR("Vulkan attachment image view already created"));
+            return false;
+        }
+        return (m_MipLevels == 1) || createImageViewInternal(aspectFlags, VK_IMAGE_VIEW_TYPE_2D, 1, m_AttachmentImageView);
+    }
+    bool VulkanImage::createImageViewInternal(const VkImageAspectFlags aspectFlags, const VkImageViewType viewType, const uint32 mipLevels, 
+        VkImageView& outImageView) const
+    {
         VkImageViewCreateInfo imageViewInfo{};
 	    imageViewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
 	    imageViewInfo.image = m_Image;
-	    imageViewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+	    imageViewInfo.viewType = viewType;
 	    imageViewInfo.format = m_Format;
 	    imageViewInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
 	    imageViewInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
@@ -159,10 +230,10 @@ namespace JumaRenderEngine
 	    imageViewInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
 	    imageViewInfo.subresourceRange.aspectMask = aspectFlags;
 	    imageViewInfo.subresourceRange.baseMipLevel = 0;
-	    imageViewInfo.subresourceRange.levelCount = m_MipLevels;
+	    imageViewInfo.subresourceRange.levelCount = mipLevels;
 	    imageViewInfo.subresourceRange.baseArrayLayer = 0;
-	    imageViewInfo.subresourceRange.layerCount = 1;
-        const VkResult result = vkCreateImageView(getRenderEngine<RenderEngine_Vulkan>()->getDevice(), &imageViewInfo, nullptr, &m_ImageView);
+	    imageViewInfo.subresourceRange.layerCount = m_LayerCount;
+        const VkResult result = vkCreateImageView(getRenderEngine<RenderEngine_Vulkan>()->getDevice(), &imageViewInfo, nullptr, &outImageView);
         if (result != VK_SUCCESS)
         {
             JUMA_RENDER_ERROR_LOG(result, JSTR("Failed to create vulkan image view"));
@@ -184,11 +255,17 @@ namespace JumaRenderEngine
         imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
         imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
         imageBarrier.image = m_Image;
-        imageBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        imageBarrier.subresourceRange.aspectMask = m_AspectFlags;
+        if ((m_AspectFlags & VK_IMAGE_ASPECT_DEPTH_BIT) && ((m_Format == VK_FORMAT_D16_UNORM_S8_UINT) || 
+            (m_Format == VK_FORMAT_D24_UNORM_S8_UINT) || (m_Format == VK_FORMAT_D32_SFLOAT_S8_UINT)))
+        {
+            // Layout of depth and stencil is changed together
+            imageBarrier.subresourceRange.aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
+        }
         imageBarrier.subresourceRange.baseMipLevel = 0;
         imageBarrier.subresourceRange.levelCount = m_MipLevels;
         imageBarrier.subresourceRange.baseArrayLayer = 0;
-        imageBarrier.subresourceRange.layerCount = 1;
+        imageBarrier.subresourceRange.layerCount = m_LayerCount;
         // TODO: Track image layout
         // TODO: change to vkCmdPipelineBarrier2
         vkCmdPipelineBarrier(
@@ -228,10 +305,10 @@ namespace JumaRenderEngine
                 newLayout, dstAccess, dstStage);
         }
     }
-    void VulkanImage::generateMipmaps(VkCommandBuffer commandBuffer, 
+    void VulkanImage::generateMipmaps(VkCommandBuffer commandBuffer, const math::uvector2& size, 
         const VkImageLayout newLayout, const VkAccessFlags dstAccess, const VkPipelineStageFlags dstStage)
     {
-        math::ivector2 mipmapSize = m_Size;
+        math::ivector2 mipmapSize = size;
         VkImageMemoryBarrier imageBarrier{};
         imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
         imageBarrier.image = m_Image;
@@ -239,7 +316,7 @@ namespace JumaRenderEngine
         imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
         imageBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
         imageBarrier.subresourceRange.baseArrayLayer = 0;
-        imageBarrier.subresourceRange.layerCount = 1;
+        imageBarrier.subresourceRange.layerCount = m_LayerCount;
         imageBarrier.subresourceRange.levelCount = 1;
         for (uint32 mipLevel = 1; mipLevel < m_MipLevels; mipLevel++)
         {
@@ -260,13 +337,13 @@ namespace JumaRenderEngine
             imageBlit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
             imageBlit.srcSubresource.mipLevel = mipLevel - 1;
             imageBlit.srcSubresource.baseArrayLayer = 0;
-            imageBlit.srcSubresource.layerCount = 1;
+            imageBlit.srcSubresource.layerCount = m_LayerCount;
             imageBlit.dstOffsets[0] = { 0, 0, 0 };
             imageBlit.dstOffsets[1] = { newMipmapSize.x, newMipmapSize.y, 1 };
             imageBlit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
             imageBlit.dstSubresource.mipLevel = mipLevel;
             imageBlit.dstSubresource.baseArrayLayer = 0;
-            imageBlit.dstSubresource.layerCount = 1;
+            imageBlit.dstSubresource.layerCount = m_LayerCount;
             vkCmdBlitImage(commandBuffer,
                 m_Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
                 m_Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
@@ -299,22 +376,150 @@ namespace JumaRenderEngine
         const VkImageLayout oldLayout, const VkAccessFlags srcAccess, const VkPipelineStageFlags srcStage, 
         const VkImageLayout newLayout, const VkAccessFlags dstAccess, const VkPipelineStageFlags dstStage)
     {
-        if (data == nullptr)
+        return setImageData(jarray<const uint8*>(1, data), oldLayout, srcAccess, srcStage, newLayout, dstAccess, dstStage);
+    }
+    bool VulkanImage::setImageData(const jarray<const uint8*>& mipLevelsData, 
+        const VkImageLayout oldLayout, const VkAccessFlags srcAccess, const VkPipelineStageFlags srcStage, 
+        const VkImageLayout newLayout, const VkAccessFlags dstAccess, const VkPipelineStageFlags dstStage)
+    {
+        TextureFormat format = TextureFormat::RGBA8;
+        if (mipLevelsData.isEmpty() || ((mipLevelsData.getSize() > 1) && (static_cast<uint32>(mipLevelsData.getSize()) != m_MipLevels)) || 
+            !GetTextureFormatByVulkanFormat(m_Format, format))
+        {
+            JUMA_RENDER_LOG(warning, JSTR("Invalid input params"));
+            return false;
+        }
+
+        // Offsets of copy regions must be aligned to the texel block size
+        constexpr uint32 levelDataAlignment = 16;
+        jarray<VkBufferImageCopy> copyRegions;
+        copyRegions.reserve(mipLevelsData.getSize());
+        jarray<uint32> levelSizes;
+        levelSizes.reserve(mipLevelsData.getSize());
+        uint32 stagingBufferSize = 0;
+        math::uvector2 levelSize = m_Size;
+        for (int32 mipLevel = 0; mipLevel < mipLevelsData.getSize(); mipLevel++)
+        {
+            if (mipLevelsData[mipLevel] == nullptr)
+            {
+                JUMA_RENDER_LOG(warning, JSTR("Invalid input params"));
+                return false;
+            }
+
+            VkBufferImageCopy& imageCopy = copyRegions.addDefault();
+            imageCopy.bufferOffset = stagingBufferSize;
+            imageCopy.bufferRowLength = 0;
+            imageCopy.bufferImageHeight = 0;
+            imageCopy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            imageCopy.imageSubresource.mipLevel = static_cast<uint32>(mipLevel);
+            imageCopy.imageSubresource.baseArrayLayer = 0;
+            imageCopy.imageSubresource.layerCount = 1;
+            imageCopy.imageOffset = { 0, 0, 0 };
+            imageCopy.imageExtent = { levelSize.x, levelSize.y, 1 };
+
+            const uint32 levelDataSize = GetTextureDataSize(format, levelSize.x, levelSize.y);
+            levelSizes.add(levelDataSize);
+            stagingBufferSize += (levelDataSize + levelDataAlignment - 1) / levelDataAlignment * levelDataAlignment;
+            levelSize = { math::max(levelSize.x / 2, 1u), math::max(levelSize.y / 2, 1u) };
+        }
+
+        RenderEngine_Vulkan* renderEngine = getRenderEngine<RenderEngine_Vulkan>();
+        VulkanBuffer* stagingBuffer = renderEngine->getVulkanBuffer();
+        if (!stagingBuffer->initStaging(stagingBufferSize))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to create staging buffer"));
+            renderEngine->returnVulkanBuffer(stagingBuffer);
+            return false;
+        }
+        for (int32 mipLevel = 0; mipLevel < mipLevelsData.getSize(); mipLevel++)
+        {
+            if (!stagingBuffer->setData(mipLevelsData[mipLevel], levelSizes[mipLevel], static_cast<uint32>(copyRegions[mipLevel].bufferOffset), true))
+            {
+                JUMA_RENDER_LOG(error, JSTR("Failed to copy data to staging buffer"));
+                renderEngine->returnVulkanBuffer(stagingBuffer);
+                return false;
+            }
+        }
+        const bool generateMips = (mipLevelsData.getSize() == 1) && (m_MipLevels > 1);
+
+        return submitCopyFromBuffer(stagingBuffer, copyRegions, generateMips, oldLayout, srcAccess, srcStage, newLayout, dstAccess, dstStage);
+    }
+    bool VulkanImage::setImageLayersData(const jarray<const uint8*>& layersData, 
+        const VkImageLayout oldLayout, const VkAccessFlags srcAccess, const VkPipelineStageFlags srcStage, 
+        const VkImageLayout newLayout, const VkAccessFlags dstAccess, const VkPipelineStageFlags dstStage)
+    {
+        TextureFormat format = TextureFormat::RGBA8;
+        if ((static_cast<uint32>(layersData.getSize()) != m_LayerCount) || !GetTextureFormatByVulkanFormat(m_Format, format) || 
+            IsTextureFormatCompressed(format))
         {
             JUMA_RENDER_LOG(warning, JSTR("Invalid input params"));
             return false;
         }
 
+        // Offsets of copy regions must be aligned to 4 bytes for transfer queue
+        constexpr uint32 layerDataAlignment = 16;
+        const uint32 layerDataSize = GetTextureDataSize(format, m_Size.x, m_Size.y);
+        const uint32 layerDataStride = (layerDataSize + layerDataAlignment - 1) / layerDataAlignment * layerDataAlignment;
         RenderEngine_Vulkan* renderEngine = getRenderEngine<RenderEngine_Vulkan>();
-        const uint32 imageSize = m_Size.x * m_Size.y * GetTextureFormatSizeByVulkanFormat(m_Format);
         VulkanBuffer* stagingBuffer = renderEngine->getVulkanBuffer();
-        if (!stagingBuffer->initStaging(imageSize) || !stagingBuffer->setData(data, imageSize, 0, true))
+        if (!stagingBuffer->initStaging(layerDataStride * m_LayerCount))
         {
             JUMA_RENDER_LOG(error, JSTR("Failed to create staging buffer"));
             renderEngine->returnVulkanBuffer(stagingBuffer);
             return false;
         }
 
+        jarray<VkBufferImageCopy> copyRegions;
+        copyRegions.reserve(layersData.getSize());
+        for (int32 layer = 0; layer < layersData.getSize(); layer++)
+        {
+            const uint32 bufferOffset = layerDataStride * static_cast<uint32>(layer);
+            if ((layersData[layer] == nullptr) || !stagingBuffer->setData(layersData[layer], layerDataSize, bufferOffset, true))
+            {
+                JUMA_RENDER_LOG(error, JSTR("Failed to copy data of layer {} to staging buffer"), layer);
+                renderEngine->returnVulkanBuffer(stagingBuffer);
+                return false;
+            }
+
+            VkBufferImageCopy& imageCopy = copyRegions.addDefault();
+            imageCopy.bufferOffset = bufferOffset;
+            imageCopy.bufferRowLength = 0;
+            imageCopy.bufferImageHeight = 0;
+            imageCopy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            imageCopy.imageSubresource.mipLevel = 0;
+            imageCopy.imageSubresource.baseArrayLayer = static_cast<uint32>(layer);
+            imageCopy.imageSubresource.layerCount = 1;
+            imageCopy.imageOffset = { 0, 0, 0 };
+            imageCopy.imageExtent = { m_Size.x, m_Size.y, 1 };
+        }
+        return submitCopyFromBuffer(stagingBuffer, copyRegions, m_MipLevels > 1, oldLayout, srcAccess, srcStage, newLayout, dstAccess, dstStage);
+    }
+    bool VulkanImage::submitCopyFromBuffer(VulkanBuffer* stagingBuffer, const jarray<VkBufferImageCopy>& copyRegions, const bool generateMips,
+        const VkImageLayout oldLayout, const VkAccessFlags srcAccess, const VkPipelineStageFlags srcStage, 
+        const VkImageLayout newLayout, const VkAccessFlags dstAccess, const VkPipelineStageFlags dstStage)
+    {
+        RenderEngine_Vulkan* renderEngine = getRenderEngine<RenderEngine_Vulkan>();
+        VulkanUploadBatch* uploadBatch = renderEngine->getActiveUploadBatch();
+        if (uploadBatch != nullptr)
+        {
+            // Transfer queue doesn't support other stages, so initial transition goes to graphics part in that case
+            constexpr VkPipelineStageFlags transferStages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+            const bool copyOnTransferQueue = (srcStage & ~transferStages) == 0;
+            VkCommandBuffer copyCommandBuffer = copyOnTransferQueue ? uploadBatch->getTransferCommandBuffer() : uploadBatch->getGraphicsCommandBuffer();
+            VkCommandBuffer graphicsCommandBuffer = uploadBatch->getGraphicsCommandBuffer();
+            if ((copyCommandBuffer == nullptr) || (graphicsCommandBuffer == nullptr))
+            {
+                JUMA_RENDER_LOG(error, JSTR("Failed to get upload batch command buffers"));
+                renderEngine->returnVulkanBuffer(stagingBuffer);
+                return false;
+            }
+
+            recordCopyFromBuffer(copyCommandBuffer, stagingBuffer, copyRegions, oldLayout, srcAccess, srcStage);
+            recordFinalLayout(graphicsCommandBuffer, generateMips, newLayout, dstAccess, dstStage);
+            uploadBatch->addStagingBuffer(stagingBuffer);
+            return true;
+        }
+
         VulkanCommandBuffer* commandBuffer = renderEngine->getCommandPool(VulkanQueueType::Graphics)->getCommandBuffer();
         VkCommandBuffer vulkanCommandBuffer = commandBuffer->get();
         VkCommandBufferBeginInfo beginInfo{};
@@ -322,33 +527,8 @@ namespace JumaRenderEngine
         beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
         vkBeginCommandBuffer(vulkanCommandBuffer, &beginInfo);
 
-        changeImageLayout(vulkanCommandBuffer, 
-            oldLayout, srcAccess, srcStage,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT
-        );
-        VkBufferImageCopy imageCopy{};
-        imageCopy.bufferOffset = 0;
-        imageCopy.bufferRowLength = 0;
-        imageCopy.bufferImageHeight = 0;
-        imageCopy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        imageCopy.imageSubresource.mipLevel = 0;
-        imageCopy.imageSubresource.baseArrayLayer = 0;
-        imageCopy.imageSubresource.layerCount = 1;
-        imageCopy.imageOffset = { 0, 0, 0 };
-        imageCopy.imageExtent = { m_Size.x, m_Size.y, 1 };
-        vkCmdCopyBufferToImage(vulkanCommandBuffer, stagingBuffer->get(), m_Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &imageCopy);
-
-        if (m_MipLevels > 1)
-        {
-            generateMipmaps(vulkanCommandBuffer, newLayout, dstAccess, dstStage);
-        }
-        else
-        {
-            changeImageLayout(vulkanCommandBuffer, 
-                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                newLayout, dstAccess, dstStage
-            );
-        }
+        recordCopyFromBuffer(vulkanCommandBuffer, stagingBuffer, copyRegions, oldLayout, srcAccess, srcStage);
+        recordFinalLayout(vulkanCommandBuffer, generateMips, newLayout, dstAccess, dstStage);
 
         vkEndCommandBuffer(vulkanCommandBuffer);
         if (!commandBuffer->submit(true))
@@ -363,6 +543,31 @@ namespace JumaRenderEngine
         renderEngine->returnVulkanBuffer(stagingBuffer);
         return true;
     }
+    void VulkanImage::recordCopyFromBuffer(VkCommandBuffer commandBuffer, const VulkanBuffer* buffer, const jarray<VkBufferImageCopy>& copyRegions,
+        const VkImageLayout oldLayout, const VkAccessFlags srcAccess, const VkPipelineStageFlags srcStage)
+    {
+        changeImageLayout(commandBuffer, 
+            oldLayout, srcAccess, srcStage,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT
+        );
+        vkCmdCopyBufferToImage(commandBuffer, buffer->get(), m_Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 
+            static_cast<uint32>(copyRegions.getSize()), copyRegions.getData());
+    }
+    void VulkanImage::recordFinalLayout(VkCommandBuffer commandBuffer, const bool generateMips, 
+        const VkImageLayout newLayout, const VkAccessFlags dstAccess, const VkPipelineStageFlags dstStage)
+    {
+        if (generateMips)
+        {
+            generateMipmaps(commandBuffer, newLayout, dstAccess, dstStage);
+        }
+        else
+        {
+            changeImageLayout(commandBuffer, 
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                newLayout, dstAccess, dstStage
+            );
+        }
+    }
 }
 
 #endif
@@ -11,20 +11,37 @@
 #include <vma/vk_mem_alloc.h>
 
 #include "VulkanQueueType.h"
+#include "jutils/jarray.h"
 #include "jutils/math/vector2.h"
 #include "renderEngine/texture/TextureFormat.h"
 #include "renderEngine/texture/TextureSamples.h"
 
 namespace JumaRenderEngine
 {
+    class VulkanBuffer;
+
     constexpr VkFormat GetVulkanFormatByTextureFormat(const TextureFormat format)
     {
         switch (format)
         {
         case TextureFormat::RGBA8: return VK_FORMAT_R8G8B8A8_SRGB;
         case TextureFormat::BGRA8: return VK_FORMAT_B8G8R8A8_SRGB;
+        case TextureFormat::R8: return VK_FORMAT_R8_UNORM;
+        case TextureFormat::RG8: return VK_FORMAT_R8G8_UNORM;
+        case TextureFormat::R16F: return VK_FORMAT_R16_SFLOAT;
+        case TextureFormat::RG16F: return VK_FORMAT_R16G16_SFLOAT;
+        case TextureFormat::RGBA16F: return VK_FORMAT_R16G16B16A16_SFLOAT;
+        case TextureFormat::R32F: return VK_FORMAT_R32_SFLOAT;
+        case TextureFormat::R11G11B10F: return VK_FORMAT_B10G11R11_UFLOAT_PACK32;
         case TextureFormat::DEPTH32: return VK_FORMAT_D32_SFLOAT;
         case TextureFormat::DEPTH24_STENCIL8: return VK_FORMAT_D24_UNORM_S8_UINT;
+        case TextureFormat::BC1_RGBA: return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+        case TextureFormat::BC3_RGBA: return VK_FORMAT_BC3_SRGB_BLOCK;
+        case TextureFormat::BC4_R: return VK_FORMAT_BC4_UNORM_BLOCK;
+        case TextureFormat::BC5_RG: return VK_FORMAT_BC5_UNORM_BLOCK;
+        case TextureFormat::BC7_RGBA: return VK_FORMAT_BC7_SRGB_BLOCK;
+        case TextureFormat::ETC2_RGB8: return VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK;
+        case TextureFormat::ETC2_RGBA8: return VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK;
         default: ;
         }
         return VK_FORMAT_UNDEFINED;
@@ -50,16 +67,25 @@ namespace JumaRenderEngine
         VulkanImage() = default;
         virtual ~VulkanImage() override;
 
+        bool init(VkImageUsageFlags usage, std::initializer_list<VulkanQueueType> accessedQueues, const math::uvector2& size, 
+            uint32 layerCount, VkSampleCountFlagBits sampleCount, VkFormat format, uint32 mipLevels);
         bool init(VkImageUsageFlags usage, std::initializer_list<VulkanQueueType> accessedQueues, const math::uvector2& size, 
             VkSampleCountFlagBits sampleCount, VkFormat format, uint32 mipLevels);
         bool init(VkImageUsageFlags usage, std::initializer_list<VulkanQueueType> accessedQueues, const math::uvector2& size, 
             VkSampleCountFlagBits sampleCount, VkFormat format);
         bool init(VkImage existingImage, const math::uvector2& size, VkFormat format, uint32 mipLevels);
 
-        bool createImageView(VkImageAspectFlags aspectFlags);
+        bool createImageView(VkImageAspectFlags aspectFlags) { return createImageView(aspectFlags, VK_IMAGE_VIEW_TYPE_2D); }
+        bool createImageView(VkImageAspectFlags aspectFlags, VkImageViewType viewType);
+        // Framebuffer attachment can't have more than one mip level, so image with mips needs separate view
+        bool createAttachmentImageView(VkImageAspectFlags aspectFlags);
 
         VkImage get() const { return m_Image; }
         VkImageView getImageView() const { return m_ImageView; }
+        VkImageView getAttachmentImageView() const { return m_AttachmentImageView != nullptr ? m_AttachmentImageView : m_ImageView; }
+        uint32 getMipLevels() const { return m_MipLevels; }
+        uint32 getLayerCount() const { return m_LayerCount; }
+        bool isLazilyAllocated() const { return m_LazilyAllocated; }
 
         void changeImageLayout(VkCommandBuffer commandBuffer,
             VkImageLayout oldLayout, VkAccessFlags srcAccess, VkPipelineStageFlags srcStage,
@@ -67,11 +93,25 @@ namespace JumaRenderEngine
         void copyImage(VkCommandBuffer commandBuffer, 
             const VulkanImage* srcImage, uint32 srcMipLevel, uint32 dstMipLevel,
             VkImageLayout newLayout, VkAccessFlags dstAccess, VkPipelineStageFlags dstStage);
-        void generateMipmaps(VkCommandBuffer commandBuffer, VkImageLayout newLayout, VkAccessFlags dstAccess, VkPipelineStageFlags dstStage);
+        void generateMipmaps(VkCommandBuffer commandBuffer, const VkImageLayout newLayout, const VkAccessFlags dstAccess, const VkPipelineStageFlags dstStage)
+        {
+            generateMipmaps(commandBuffer, m_Size, newLayout, dstAccess, dstStage);
+        }
+        // Only the region of this size from the corner of the first level is downsampled
+        void generateMipmaps(VkCommandBuffer commandBuffer, const math::uvector2& size, 
+            VkImageLayout newLayout, VkAccessFlags dstAccess, VkPipelineStageFlags dstStage);
 
         bool setImageData(const uint8* data, 
             VkImageLayout oldLayout, VkAccessFlags srcAccess, VkPipelineStageFlags srcStage,
             VkImageLayout newLayout, VkAccessFlags dstAccess, VkPipelineStageFlags dstStage);
+        // One level means that other levels are generated, otherwise data for every level is required
+        bool setImageData(const jarray<const uint8*>& mipLevelsData, 
+            VkImageLayout oldLayout, VkAccessFlags srcAccess, VkPipelineStageFlags srcStage,
+            VkImageLayout newLayout, VkAccessFlags dstAccess, VkPipelineStageFlags dstStage);
+        // First mip level of every layer, other levels are generated
+        bool setImageLayersData(const jarray<const uint8*>& layersData, 
+            VkImageLayout oldLayout, VkAccessFlags srcAccess, VkPipelineStageFlags srcStage,
+            VkImageLayout newLayout, VkAccessFlags dstAccess, VkPipelineStageFlags dstStage);
 
     protected:
 
@@ -82,13 +122,28 @@ namespace JumaRenderEngine
         VkImage m_Image = nullptr;
         VmaAllocation m_Allocation = nullptr;
         VkImageView m_ImageView = nullptr;
+        VkImageView m_AttachmentImageView = nullptr;
+        VkImageAspectFlags m_AspectFlags = VK_IMAGE_ASPECT_COLOR_BIT;
 
         math::uvector2 m_Size = { 0, 0 };
         VkFormat m_Format = VK_FORMAT_UNDEFINED;
         uint32 m_MipLevels = 0;
+        uint32 m_LayerCount = 1;
+        bool m_LazilyAllocated = false;
 
 
         void clearVulkan();
+
+        bool createImageViewInternal(VkImageAspectFlags aspectFlags, VkImageViewType viewType, uint32 mipLevels, VkImageView& outImageView) const;
+
+        bool submitCopyFromBuffer(VulkanBuffer* stagingBuffer, const jarray<VkBufferImageCopy>& copyRegions, bool generateMips, 
+            VkImageLayout oldLayout, VkAccessFlags srcAccess, VkPipelineStageFlags srcStage,
+            VkImageLayout newLayout, VkAccessFlags dstAccess, VkPipelineStageFlags dstStage);
+
+        void recordCopyFromBuffer(VkCommandBuffer commandBuffer, const VulkanBuffer* buffer, const jarray<VkBufferImageCopy>& copyRegions,
+            VkImageLayout oldLayout, VkAccessFlags srcAccess, VkPipelineStageFlags srcStage);
+        void recordFinalLayout(VkCommandBuffer commandBuffer, bool generateMips, 
+            VkImageLayout newLayout, VkAccessFlags dstAccess, VkPipelineStageFlags dstStage);
     };
 }
 
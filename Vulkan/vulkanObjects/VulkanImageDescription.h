@@ -0,0 +1,74 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#pragma once
+
+#include "renderEngine/juma_render_engine_core.h"
+
+#if defined(JUMARENDERENGINE_INCLUDE_RENDER_API_VULKAN)
+
+#include <vulkan/vulkan_core.h>
+
+#include "jutils/math/vector2.h"
+
+namespace JumaRenderEngine
+{
+    // Description of the pooled image, such images are accessed only by graphics queue
+    struct VulkanImageDescription
+    {
+        VkImageUsageFlags usage = 0;
+        math::uvector2 size = { 0, 0 };
+        VkSampleCountFlagBits sampleCount = VK_SAMPLE_COUNT_1_BIT;
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        uint32 mipLevels = 1;
+        VkImageAspectFlags aspectFlags = VK_IMAGE_ASPECT_COLOR_BIT;
+
+        struct predicate
+        {
+            constexpr bool operator()(const VulkanImageDescription& description1, const VulkanImageDescription& description2) const;
+        };
+    };
+
+    struct VulkanImagePoolStats
+    {
+        // Requests that reused released image
+        uint64 hitCount = 0;
+        // Requests that created new image
+        uint64 missCount = 0;
+        // Released images destroyed because they were not requested for too long
+        uint64 agedOutCount = 0;
+        // Released images waiting for reuse
+        uint32 pooledImageCount = 0;
+    };
+
+    constexpr bool VulkanImageDescription::predicate::operator()(const VulkanImageDescription& description1, 
+        const VulkanImageDescription& description2) const
+    {
+        if (description1.format != description2.format)
+        {
+            return description1.format < description2.format;
+        }
+        if (description1.size.x != description2.size.x)
+        {
+            return description1.size.x < description2.size.x;
+        }
+        if (description1.size.y != description2.size.y)
+        {
+            return description1.size.y < description2.size.y;
+        }
+        if (description1.sampleCount != description2.sampleCount)
+        {
+            return description1.sampleCount < description2.sampleCount;
+        }
+        if (description1.usage != description2.usage)
+        {
+            return description1.usage < description2.usage;
+        }
+        if (description1.mipLevels != description2.mipLevels)
+        {
+            return description1.mipLevels < description2.mipLevels;
+        }
+        return description1.aspectFlags < description2.aspectFlags;
+    }
+}
+
+#endif
@@ -16,22 +16,50 @@ namespace JumaRenderEngine
 
     bool VulkanRenderPass::init(const VulkanRenderPassDescription& description, const render_pass_type_id renderPassTypeID)
     {
+        if (description.isDepthOnly())
+        {
+            return initDepthOnly(description, renderPassTypeID);
+        }
+
         const bool resolveEnabled = description.sampleCount != VK_SAMPLE_COUNT_1_BIT;
-        const int32 attachmentCount = resolveEnabled ? (description.shouldUseDepth ? 3 : 2) : (description.shouldUseDepth ? 2 : 1);
+        const uint8 colorAttachmentCount = description.getColorAttachmentCount();
+        if ((colorAttachmentCount > 1) && (resolveEnabled || description.renderToSwapchain))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Multiple color attachments are supported only by offscreen render pass without multisampling"));
+            return false;
+        }
+        if (getRenderEngine<RenderEngine_Vulkan>()->isDynamicRenderingEnabled())
+        {
+            initDynamicRendering(description, renderPassTypeID);
+            return true;
+        }
+        // Additional color attachments are placed after all others
+        const int32 mainAttachmentCount = resolveEnabled ? (description.shouldUseDepth ? 3 : 2) : (description.shouldUseDepth ? 2 : 1);
+        const int32 attachmentCount = mainAttachmentCount + colorAttachmentCount - 1;
 
-        VkAttachmentDescription attachments[3];
+        VkAttachmentDescription attachments[3 + VulkanRenderPassDescription::MaxAdditionalColorAttachmentCount];
         VkAttachmentReference attachmentRefs[3];
+        VkAttachmentReference colorAttachmentRefs[1 + VulkanRenderPassDescription::MaxAdditionalColorAttachmentCount];
 
         VkAttachmentDescription& colorAttachment = attachments[0];
         colorAttachment.flags = 0;
         colorAttachment.format = description.colorFormat;
         colorAttachment.samples = description.sampleCount;
-        colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-        colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        colorAttachment.loadOp = description.colorLoadOp;
+        // Multisampled attachment is only resolved, so it never leaves tile memory
+        colorAttachment.storeOp = resolveEnabled ? VK_ATTACHMENT_STORE_OP_DONT_CARE : description.colorStoreOp;
         colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        colorAttachment.finalLayout = (description.renderToSwapchain && !resolveEnabled) ? VK_IMAGE_LAYOUT_PRESENT_SRC_KHR : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        // Loaded only by offscreen render target without multisampling, it's left for sampling by previous render
+        colorAttachment.initialLayout = description.colorLoadOp == VK_ATTACHMENT_LOAD_OP_LOAD ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+        if (!resolveEnabled)
+        {
+            colorAttachment.finalLayout = description.renderToSwapchain ? VK_IMAGE_LAYOUT_PRESENT_SRC_KHR : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        }
+        else
+        {
+            colorAttachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        }
         VkAttachmentReference& colorAttachmentRef = attachmentRefs[0];
         colorAttachmentRef.attachment = 0;
         colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
@@ -41,11 +69,11 @@ namespace JumaRenderEngine
             depthAttachment.flags = 0;
             depthAttachment.format = description.depthFormat;
             depthAttachment.samples = description.sampleCount;
-            depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-            depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-            depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-            depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-            depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            depthAttachment.loadOp = description.depthLoadOp;
+            depthAttachment.storeOp = description.depthStoreOp;
+            depthAttachment.stencilLoadOp = description.depthLoadOp;
+            depthAttachment.stencilStoreOp = description.depthStoreOp;
+            depthAttachment.initialLayout = description.depthLoadOp == VK_ATTACHMENT_LOAD_OP_LOAD ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
             depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
             VkAttachmentReference& depthAttachmentRef = attachmentRefs[1];
             depthAttachmentRef.attachment = 1;
@@ -53,29 +81,41 @@ namespace JumaRenderEngine
         }
         if (resolveEnabled)
         {
-            const int32 index = attachmentCount - 1;
+            const int32 index = mainAttachmentCount - 1;
             VkAttachmentDescription& colorResolveAttachment = attachments[index];
             colorResolveAttachment.flags = 0;
             colorResolveAttachment.format = description.colorFormat;
             colorResolveAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
             colorResolveAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-            colorResolveAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+            colorResolveAttachment.storeOp = description.colorStoreOp;
             colorResolveAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
             colorResolveAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
             colorResolveAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-            colorResolveAttachment.finalLayout = description.renderToSwapchain ? VK_IMAGE_LAYOUT_PRESENT_SRC_KHR : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            colorResolveAttachment.finalLayout = description.renderToSwapchain ? VK_IMAGE_LAYOUT_PRESENT_SRC_KHR : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
             VkAttachmentReference& colorResolveAttachmentRef = attachmentRefs[index];
             colorResolveAttachmentRef.attachment = index;
             colorResolveAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
         }
+        colorAttachmentRefs[0] = colorAttachmentRef;
+        for (uint8 colorIndex = 1; colorIndex < colorAttachmentCount; colorIndex++)
+        {
+            const int32 index = mainAttachmentCount + colorIndex - 1;
+            attachments[index] = colorAttachment;
+            attachments[index].format = description.additionalColorFormats[colorIndex - 1];
+            colorAttachmentRefs[colorIndex].attachment = index;
+            colorAttachmentRefs[colorIndex].layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        }
 
         VkSubpassDescription subpass{};
         subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-        subpass.colorAttachmentCount = 1;
-        subpass.pColorAttachments = &attachmentRefs[0];
+        subpass.colorAttachmentCount = colorAttachmentCount;
+        subpass.pColorAttachments = colorAttachmentRefs;
         subpass.pDepthStencilAttachment = description.shouldUseDepth ? &attachmentRefs[1] : nullptr;
         subpass.pResolveAttachments = resolveEnabled ? &attachmentRefs[2] : nullptr;
-        VkSubpassDependency dependency{};
+        VkSubpassDependency dependencies[2];
+        uint32 dependencyCount = 1;
+        VkSubpassDependency& dependency = dependencies[0];
+        dependency = {};
         dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
         dependency.dstSubpass = 0;
         dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
@@ -87,6 +127,31 @@ namespace JumaRenderEngine
             dependency.srcStageMask |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
             dependency.dstStageMask |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
             dependency.dstAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            if (description.depthLoadOp == VK_ATTACHMENT_LOAD_OP_LOAD)
+            {
+                dependency.srcStageMask |= VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+                dependency.srcAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+                dependency.dstAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+            }
+        }
+        if (description.colorLoadOp == VK_ATTACHMENT_LOAD_OP_LOAD)
+        {
+            dependency.srcAccessMask |= VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            dependency.dstAccessMask |= VK_ACCESS_COLOR_ATTACHMENT_READ_BIT;
+        }
+        if (!description.renderToSwapchain)
+        {
+            // Result is sampled right after the render pass, without copy into separate image
+            dependency.srcStageMask |= VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
+            VkSubpassDependency& resultDependency = dependencies[dependencyCount++];
+            resultDependency = {};
+            resultDependency.srcSubpass = 0;
+            resultDependency.dstSubpass = VK_SUBPASS_EXTERNAL;
+            resultDependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            resultDependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            resultDependency.dstStageMask = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+            resultDependency.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
         }
 
         VkRenderPassCreateInfo renderPassInfo{};
@@ -95,8 +160,8 @@ namespace JumaRenderEngine
         renderPassInfo.pAttachments = attachments;
         renderPassInfo.subpassCount = 1;
         renderPassInfo.pSubpasses = &subpass;
-        renderPassInfo.dependencyCount = 1;
-        renderPassInfo.pDependencies = &dependency;
+        renderPassInfo.dependencyCount = dependencyCount;
+        renderPassInfo.pDependencies = dependencies;
         const VkResult result = vkCreateRenderPass(getRenderEngine<RenderEngine_Vulkan>()->getDevice(), &renderPassInfo, nullptr, &m_RenderPass);
         if (result != VK_SUCCESS)
         {
@@ -108,6 +173,89 @@ namespace JumaRenderEngine
         m_RenderPassTypeID = renderPassTypeID;
         return true;
     }
+    bool VulkanRenderPass::initDepthOnly(const VulkanRenderPassDescription& description, const render_pass_type_id renderPassTypeID)
+    {
+        if (!description.shouldUseDepth || description.renderToSwapchain || (description.sampleCount != VK_SAMPLE_COUNT_1_BIT))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Invalid depth-only render pass description"));
+            return false;
+        }
+        if (getRenderEngine<RenderEngine_Vulkan>()->isDynamicRenderingEnabled())
+        {
+            initDynamicRendering(description, renderPassTypeID);
+            return true;
+        }
+
+        // Depth is the result here, so it's left for sampling as color result of other render passes
+        VkAttachmentDescription depthAttachment;
+        depthAttachment.flags = 0;
+        depthAttachment.format = description.depthFormat;
+        depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+        depthAttachment.loadOp = description.depthLoadOp;
+        depthAttachment.storeOp = description.depthStoreOp;
+        depthAttachment.stencilLoadOp = description.depthLoadOp;
+        depthAttachment.stencilStoreOp = description.depthStoreOp;
+        depthAttachment.initialLayout = description.depthLoadOp == VK_ATTACHMENT_LOAD_OP_LOAD ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+        depthAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        VkAttachmentReference depthAttachmentRef;
+        depthAttachmentRef.attachment = 0;
+        depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+        VkSubpassDescription subpass{};
+        subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpass.colorAttachmentCount = 0;
+        subpass.pColorAttachments = nullptr;
+        subpass.pDepthStencilAttachment = &depthAttachmentRef;
+        VkSubpassDependency dependencies[2];
+        VkSubpassDependency& dependency = dependencies[0];
+        dependency = {};
+        dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+        dependency.dstSubpass = 0;
+        dependency.srcStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT
+            | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        dependency.srcAccessMask = 0;
+        dependency.dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        dependency.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        if (description.depthLoadOp == VK_ATTACHMENT_LOAD_OP_LOAD)
+        {
+            dependency.srcAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            dependency.dstAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+        }
+        VkSubpassDependency& resultDependency = dependencies[1];
+        resultDependency = {};
+        resultDependency.srcSubpass = 0;
+        resultDependency.dstSubpass = VK_SUBPASS_EXTERNAL;
+        resultDependency.srcStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        resultDependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        resultDependency.dstStageMask = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        resultDependency.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+        VkRenderPassCreateInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        renderPassInfo.attachmentCount = 1;
+        renderPassInfo.pAttachments = &depthAttachment;
+        renderPassInfo.subpassCount = 1;
+        renderPassInfo.pSubpasses = &subpass;
+        renderPassInfo.dependencyCount = 2;
+        renderPassInfo.pDependencies = dependencies;
+        const VkResult result = vkCreateRenderPass(getRenderEngine<RenderEngine_Vulkan>()->getDevice(), &renderPassInfo, nullptr, &m_RenderPass);
+        if (result != VK_SUCCESS)
+        {
+            JUMA_RENDER_ERROR_LOG(result, JSTR("Failed to create depth-only render pass"));
+            return false;
+        }
+
+        m_Description = description;
+        m_RenderPassTypeID = renderPassTypeID;
+        return true;
+    }
+    void VulkanRenderPass::initDynamicRendering(const VulkanRenderPassDescription& description, const render_pass_type_id renderPassTypeID)
+    {
+        // Attachments are passed to vkCmdBeginRendering(), so only formats are needed for pipelines
+        m_Description = description;
+        m_RenderPassTypeID = renderPassTypeID;
+        m_DynamicRendering = true;
+    }
 
     void VulkanRenderPass::clearVulkan()
     {
@@ -117,6 +265,7 @@ namespace JumaRenderEngine
             m_RenderPass = nullptr;
         }
         m_RenderPassTypeID = render_pass_type_id_INVALID;
+        m_DynamicRendering = false;
     }
 
     bool VulkanRenderPass::createVulkanSwapchainFramebuffer(const math::uvector2& size, VkImage swapchainImage, VulkanFramebufferData& outFramebuffer) const
@@ -125,64 +274,79 @@ namespace JumaRenderEngine
         {
             return false;
         }
-        return createVulkanFramebufferInternal(size, swapchainImage, outFramebuffer);
+        return createVulkanFramebufferInternal(size, swapchainImage, 1, outFramebuffer);
     }
-    bool VulkanRenderPass::createVulkanFramebuffer(const math::uvector2& size, VulkanFramebufferData& outFramebuffer) const
+    bool VulkanRenderPass::createVulkanFramebuffer(const math::uvector2& size, const uint32 resultMipLevels, VulkanFramebufferData& outFramebuffer) const
     {
-        if (m_Description.renderToSwapchain)
+        if (m_Description.renderToSwapchain || (resultMipLevels == 0))
         {
             return false;
         }
-        return createVulkanFramebufferInternal(size, nullptr, outFramebuffer);
+        if (m_Description.isDepthOnly())
+        {
+            return createDepthOnlyVulkanFramebuffer(size, outFramebuffer);
+        }
+        return createVulkanFramebufferInternal(size, nullptr, resultMipLevels, outFramebuffer);
     }
-    bool VulkanRenderPass::createVulkanFramebufferInternal(const math::uvector2& size, VkImage resultVulkanImage, VulkanFramebufferData& outFramebuffer) const
+    bool VulkanRenderPass::createVulkanFramebufferInternal(const math::uvector2& size, VkImage resultVulkanImage, const uint32 resultMipLevels, 
+        VulkanFramebufferData& outFramebuffer) const
     {
         RenderEngine_Vulkan* renderEngine = getRenderEngine<RenderEngine_Vulkan>();
         const bool resolveEnabled = m_Description.sampleCount != VK_SAMPLE_COUNT_1_BIT;
-        const bool isWindowFramebuffer = m_Description.renderToSwapchain;
 
-        VulkanImage* colorImage = renderEngine->getVulkanImage();
-        if (!resolveEnabled)
+        // Swapchain images are only wrapped, other attachments are taken from the image pool
+        VulkanImageDescription resultImageDescription;
+        resultImageDescription.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        resultImageDescription.size = size;
+        resultImageDescription.sampleCount = VK_SAMPLE_COUNT_1_BIT;
+        resultImageDescription.format = m_Description.colorFormat;
+        resultImageDescription.mipLevels = resultMipLevels;
+        resultImageDescription.aspectFlags = VK_IMAGE_ASPECT_COLOR_BIT;
+
+        VulkanImage* colorImage = nullptr;
+        if (resolveEnabled)
         {
-            if (resultVulkanImage == nullptr)
-            {
-                colorImage->init(
-                   VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, 
-                   { VulkanQueueType::Graphics }, size, m_Description.sampleCount, m_Description.colorFormat, 1
-                );
-            }
-            else
-            {
-                colorImage->init(resultVulkanImage, size, m_Description.colorFormat, 1);
-            }
+            VulkanImageDescription colorImageDescription = resultImageDescription;
+            colorImageDescription.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+            colorImageDescription.sampleCount = m_Description.sampleCount;
+            colorImageDescription.mipLevels = 1;
+            colorImage = renderEngine->getPooledVulkanImage(colorImageDescription);
+        }
+        else if (resultVulkanImage == nullptr)
+        {
+            colorImage = renderEngine->getPooledVulkanImage(resultImageDescription);
         }
         else
         {
-            colorImage->init(
-                VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT, { VulkanQueueType::Graphics },
-                size, m_Description.sampleCount, m_Description.colorFormat, 1
-            );
+            colorImage = renderEngine->getVulkanImage();
+            colorImage->init(resultVulkanImage, size, m_Description.colorFormat, 1);
+            if (!colorImage->createImageView(VK_IMAGE_ASPECT_COLOR_BIT))
+            {
+                renderEngine->returnVulkanImage(colorImage);
+                colorImage = nullptr;
+            }
         }
-        if (!colorImage->createImageView(VK_IMAGE_ASPECT_COLOR_BIT))
+        if (colorImage == nullptr)
         {
             JUMA_RENDER_LOG(error, JSTR("Failed to create color attachment image"));
-            renderEngine->returnVulkanImage(colorImage);
             return false;
         }
 
         VulkanImage* depthImage = nullptr;
         if (m_Description.shouldUseDepth)
         {
-            depthImage = renderEngine->getVulkanImage();
-            depthImage->init(
-                VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT, { VulkanQueueType::Graphics },
-                size, m_Description.sampleCount, m_Description.depthFormat, 1
-            );
-            if (!depthImage->createImageView(VK_IMAGE_ASPECT_DEPTH_BIT))
+            VulkanImageDescription depthImageDescription;
+            depthImageDescription.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+            depthImageDescription.size = size;
+            depthImageDescription.sampleCount = m_Description.sampleCount;
+            depthImageDescription.format = m_Description.depthFormat;
+            depthImageDescription.mipLevels = 1;
+            depthImageDescription.aspectFlags = VK_IMAGE_ASPECT_DEPTH_BIT;
+            depthImage = renderEngine->getPooledVulkanImage(depthImageDescription);
+            if (depthImage == nullptr)
             {
                 JUMA_RENDER_LOG(error, JSTR("Failed to create depth attachment image"));
                 renderEngine->returnVulkanImage(colorImage);
-                renderEngine->returnVulkanImage(depthImage);
                 return false;
             }
         }
@@ -190,84 +354,145 @@ namespace JumaRenderEngine
         VulkanImage* resolveImage = nullptr;
         if (resolveEnabled)
         {
-            resolveImage = renderEngine->getVulkanImage();
             if (resultVulkanImage == nullptr)
             {
-                resolveImage->init(
-                    VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, 
-                    { VulkanQueueType::Graphics }, size, VK_SAMPLE_COUNT_1_BIT, m_Description.colorFormat, 1
-                );
+                resolveImage = renderEngine->getPooledVulkanImage(resultImageDescription);
             }
             else
             {
+                resolveImage = renderEngine->getVulkanImage();
                 resolveImage->init(resultVulkanImage, size, m_Description.colorFormat, 1);
+                if (!resolveImage->createImageView(VK_IMAGE_ASPECT_COLOR_BIT))
+                {
+                    renderEngine->returnVulkanImage(resolveImage);
+                    resolveImage = nullptr;
+                }
             }
-            if (!resolveImage->createImageView(VK_IMAGE_ASPECT_COLOR_BIT))
+            if (resolveImage == nullptr)
             {
                 JUMA_RENDER_LOG(error, JSTR("Failed to create resolve attachment image"));
                 renderEngine->returnVulkanImage(colorImage);
                 renderEngine->returnVulkanImage(depthImage);
-                renderEngine->returnVulkanImage(resolveImage);
                 return false;
             }
         }
 
-        VulkanImage* resultImage = nullptr;
-        if (!isWindowFramebuffer)
-        {
-            resultImage = renderEngine->getVulkanImage();
-            resultImage->init(
-                VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
-                { VulkanQueueType::Graphics }, size, VK_SAMPLE_COUNT_1_BIT, m_Description.colorFormat
-            );
-            if (!resultImage->createImageView(VK_IMAGE_ASPECT_COLOR_BIT))
+        // Additional color attachments don't have mips
+        jarray<VulkanImage*> additionalColorImages;
+        for (uint8 colorIndex = 1; colorIndex < m_Description.getColorAttachmentCount(); colorIndex++)
+        {
+            VulkanImageDescription additionalImageDescription = resultImageDescription;
+            additionalImageDescription.format = m_Description.additionalColorFormats[colorIndex - 1];
+            additionalImageDescription.mipLevels = 1;
+            VulkanImage* additionalImage = renderEngine->getPooledVulkanImage(additionalImageDescription);
+            if (additionalImage == nullptr)
             {
-                JUMA_RENDER_LOG(error, JSTR("Failed to create result image"));
+                JUMA_RENDER_LOG(error, JSTR("Failed to create color attachment image {}"), colorIndex);
                 renderEngine->returnVulkanImage(colorImage);
                 renderEngine->returnVulkanImage(depthImage);
                 renderEngine->returnVulkanImage(resolveImage);
-                renderEngine->returnVulkanImage(resultImage);
+                for (const auto& image : additionalColorImages)
+                {
+                    renderEngine->returnVulkanImage(image);
+                }
                 return false;
             }
+            additionalColorImages.add(additionalImage);
         }
 
-        VkImageView attachments[3];
+        VkImageView attachments[3 + VulkanRenderPassDescription::MaxAdditionalColorAttachmentCount];
         uint8 attachmentCount = 1;
-        attachments[0] = colorImage->getImageView();
+        attachments[0] = colorImage->getAttachmentImageView();
         if (depthImage != nullptr)
         {
             attachments[attachmentCount++] = depthImage->getImageView();
         }
         if (resolveImage != nullptr)
         {
-            attachments[attachmentCount++] = resolveImage->getImageView();
+            attachments[attachmentCount++] = resolveImage->getAttachmentImageView();
+        }
+        for (const auto& image : additionalColorImages)
+        {
+            attachments[attachmentCount++] = image->getAttachmentImageView();
         }
 
-        VkFramebuffer framebuffer;
-        VkFramebufferCreateInfo framebufferInfo{};
-        framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-        framebufferInfo.renderPass = m_RenderPass;
-        framebufferInfo.attachmentCount = attachmentCount;
-        framebufferInfo.pAttachments = attachments;
-        framebufferInfo.width = size.x;
-        framebufferInfo.height = size.y;
-        framebufferInfo.layers = 1;
-        const VkResult result = vkCreateFramebuffer(renderEngine->getDevice(), &framebufferInfo, nullptr, &framebuffer);
-        if (result != VK_SUCCESS)
+        VkFramebuffer framebuffer = nullptr;
+        if (!m_DynamicRendering)
         {
-            JUMA_RENDER_ERROR_LOG(result, JSTR("Failed to create vulkan framebuffer"));
-            renderEngine->returnVulkanImage(colorImage);
-            renderEngine->returnVulkanImage(depthImage);
-            renderEngine->returnVulkanImage(resolveImage);
-            renderEngine->returnVulkanImage(resultImage);
-            return false;
+            VkFramebufferCreateInfo framebufferInfo{};
+            framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+            framebufferInfo.renderPass = m_RenderPass;
+            framebufferInfo.attachmentCount = attachmentCount;
+            framebufferInfo.pAttachments = attachments;
+            framebufferInfo.width = size.x;
+            framebufferInfo.height = size.y;
+            framebufferInfo.layers = 1;
+            const VkResult result = vkCreateFramebuffer(renderEngine->getDevice(), &framebufferInfo, nullptr, &framebuffer);
+            if (result != VK_SUCCESS)
+            {
+                JUMA_RENDER_ERROR_LOG(result, JSTR("Failed to create vulkan framebuffer"));
+                renderEngine->returnVulkanImage(colorImage);
+                renderEngine->returnVulkanImage(depthImage);
+                renderEngine->returnVulkanImage(resolveImage);
+                for (const auto& image : additionalColorImages)
+                {
+                    renderEngine->returnVulkanImage(image);
+                }
+                return false;
+            }
         }
 
         outFramebuffer.framebuffer = framebuffer;
         outFramebuffer.colorAttachment = colorImage;
         outFramebuffer.depthAttachment = depthImage;
         outFramebuffer.resolveAttachment = resolveImage;
-        outFramebuffer.resultImage = resultImage;
+        outFramebuffer.additionalColorAttachments = additionalColorImages;
+        return true;
+    }
+    bool VulkanRenderPass::createDepthOnlyVulkanFramebuffer(const math::uvector2& size, VulkanFramebufferData& outFramebuffer) const
+    {
+        RenderEngine_Vulkan* renderEngine = getRenderEngine<RenderEngine_Vulkan>();
+
+        // Only depth aspect could be sampled, so view doesn't include stencil
+        VulkanImageDescription depthImageDescription;
+        depthImageDescription.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        depthImageDescription.size = size;
+        depthImageDescription.sampleCount = VK_SAMPLE_COUNT_1_BIT;
+        depthImageDescription.format = m_Description.depthFormat;
+        depthImageDescription.mipLevels = 1;
+        depthImageDescription.aspectFlags = VK_IMAGE_ASPECT_DEPTH_BIT;
+        VulkanImage* depthImage = renderEngine->getPooledVulkanImage(depthImageDescription);
+        if (depthImage == nullptr)
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to create depth attachment image"));
+            return false;
+        }
+
+        VkFramebuffer framebuffer = nullptr;
+        if (!m_DynamicRendering)
+        {
+            const VkImageView attachment = depthImage->getImageView();
+            VkFramebufferCreateInfo framebufferInfo{};
+            framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+            framebufferInfo.renderPass = m_RenderPass;
+            framebufferInfo.attachmentCount = 1;
+            framebufferInfo.pAttachments = &attachment;
+            framebufferInfo.width = size.x;
+            framebufferInfo.height = size.y;
+            framebufferInfo.layers = 1;
+            const VkResult result = vkCreateFramebuffer(renderEngine->getDevice(), &framebufferInfo, nullptr, &framebuffer);
+            if (result != VK_SUCCESS)
+            {
+                JUMA_RENDER_ERROR_LOG(result, JSTR("Failed to create vulkan framebuffer"));
+                renderEngine->returnVulkanImage(depthImage);
+                return false;
+            }
+        }
+
+        outFramebuffer.framebuffer = framebuffer;
+        outFramebuffer.colorAttachment = nullptr;
+        outFramebuffer.depthAttachment = depthImage;
+        outFramebuffer.resolveAttachment = nullptr;
         return true;
     }
 }
@@ -24,13 +24,17 @@ namespace JumaRenderEngine
         VulkanRenderPass() = default;
         virtual ~VulkanRenderPass() override;
 
+        // Null if dynamic rendering is used
         VkRenderPass get() const { return m_RenderPass; }
+        bool isDynamicRendering() const { return m_DynamicRendering; }
 
         const VulkanRenderPassDescription& getDescription() const { return m_Description; }
         render_pass_type_id getTypeID() const { return m_RenderPassTypeID; }
 
+        // Framebuffer object is not created for dynamic rendering, only attachment images
         bool createVulkanSwapchainFramebuffer(const math::uvector2& size, VkImage swapchainImage, VulkanFramebufferData& outFramebuffer) const;
-        bool createVulkanFramebuffer(const math::uvector2& size, VulkanFramebufferData& outFramebuffer) const;
+        // Result image (color or resolve attachment) is sampled directly, so it could have mips
+        bool createVulkanFramebuffer(const math::uvector2& size, uint32 resultMipLevels, VulkanFramebufferData& outFramebuffer) const;
 
     private:
 
@@ -38,13 +42,18 @@ namespace JumaRenderEngine
 
         VulkanRenderPassDescription m_Description;
         render_pass_type_id m_RenderPassTypeID = render_pass_type_id_INVALID;
+        bool m_DynamicRendering = false;
 
 
         bool init(const VulkanRenderPassDescription& description, render_pass_type_id renderPassTypeID);
+        bool initDepthOnly(const VulkanRenderPassDescription& description, render_pass_type_id renderPassTypeID);
+        void initDynamicRendering(const VulkanRenderPassDescription& description, render_pass_type_id renderPassTypeID);
 
         void clearVulkan();
 
-        bool createVulkanFramebufferInternal(const math::uvector2& size, VkImage resultVulkanImage, VulkanFramebufferData& outFramebuffer) const;
+        bool createVulkanFramebufferInternal(const math::uvector2& size, VkImage resultVulkanImage, uint32 resultMipLevels, 
+            VulkanFramebufferData& outFramebuffer) const;
+        bool createDepthOnlyVulkanFramebuffer(const math::uvector2& size, VulkanFramebufferData& outFramebuffer) const;
     };
 }
 
@@ -9,21 +9,69 @@
 #include <vulkan/vulkan_core.h>
 
 #include "jutils/juid.h"
+#include "renderEngine/RenderTargetOperations.h"
 
 namespace JumaRenderEngine
 {
     using render_pass_type_id = uint32;
     constexpr render_pass_type_id render_pass_type_id_INVALID = juid<render_pass_type_id>::invalidUID;
 
+    constexpr VkAttachmentLoadOp GetVulkanAttachmentLoadOp(const RenderTargetLoadOperation operation)
+    {
+        switch (operation)
+        {
+        case RenderTargetLoadOperation::Clear: return VK_ATTACHMENT_LOAD_OP_CLEAR;
+        case RenderTargetLoadOperation::Load: return VK_ATTACHMENT_LOAD_OP_LOAD;
+        case RenderTargetLoadOperation::DontCare: return VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        default: ;
+        }
+        return VK_ATTACHMENT_LOAD_OP_CLEAR;
+    }
+    constexpr VkAttachmentStoreOp GetVulkanAttachmentStoreOp(const RenderTargetStoreOperation operation)
+    {
+        return operation == RenderTargetStoreOperation::Store ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    }
+
     struct VulkanRenderPassDescription
     {
+        static constexpr uint8 MaxAdditionalColorAttachmentCount = 7;
+
         VkFormat colorFormat = VK_FORMAT_UNDEFINED;
+        // Only for offscreen render pass without multisampling, list ends with VK_FORMAT_UNDEFINED
+        VkFormat additionalColorFormats[MaxAdditionalColorAttachmentCount] = {};
         VkFormat depthFormat = VK_FORMAT_UNDEFINED;
         VkSampleCountFlagBits sampleCount = VK_SAMPLE_COUNT_1_BIT;
 
         bool shouldUseDepth = true;
         bool renderToSwapchain = true;
 
+        // Don't affect render pass compatibility
+        VkAttachmentLoadOp colorLoadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        VkAttachmentStoreOp colorStoreOp = VK_ATTACHMENT_STORE_OP_STORE;
+        VkAttachmentLoadOp depthLoadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        VkAttachmentStoreOp depthStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+
+        // Render pass without color attachment, depth attachment is sampled after it
+        constexpr bool isDepthOnly() const { return colorFormat == VK_FORMAT_UNDEFINED; }
+        constexpr uint8 getColorAttachmentCount() const
+        {
+            if (isDepthOnly())
+            {
+                return 0;
+            }
+            uint8 count = 1;
+            while ((count <= MaxAdditionalColorAttachmentCount) && (additionalColorFormats[count - 1] != VK_FORMAT_UNDEFINED))
+            {
+                count++;
+            }
+            return count;
+        }
+        constexpr bool hasStencil() const
+        {
+            return shouldUseDepth && ((depthFormat == VK_FORMAT_D16_UNORM_S8_UINT) || (depthFormat == VK_FORMAT_D24_UNORM_S8_UINT) 
+                || (depthFormat == VK_FORMAT_D32_SFLOAT_S8_UINT));
+        }
+
         struct compatible_predicate
         {
             constexpr bool operator()(const VulkanRenderPassDescription& description1, const VulkanRenderPassDescription& description2) const;
@@ -41,6 +89,13 @@ namespace JumaRenderEngine
         {
             return description1.colorFormat < description2.colorFormat;
         }
+        for (uint8 index = 0; index < MaxAdditionalColorAttachmentCount; index++)
+        {
+            if (description1.additionalColorFormats[index] != description2.additionalColorFormats[index])
+            {
+                return description1.additionalColorFormats[index] < description2.additionalColorFormats[index];
+            }
+        }
         if (description1.shouldUseDepth != description2.shouldUseDepth)
         {
             return description2.shouldUseDepth;
@@ -57,7 +112,31 @@ namespace JumaRenderEngine
     constexpr bool VulkanRenderPassDescription::equal_predicate::operator()(const VulkanRenderPassDescription& description1, 
         const VulkanRenderPassDescription& description2) const
     {
-        return compatible_predicate::operator()(description1, description2) || (!description1.renderToSwapchain && description2.renderToSwapchain);
+        if (compatible_predicate::operator()(description1, description2))
+        {
+            return true;
+        }
+        if (compatible_predicate::operator()(description2, description1))
+        {
+            return false;
+        }
+        if (description1.renderToSwapchain != description2.renderToSwapchain)
+        {
+            return description2.renderToSwapchain;
+        }
+        if (description1.colorLoadOp != description2.colorLoadOp)
+        {
+            return description1.colorLoadOp < description2.colorLoadOp;
+        }
+        if (description1.colorStoreOp != description2.colorStoreOp)
+        {
+            return description1.colorStoreOp < description2.colorStoreOp;
+        }
+        if (description1.shouldUseDepth && (description1.depthLoadOp != description2.depthLoadOp))
+        {
+            return description1.depthLoadOp < description2.depthLoadOp;
+        }
+        return description1.shouldUseDepth && (description1.depthStoreOp < description2.depthStoreOp);
     }
 }
 
@@ -0,0 +1,171 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#include "VulkanStagingRing.h"
+
+#if defined(JUMARENDERENGINE_INCLUDE_RENDER_API_VULKAN)
+
+#include "VulkanBuffer.h"
+#include "VulkanImage.h"
+#include "renderEngine/Vulkan/RenderEngine_Vulkan.h"
+
+namespace JumaRenderEngine
+{
+    VulkanStagingRing::~VulkanStagingRing()
+    {
+        clearVulkan();
+    }
+
+    void VulkanStagingRing::clearVulkan()
+    {
+        RenderEngine_Vulkan* renderEngine = getRenderEngine<RenderEngine_Vulkan>();
+        for (auto& frame : m_Frames)
+        {
+            for (const auto& page : frame.pages)
+            {
+                renderEngine->returnVulkanBuffer(page.buffer);
+            }
+            frame.pages.clear();
+            frame.copies.clear();
+            frame.recorded = false;
+        }
+        m_CurrentFrameIndex = 0;
+    }
+
+    bool VulkanStagingRing::addImageCopy(VulkanImage* image, const VkBufferImageCopy& copyRegion, const uint8* data, const uint32 dataSize)
+    {
+        if ((image == nullptr) || (data == nullptr) || (dataSize == 0))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Invalid input params"));
+            return false;
+        }
+
+        FrameData& frame = m_Frames[m_CurrentFrameIndex];
+        if (frame.recorded)
+        {
+            JUMA_RENDER_LOG(error, JSTR("Staging data already recorded for the current frame"));
+            return false;
+        }
+        StagingPage* page = getPage(frame, dataSize);
+        if (page == nullptr)
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to get staging page"));
+            return false;
+        }
+        if (!page->buffer->setMappedData(data, dataSize, page->usedSize))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to write staging data"));
+            return false;
+        }
+
+        ImageCopy& imageCopy = frame.copies.addDefault();
+        imageCopy.image = image;
+        imageCopy.buffer = page->buffer;
+        imageCopy.region = copyRegion;
+        imageCopy.region.bufferOffset = page->usedSize;
+        // Offset should be multiple of texel size and 4
+        page->usedSize += (dataSize + 15) & ~15u;
+        return true;
+    }
+    VulkanStagingRing::StagingPage* VulkanStagingRing::getPage(FrameData& frame, const uint32 size)
+    {
+        for (auto& page : frame.pages)
+        {
+            if ((page.usedSize + size) <= page.buffer->getSize())
+            {
+                return &page;
+            }
+        }
+
+        RenderEngine_Vulkan* renderEngine = getRenderEngine<RenderEngine_Vulkan>();
+        VulkanBuffer* buffer = renderEngine->getVulkanBuffer();
+        if (!buffer->initStaging(math::max(size, PageSize)) || !buffer->initMappedData())
+        {
+            renderEngine->returnVulkanBuffer(buffer);
+            return nullptr;
+        }
+        StagingPage& page = frame.pages.addDefault();
+        page.buffer = buffer;
+        return &page;
+    }
+    void VulkanStagingRing::removeImageCopies(const VulkanImage* image)
+    {
+        jarray<ImageCopy>& copies = m_Frames[m_CurrentFrameIndex].copies;
+        for (int32 index = copies.getSize() - 1; index >= 0; index--)
+        {
+            if (copies[index].image == image)
+            {
+                copies.removeAt(index);
+            }
+        }
+    }
+
+    void VulkanStagingRing::recordCopies(VkCommandBuffer commandBuffer)
+    {
+        FrameData& frame = m_Frames[m_CurrentFrameIndex];
+        if (frame.recorded || frame.copies.isEmpty())
+        {
+            return;
+        }
+
+        // Every image is transitioned once, copies keep the order they were added
+        jarray<VulkanImage*> images;
+        for (const auto& imageCopy : frame.copies)
+        {
+            images.addUnique(imageCopy.image);
+        }
+        constexpr VkPipelineStageFlags shaderStages = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        for (const auto& image : images)
+        {
+            image->changeImageLayout(commandBuffer, 
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_SHADER_READ_BIT, shaderStages,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT
+            );
+            for (const auto& imageCopy : frame.copies)
+            {
+                if (imageCopy.image == image)
+                {
+                    vkCmdCopyBufferToImage(commandBuffer, imageCopy.buffer->get(), image->get(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &imageCopy.region);
+                }
+            }
+            image->changeImageLayout(commandBuffer, 
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_SHADER_READ_BIT, shaderStages
+            );
+        }
+        frame.copies.clear();
+        frame.recorded = true;
+    }
+    void VulkanStagingRing::onFrameRecorded()
+    {
+        if (m_Frames[m_CurrentFrameIndex].recorded)
+        {
+            m_CurrentFrameIndex = (m_CurrentFrameIndex + 1) % 2;
+        }
+    }
+    void VulkanStagingRing::onFrameFinished()
+    {
+        releaseFrame(m_Frames[(m_CurrentFrameIndex + 1) % 2]);
+    }
+    void VulkanStagingRing::releaseFrame(FrameData& frame) const
+    {
+        if (!frame.recorded)
+        {
+            return;
+        }
+
+        // Only one page is kept, others were needed for unusually big updates
+        RenderEngine_Vulkan* renderEngine = getRenderEngine<RenderEngine_Vulkan>();
+        for (int32 index = frame.pages.getSize() - 1; index > 0; index--)
+        {
+            renderEngine->returnVulkanBuffer(frame.pages[index].buffer);
+            frame.pages.removeAt(index);
+        }
+        if (!frame.pages.isEmpty())
+        {
+            frame.pages[0].usedSize = 0;
+        }
+        frame.recorded = false;
+    }
+}
+
+#endif
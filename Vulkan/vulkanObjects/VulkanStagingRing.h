@@ -0,0 +1,73 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#pragma once
+
+#include "renderEngine/juma_render_engine_core.h"
+
+#if defined(JUMARENDERENGINE_INCLUDE_RENDER_API_VULKAN)
+
+#include "renderEngine/RenderEngineContextObject.h"
+
+#include <vulkan/vulkan_core.h>
+
+#include "jutils/jarray.h"
+
+namespace JumaRenderEngine
+{
+    class RenderEngine_Vulkan;
+    class VulkanBuffer;
+    class VulkanImage;
+
+    // Staging memory for the image updates which are recorded into render command buffer at the start of the frame.
+    // One part is filled while other is used by the frame in flight, so updates don't wait for the queue
+    class VulkanStagingRing : public RenderEngineContextObjectBase
+    {
+        friend RenderEngine_Vulkan;
+
+    public:
+        VulkanStagingRing() = default;
+        virtual ~VulkanStagingRing() override;
+
+        static constexpr uint32 PageSize = 4 * 1024 * 1024;
+
+        // Image must be in shader read only layout, copy region buffer offset is filled here
+        bool addImageCopy(VulkanImage* image, const VkBufferImageCopy& copyRegion, const uint8* data, uint32 dataSize);
+        void removeImageCopies(const VulkanImage* image);
+
+        void recordCopies(VkCommandBuffer commandBuffer);
+        // Called when render command buffer recording is finished, even if it wasn't submitted
+        void onFrameRecorded();
+        void onFrameFinished();
+
+    private:
+
+        struct StagingPage
+        {
+            VulkanBuffer* buffer = nullptr;
+            uint32 usedSize = 0;
+        };
+        struct ImageCopy
+        {
+            VulkanImage* image = nullptr;
+            const VulkanBuffer* buffer = nullptr;
+            VkBufferImageCopy region = VkBufferImageCopy();
+        };
+        struct FrameData
+        {
+            jarray<StagingPage> pages;
+            jarray<ImageCopy> copies;
+            bool recorded = false;
+        };
+
+        FrameData m_Frames[2];
+        uint8 m_CurrentFrameIndex = 0;
+
+
+        void clearVulkan();
+
+        StagingPage* getPage(FrameData& frame, uint32 size);
+        void releaseFrame(FrameData& frame) const;
+    };
+}
+
+#endif
@@ -62,10 +62,11 @@ namespace JumaRenderEngine
         VkSurfaceCapabilitiesKHR surfaceCapabilities;
         vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physicalDevice, windowData->vulkanSurface, &surfaceCapabilities);
 
+        const uint32 requestedImageCount = windowData->properties.swapchainImageCount > 0 ? windowData->properties.swapchainImageCount : defaultImageCount;
         uint32 imageCount = math::clamp(
-            defaultImageCount, 
+            requestedImageCount, 
             surfaceCapabilities.minImageCount, 
-            surfaceCapabilities.maxImageCount > 0 ? surfaceCapabilities.maxImageCount : defaultImageCount
+            surfaceCapabilities.maxImageCount > 0 ? surfaceCapabilities.maxImageCount : requestedImageCount
         );
         const VkExtent2D swapchainSize = {
 		    math::clamp(windowData->properties.size.x, surfaceCapabilities.minImageExtent.width, surfaceCapabilities.maxImageExtent.width),
@@ -80,6 +81,7 @@ namespace JumaRenderEngine
                 break;
             }
         }
+        const VkPresentModeKHR presentMode = getSupportedPresentMode(windowData->vulkanSurface, windowData->properties.presentMode);
 
         VkDevice device = renderEngine->getDevice();
         VkSwapchainCreateInfoKHR swapchainInfo{};
@@ -96,7 +98,7 @@ namespace JumaRenderEngine
 		swapchainInfo.pQueueFamilyIndices = nullptr;
         swapchainInfo.preTransform = surfaceCapabilities.currentTransform;
 	    swapchainInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
-	    swapchainInfo.presentMode = VK_PRESENT_MODE_FIFO_KHR;
+	    swapchainInfo.presentMode = presentMode;
 	    swapchainInfo.clipped = VK_TRUE;
 	    swapchainInfo.oldSwapchain = oldSwapchain;
         const VkResult result = vkCreateSwapchainKHR(device, &swapchainInfo, nullptr, &m_Swapchain);
@@ -116,8 +118,35 @@ namespace JumaRenderEngine
 
         m_SwapchainImagesFormat = surfaceFormat.format;
         m_SwapchainImagesSize = { swapchainSize.width, swapchainSize.height };
+        m_PresentMode = presentMode;
+        m_RequestedPresentMode = windowData->properties.presentMode;
+        m_RequestedImageCount = windowData->properties.swapchainImageCount;
         return true;
     }
+    VkPresentModeKHR VulkanSwapchain::getSupportedPresentMode(VkSurfaceKHR surface, const WindowPresentMode presentMode) const
+    {
+        VkPresentModeKHR requestedPresentMode;
+        switch (presentMode)
+        {
+        case WindowPresentMode::FIFORelaxed: requestedPresentMode = VK_PRESENT_MODE_FIFO_RELAXED_KHR; break;
+        case WindowPresentMode::Mailbox:     requestedPresentMode = VK_PRESENT_MODE_MAILBOX_KHR; break;
+        case WindowPresentMode::Immediate:   requestedPresentMode = VK_PRESENT_MODE_IMMEDIATE_KHR; break;
+        default: return VK_PRESENT_MODE_FIFO_KHR;
+        }
+
+        VkPhysicalDevice physicalDevice = getRenderEngine<RenderEngine_Vulkan>()->getPhysicalDevice();
+        uint32 presentModeCount = 0;
+        vkGetPhysicalDeviceSurfacePresentModesKHR(physicalDevice, surface, &presentModeCount, nullptr);
+        jarray<VkPresentModeKHR> presentModes(static_cast<int32>(presentModeCount));
+        vkGetPhysicalDeviceSurfacePresentModesKHR(physicalDevice, surface, &presentModeCount, presentModes.getData());
+        if (presentModes.contains(requestedPresentMode))
+        {
+            return requestedPresentMode;
+        }
+        // FIFO is always supported
+        JUMA_RENDER_LOG(warning, JSTR("Present mode {} is not supported by window {}, FIFO is used"), static_cast<int32>(presentMode), m_WindowID);
+        return VK_PRESENT_MODE_FIFO_KHR;
+    }
 
     void VulkanSwapchain::clearVulkan()
     {
@@ -143,6 +172,9 @@ namespace JumaRenderEngine
         m_AcquiredSwapchainImageIndex = -1;
         m_SwapchainImagesSize = { 0, 0 };
         m_SwapchainImagesFormat = VK_FORMAT_UNDEFINED;
+        m_PresentMode = VK_PRESENT_MODE_FIFO_KHR;
+        m_RequestedPresentMode = WindowPresentMode::FIFO;
+        m_RequestedImageCount = 0;
         m_SwapchainInvalid = false;
         m_WindowID = window_id_INVALID;
     }
@@ -179,7 +211,9 @@ namespace JumaRenderEngine
     {
         if (windowData->windowID == getWindowID())
         {
-            if (windowData->properties.size != m_SwapchainImagesSize)
+            const WindowProperties& properties = windowData->properties;
+            if ((properties.size != m_SwapchainImagesSize) || (properties.presentMode != m_RequestedPresentMode) 
+                || (properties.swapchainImageCount != m_RequestedImageCount))
             {
                 invalidate();
             }
@@ -13,6 +13,7 @@
 #include "jutils/jarray.h"
 #include "jutils/jdelegate_multicast.h"
 #include "jutils/math/vector2.h"
+#include "renderEngine/window/WindowPresentMode.h"
 #include "renderEngine/window/window_id.h"
 
 namespace JumaRenderEngine
@@ -41,6 +42,7 @@ namespace JumaRenderEngine
         const jarray<VkImage>& getImages() const { return m_SwapchainImages; }
         VkFormat getImagesFormat() const { return m_SwapchainImagesFormat; }
         const math::uvector2& getImagesSize() const { return m_SwapchainImagesSize; }
+        VkPresentModeKHR getPresentMode() const { return m_PresentMode; }
 
         VkSemaphore getRenderAvailableSemaphore() const { return m_RenderAvailableSemaphore; }
         int8 getAcquiredImageIndex() const { return m_AcquiredSwapchainImageIndex; }
@@ -58,6 +60,11 @@ namespace JumaRenderEngine
         jarray<VkImage> m_SwapchainImages;
         VkFormat m_SwapchainImagesFormat = VK_FORMAT_UNDEFINED;
         math::uvector2 m_SwapchainImagesSize = { 0, 0 };
+        VkPresentModeKHR m_PresentMode = VK_PRESENT_MODE_FIFO_KHR;
+
+        // Requested in window properties, actual values could be different
+        WindowPresentMode m_RequestedPresentMode = WindowPresentMode::FIFO;
+        uint8 m_RequestedImageCount = 0;
 
         VkSemaphore m_RenderAvailableSemaphore = nullptr;
         int8 m_AcquiredSwapchainImageIndex = -1;
@@ -67,6 +74,7 @@ namespace JumaRenderEngine
 
         bool init(window_id windowID);
         bool createSwapchain(VkSwapchainKHR oldSwapchain);
+        VkPresentModeKHR getSupportedPresentMode(VkSurfaceKHR surface, WindowPresentMode presentMode) const;
 
         void clearVulkan();
 
@@ -0,0 +1,274 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#include "VulkanUploadBatch.h"
+
+#if defined(JUMARENDERENGINE_INCLUDE_RENDER_API_VULKAN)
+
+#include "VulkanCommandPool.h"
+#include "renderEngine/Vulkan/RenderEngine_Vulkan.h"
+
+namespace JumaRenderEngine
+{
+    VulkanUploadBatch::~VulkanUploadBatch()
+    {
+        clearVulkan();
+    }
+
+    bool VulkanUploadBatch::init()
+    {
+        VkSemaphoreTypeCreateInfo semaphoreTypeInfo{};
+        semaphoreTypeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        semaphoreTypeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        semaphoreTypeInfo.initialValue = 0;
+        VkSemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphoreInfo.pNext = &semaphoreTypeInfo;
+        const VkResult result = vkCreateSemaphore(getRenderEngine<RenderEngine_Vulkan>()->getDevice(), &semaphoreInfo, nullptr, &m_TimelineSemaphore);
+        if (result != VK_SUCCESS)
+        {
+            JUMA_RENDER_ERROR_LOG(result, JSTR("Failed to create vulkan timeline semaphore"));
+            return false;
+        }
+        return true;
+    }
+
+    void VulkanUploadBatch::clearVulkan()
+    {
+        if (m_Recording)
+        {
+            submit();
+        }
+        wait(m_LastSubmittedValue);
+
+        if (m_TimelineSemaphore != nullptr)
+        {
+            vkDestroySemaphore(getRenderEngine<RenderEngine_Vulkan>()->getDevice(), m_TimelineSemaphore, nullptr);
+            m_TimelineSemaphore = nullptr;
+        }
+        m_LastSubmittedValue = 0;
+    }
+
+    bool VulkanUploadBatch::begin()
+    {
+        if (m_Recording)
+        {
+            JUMA_RENDER_LOG(warning, JSTR("Upload batch already started"));
+            return false;
+        }
+
+        releaseFinishedBatches();
+        m_Recording = true;
+        return true;
+    }
+    VulkanCommandBuffer* VulkanUploadBatch::startCommandBuffer(const VulkanQueueType queueType) const
+    {
+        VulkanCommandPool* commandPool = getRenderEngine<RenderEngine_Vulkan>()->getCommandPool(queueType);
+        VulkanCommandBuffer* commandBuffer = commandPool != nullptr ? commandPool->getCommandBuffer() : nullptr;
+        if (commandBuffer == nullptr)
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to get command buffer for upload batch"));
+            return nullptr;
+        }
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        const VkResult result = vkBeginCommandBuffer(commandBuffer->get(), &beginInfo);
+        if (result != VK_SUCCESS)
+        {
+            JUMA_RENDER_ERROR_LOG(result, JSTR("Failed to start upload batch command buffer record"));
+            commandBuffer->returnToCommandPool();
+            return nullptr;
+        }
+        return commandBuffer;
+    }
+    VkCommandBuffer VulkanUploadBatch::getTransferCommandBuffer()
+    {
+        if (!m_Recording)
+        {
+            return nullptr;
+        }
+        if (m_TransferCommandBuffer == nullptr)
+        {
+            m_TransferCommandBuffer = startCommandBuffer(VulkanQueueType::Transfer);
+        }
+        return m_TransferCommandBuffer != nullptr ? m_TransferCommandBuffer->get() : nullptr;
+    }
+    VkCommandBuffer VulkanUploadBatch::getGraphicsCommandBuffer()
+    {
+        if (!m_Recording)
+        {
+            return nullptr;
+        }
+        if (m_GraphicsCommandBuffer == nullptr)
+        {
+            m_GraphicsCommandBuffer = startCommandBuffer(VulkanQueueType::Graphics);
+        }
+        return m_GraphicsCommandBuffer != nullptr ? m_GraphicsCommandBuffer->get() : nullptr;
+    }
+    void VulkanUploadBatch::addStagingBuffer(VulkanBuffer* stagingBuffer)
+    {
+        if (stagingBuffer != nullptr)
+        {
+            m_StagingBuffers.add(stagingBuffer);
+        }
+    }
+
+    uint64 VulkanUploadBatch::submit()
+    {
+        if (!m_Recording)
+        {
+            JUMA_RENDER_LOG(warning, JSTR("Upload batch not started"));
+            return 0;
+        }
+        m_Recording = false;
+
+        SubmittedBatch batch;
+        batch.transferCommandBuffer = m_TransferCommandBuffer;
+        batch.graphicsCommandBuffer = m_GraphicsCommandBuffer;
+        batch.stagingBuffers = m_StagingBuffers;
+        m_TransferCommandBuffer = nullptr;
+        m_GraphicsCommandBuffer = nullptr;
+        m_StagingBuffers.clear();
+        if ((batch.transferCommandBuffer == nullptr) && (batch.graphicsCommandBuffer == nullptr))
+        {
+            releaseBatch(batch);
+            return 0;
+        }
+
+        VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        VkTimelineSemaphoreSubmitInfo timelineInfo{};
+        timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.pNext = &timelineInfo;
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = &m_TimelineSemaphore;
+
+        uint64 transferValue = 0;
+        if (batch.transferCommandBuffer != nullptr)
+        {
+            transferValue = m_LastSubmittedValue + 1;
+            timelineInfo.signalSemaphoreValueCount = 1;
+            timelineInfo.pSignalSemaphoreValues = &transferValue;
+
+            vkEndCommandBuffer(batch.transferCommandBuffer->get());
+            if (!batch.transferCommandBuffer->submit(submitInfo, nullptr, false))
+            {
+                JUMA_RENDER_LOG(error, JSTR("Failed to submit transfer command buffer of upload batch"));
+                if (batch.graphicsCommandBuffer != nullptr)
+                {
+                    vkEndCommandBuffer(batch.graphicsCommandBuffer->get());
+                }
+                releaseBatch(batch);
+                return 0;
+            }
+            m_LastSubmittedValue = transferValue;
+        }
+
+        if (batch.graphicsCommandBuffer != nullptr)
+        {
+            // Graphics part works with data copied by transfer part
+            const uint64 graphicsValue = m_LastSubmittedValue + 1;
+            if (transferValue != 0)
+            {
+                submitInfo.waitSemaphoreCount = 1;
+                submitInfo.pWaitSemaphores = &m_TimelineSemaphore;
+                submitInfo.pWaitDstStageMask = &waitStage;
+                timelineInfo.waitSemaphoreValueCount = 1;
+                timelineInfo.pWaitSemaphoreValues = &transferValue;
+            }
+            timelineInfo.signalSemaphoreValueCount = 1;
+            timelineInfo.pSignalSemaphoreValues = &graphicsValue;
+
+            vkEndCommandBuffer(batch.graphicsCommandBuffer->get());
+            if (!batch.graphicsCommandBuffer->submit(submitInfo, nullptr, false))
+            {
+                JUMA_RENDER_LOG(error, JSTR("Failed to submit graphics command buffer of upload batch"));
+                if (transferValue == 0)
+                {
+                    releaseBatch(batch);
+                    return 0;
+                }
+
+                // Staging buffers are still read by transfer part
+                batch.value = transferValue;
+                m_SubmittedBatches.add(batch);
+                return 0;
+            }
+            m_LastSubmittedValue = graphicsValue;
+        }
+
+        batch.value = m_LastSubmittedValue;
+        m_SubmittedBatches.add(batch);
+        return m_LastSubmittedValue;
+    }
+
+    bool VulkanUploadBatch::isFinished(const uint64 value)
+    {
+        releaseFinishedBatches();
+        for (const auto& batch : m_SubmittedBatches)
+        {
+            if (batch.value <= value)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    void VulkanUploadBatch::wait(const uint64 value)
+    {
+        if ((value == 0) || (m_TimelineSemaphore == nullptr))
+        {
+            return;
+        }
+
+        VkSemaphoreWaitInfo waitInfo{};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &m_TimelineSemaphore;
+        waitInfo.pValues = &value;
+        vkWaitSemaphores(getRenderEngine<RenderEngine_Vulkan>()->getDevice(), &waitInfo, UINT64_MAX);
+        releaseFinishedBatches();
+    }
+
+    void VulkanUploadBatch::releaseFinishedBatches()
+    {
+        if (m_SubmittedBatches.isEmpty())
+        {
+            return;
+        }
+
+        uint64 finishedValue = 0;
+        vkGetSemaphoreCounterValue(getRenderEngine<RenderEngine_Vulkan>()->getDevice(), m_TimelineSemaphore, &finishedValue);
+        for (int32 index = m_SubmittedBatches.getSize() - 1; index >= 0; index--)
+        {
+            if (m_SubmittedBatches[index].value <= finishedValue)
+            {
+                releaseBatch(m_SubmittedBatches[index]);
+                m_SubmittedBatches.removeAt(index);
+            }
+        }
+    }
+    void VulkanUploadBatch::releaseBatch(SubmittedBatch& batch) const
+    {
+        RenderEngine_Vulkan* renderEngine = getRenderEngine<RenderEngine_Vulkan>();
+        if (batch.transferCommandBuffer != nullptr)
+        {
+            batch.transferCommandBuffer->returnToCommandPool();
+            batch.transferCommandBuffer = nullptr;
+        }
+        if (batch.graphicsCommandBuffer != nullptr)
+        {
+            batch.graphicsCommandBuffer->returnToCommandPool();
+            batch.graphicsCommandBuffer = nullptr;
+        }
+        for (const auto& stagingBuffer : batch.stagingBuffers)
+        {
+            renderEngine->returnVulkanBuffer(stagingBuffer);
+        }
+        batch.stagingBuffers.clear();
+    }
+}
+
+#endif
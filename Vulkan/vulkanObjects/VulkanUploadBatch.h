@@ -0,0 +1,80 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#pragma once
+
+#include "renderEngine/juma_render_engine_core.h"
+
+#if defined(JUMARENDERENGINE_INCLUDE_RENDER_API_VULKAN)
+
+#include "renderEngine/RenderEngineContextObject.h"
+
+#include <vulkan/vulkan_core.h>
+
+#include "VulkanQueueType.h"
+#include "jutils/jarray.h"
+
+namespace JumaRenderEngine
+{
+    class RenderEngine_Vulkan;
+    class VulkanBuffer;
+    class VulkanCommandBuffer;
+
+    // Records staging copies of many resources and submits them at once, progress is tracked by timeline semaphore
+    class VulkanUploadBatch : public RenderEngineContextObjectBase
+    {
+        friend RenderEngine_Vulkan;
+
+    public:
+        VulkanUploadBatch() = default;
+        virtual ~VulkanUploadBatch() override;
+
+        bool isRecording() const { return m_Recording; }
+
+        VkSemaphore getSemaphore() const { return m_TimelineSemaphore; }
+        uint64 getLastSubmittedValue() const { return m_LastSubmittedValue; }
+
+        // Buffer copies, image copies and layout transitions available on transfer queue
+        VkCommandBuffer getTransferCommandBuffer();
+        // Commands which require graphics queue (mipmaps, final layouts), executed after transfer commands
+        VkCommandBuffer getGraphicsCommandBuffer();
+        // Staging buffer will be returned to render engine after batch finished
+        void addStagingBuffer(VulkanBuffer* stagingBuffer);
+
+        bool isFinished(uint64 value);
+        void wait(uint64 value);
+
+    private:
+
+        struct SubmittedBatch
+        {
+            uint64 value = 0;
+            VulkanCommandBuffer* transferCommandBuffer = nullptr;
+            VulkanCommandBuffer* graphicsCommandBuffer = nullptr;
+            jarray<VulkanBuffer*> stagingBuffers;
+        };
+
+        VkSemaphore m_TimelineSemaphore = nullptr;
+        uint64 m_LastSubmittedValue = 0;
+
+        bool m_Recording = false;
+        VulkanCommandBuffer* m_TransferCommandBuffer = nullptr;
+        VulkanCommandBuffer* m_GraphicsCommandBuffer = nullptr;
+        jarray<VulkanBuffer*> m_StagingBuffers;
+
+        jarray<SubmittedBatch> m_SubmittedBatches;
+
+
+        bool init();
+
+        void clearVulkan();
+
+        bool begin();
+        uint64 submit();
+
+        VulkanCommandBuffer* startCommandBuffer(VulkanQueueType queueType) const;
+        void releaseFinishedBatches();
+        void releaseBatch(SubmittedBatch& batch) const;
+    };
+}
+
+#endif
@@ -0,0 +1,106 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#include "FileMapping.h"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace JumaRenderEngine
+{
+    bool FileMapping::open(const jstring& fileName)
+    {
+        if (isOpened())
+        {
+            JUMA_RENDER_LOG(error, JSTR("File mapping already opened"));
+            return false;
+        }
+
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(*fileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to open file {}"), fileName);
+            return false;
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || (fileSize.QuadPart == 0))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to get size of file {}"), fileName);
+            CloseHandle(file);
+            return false;
+        }
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr)
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to create mapping of file {}"), fileName);
+            CloseHandle(file);
+            return false;
+        }
+        const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (data == nullptr)
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to map file {}"), fileName);
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+
+        m_FileHandle = file;
+        m_MappingHandle = mapping;
+        m_Size = static_cast<uint64>(fileSize.QuadPart);
+#else
+        const int file = ::open(*fileName, O_RDONLY);
+        if (file == -1)
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to open file {}"), fileName);
+            return false;
+        }
+        struct stat fileStat;
+        if ((fstat(file, &fileStat) != 0) || (fileStat.st_size <= 0))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to get size of file {}"), fileName);
+            ::close(file);
+            return false;
+        }
+        void* data = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        // Mapping stays valid after the descriptor is closed
+        ::close(file);
+        if (data == MAP_FAILED)
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to map file {}"), fileName);
+            return false;
+        }
+        madvise(data, static_cast<size_t>(fileStat.st_size), MADV_SEQUENTIAL);
+
+        m_Size = static_cast<uint64>(fileStat.st_size);
+#endif
+        m_Data = static_cast<const uint8*>(data);
+        return true;
+    }
+
+    void FileMapping::close()
+    {
+        if (m_Data == nullptr)
+        {
+            return;
+        }
+
+#if defined(_WIN32)
+        UnmapViewOfFile(m_Data);
+        CloseHandle(m_MappingHandle);
+        CloseHandle(m_FileHandle);
+        m_MappingHandle = nullptr;
+        m_FileHandle = nullptr;
+#else
+        munmap(const_cast<uint8*>(m_Data), static_cast<size_t>(m_Size));
+#endif
+        m_Data = nullptr;
+        m_Size = 0;
+    }
+}
@@ -0,0 +1,38 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#pragma once
+
+#include "renderEngine/juma_render_engine_core.h"
+
+#include "jutils/jstring.h"
+
+namespace JumaRenderEngine
+{
+    // Read-only view of the whole file mapped into memory
+    class FileMapping
+    {
+    public:
+        FileMapping() = default;
+        FileMapping(const FileMapping&) = delete;
+        ~FileMapping() { close(); }
+
+        FileMapping& operator=(const FileMapping&) = delete;
+
+        bool open(const jstring& fileName);
+        bool isOpened() const { return m_Data != nullptr; }
+        void close();
+
+        const uint8* getData() const { return m_Data; }
+        uint64 getSize() const { return m_Size; }
+
+    private:
+
+        const uint8* m_Data = nullptr;
+        uint64 m_Size = 0;
+
+#if defined(_WIN32)
+        void* m_FileHandle = nullptr;
+        void* m_MappingHandle = nullptr;
+#endif
+    };
+}
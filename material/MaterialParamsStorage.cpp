@@ -18,6 +18,7 @@ namespace JumaRenderEngine
         case ShaderUniformType::Vec4: return setValue<ShaderUniformType::Vec4>(name, math::vector4(0));
         case ShaderUniformType::Mat4: return setValue<ShaderUniformType::Mat4>(name, math::matrix4(1));
         case ShaderUniformType::Texture: return setValue<ShaderUniformType::Texture>(name, nullptr);
+        case ShaderUniformType::TextureArray: return setValue<ShaderUniformType::TextureArray>(name, nullptr);
         default: ;
         }
         return false;
@@ -32,6 +33,7 @@ namespace JumaRenderEngine
         case ShaderUniformType::Vec4: return m_MaterialParams_Vec4.remove(name);
         case ShaderUniformType::Mat4: return m_MaterialParams_Mat4.remove(name);
         case ShaderUniformType::Texture: return m_MaterialParams_Texture.remove(name);
+        case ShaderUniformType::TextureArray: return m_MaterialParams_TextureArray.remove(name);
         default: ;
         }
         return false;
@@ -46,6 +48,7 @@ namespace JumaRenderEngine
         case ShaderUniformType::Vec4: return m_MaterialParams_Vec4.contains(name);
         case ShaderUniformType::Mat4: return m_MaterialParams_Mat4.contains(name);
         case ShaderUniformType::Texture: return m_MaterialParams_Texture.contains(name);
+        case ShaderUniformType::TextureArray: return m_MaterialParams_TextureArray.contains(name);
         default: ;
         }
         return false;
@@ -53,6 +56,7 @@ namespace JumaRenderEngine
 
     void MaterialParamsStorage::clear()
     {
+        m_MaterialParams_TextureArray.clear();
         m_MaterialParams_Texture.clear();
         m_MaterialParams_Mat4.clear();
         m_MaterialParams_Vec4.clear();
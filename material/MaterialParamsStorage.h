@@ -49,6 +49,7 @@ namespace JumaRenderEngine
         material_params_map<ShaderUniformType::Vec4> m_MaterialParams_Vec4;
         material_params_map<ShaderUniformType::Mat4> m_MaterialParams_Mat4;
         material_params_map<ShaderUniformType::Texture> m_MaterialParams_Texture;
+        material_params_map<ShaderUniformType::TextureArray> m_MaterialParams_TextureArray;
 
 
         template<ShaderUniformType Type>
@@ -83,6 +84,12 @@ namespace JumaRenderEngine
             m_MaterialParams_Texture[name] = value;
             return true;
         }
+        template<>
+        bool setValueInternal<ShaderUniformType::TextureArray>(const jstringID& name, const ShaderUniformInfo<ShaderUniformType::TextureArray>::value_type& value)
+        {
+            m_MaterialParams_TextureArray[name] = value;
+            return true;
+        }
 
         template<ShaderUniformType Type>
         const typename ShaderUniformInfo<Type>::value_type* findValue(const jstringID& name) const { return nullptr; }
@@ -96,5 +103,7 @@ namespace JumaRenderEngine
         const ShaderUniformInfo<ShaderUniformType::Mat4>::value_type* findValue<ShaderUniformType::Mat4>(const jstringID& name) const { return m_MaterialParams_Mat4.find(name); }
         template<>
         const ShaderUniformInfo<ShaderUniformType::Texture>::value_type* findValue<ShaderUniformType::Texture>(const jstringID& name) const { return m_MaterialParams_Texture.find(name); }
+        template<>
+        const ShaderUniformInfo<ShaderUniformType::TextureArray>::value_type* findValue<ShaderUniformType::TextureArray>(const jstringID& name) const { return m_MaterialParams_TextureArray.find(name); }
     };
 }
@@ -12,7 +12,8 @@ namespace JumaRenderEngine
         Vec2,
         Vec4,
         Mat4,
-        Texture
+        Texture,
+        TextureArray
     };
     enum ShaderStageFlags : uint8
     {
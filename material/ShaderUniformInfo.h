@@ -11,6 +11,7 @@
 
 namespace JumaRenderEngine
 {
+    class TextureArray;
     class TextureBase;
 
     template<ShaderUniformType Type>
@@ -41,6 +42,11 @@ namespace JumaRenderEngine
     {
         using value_type = TextureBase*;
     };
+    template<>
+    struct ShaderUniformInfo<ShaderUniformType::TextureArray> : std::true_type
+    {
+        using value_type = TextureArray*;
+    };
 
     constexpr bool IsShaderUniformScalar(const ShaderUniformType type)
     {
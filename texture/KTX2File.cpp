@@ -0,0 +1,178 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#include "KTX2File.h"
+
+#include <cstring>
+
+#include "renderEngine/RenderEngine.h"
+#include "renderEngine/TextureBase.h"
+
+namespace JumaRenderEngine
+{
+    constexpr uint8 KTX2FileIdentifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+    struct KTX2FileHeader
+    {
+        uint8 identifier[12];
+        uint32 vkFormat;
+        uint32 typeSize;
+        uint32 pixelWidth;
+        uint32 pixelHeight;
+        uint32 pixelDepth;
+        uint32 layerCount;
+        uint32 faceCount;
+        uint32 levelCount;
+        uint32 supercompressionScheme;
+
+        uint32 dfdByteOffset;
+        uint32 dfdByteLength;
+        uint32 kvdByteOffset;
+        uint32 kvdByteLength;
+        uint64 sgdByteOffset;
+        uint64 sgdByteLength;
+    };
+    struct KTX2FileLevel
+    {
+        uint64 byteOffset;
+        uint64 byteLength;
+        uint64 uncompressedByteLength;
+    };
+    static_assert(sizeof(KTX2FileHeader) == 80);
+    static_assert(sizeof(KTX2FileLevel) == 24);
+
+    // KTX2 stores VkFormat values, colorspace is chosen by the render engine
+    bool GetTextureFormatByKTX2Format(const uint32 vkFormat, TextureFormat& outFormat)
+    {
+        switch (vkFormat)
+        {
+        case 37: // VK_FORMAT_R8G8B8A8_UNORM
+        case 43: // VK_FORMAT_R8G8B8A8_SRGB
+            outFormat = TextureFormat::RGBA8; return true;
+        case 44: // VK_FORMAT_B8G8R8A8_UNORM
+        case 50: // VK_FORMAT_B8G8R8A8_SRGB
+            outFormat = TextureFormat::BGRA8; return true;
+        case 133: // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+        case 134: // VK_FORMAT_BC1_RGBA_SRGB_BLOCK
+            outFormat = TextureFormat::BC1_RGBA; return true;
+        case 137: // VK_FORMAT_BC3_UNORM_BLOCK
+        case 138: // VK_FORMAT_BC3_SRGB_BLOCK
+            outFormat = TextureFormat::BC3_RGBA; return true;
+        case 139: // VK_FORMAT_BC4_UNORM_BLOCK
+            outFormat = TextureFormat::BC4_R; return true;
+        case 141: // VK_FORMAT_BC5_UNORM_BLOCK
+            outFormat = TextureFormat::BC5_RG; return true;
+        case 145: // VK_FORMAT_BC7_UNORM_BLOCK
+        case 146: // VK_FORMAT_BC7_SRGB_BLOCK
+            outFormat = TextureFormat::BC7_RGBA; return true;
+        case 147: // VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK
+        case 148: // VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK
+            outFormat = TextureFormat::ETC2_RGB8; return true;
+        case 151: // VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK
+        case 152: // VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK
+            outFormat = TextureFormat::ETC2_RGBA8; return true;
+        default: ;
+        }
+        return false;
+    }
+
+    bool KTX2File::open(const jstring& fileName)
+    {
+        close();
+        if (!m_FileMapping.open(fileName))
+        {
+            return false;
+        }
+
+        const uint8* data = m_FileMapping.getData();
+        const uint64 dataSize = m_FileMapping.getSize();
+        KTX2FileHeader header;
+        if (dataSize < sizeof(KTX2FileHeader))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Invalid KTX2 file {}"), fileName);
+            close();
+            return false;
+        }
+        std::memcpy(&header, data, sizeof(KTX2FileHeader));
+        if (std::memcmp(header.identifier, KTX2FileIdentifier, sizeof(KTX2FileIdentifier)) != 0)
+        {
+            JUMA_RENDER_LOG(error, JSTR("Invalid KTX2 file {}"), fileName);
+            close();
+            return false;
+        }
+
+        TextureFormat format = TextureFormat::RGBA8;
+        if (!GetTextureFormatByKTX2Format(header.vkFormat, format) || (header.supercompressionScheme != 0) || 
+            (header.pixelWidth == 0) || (header.pixelHeight == 0) || (header.pixelDepth > 1) || 
+            (header.layerCount > 1) || (header.faceCount != 1))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Unsupported KTX2 file {}"), fileName);
+            close();
+            return false;
+        }
+
+        // Level count 0 means that mip levels should be generated, it's not supported
+        const uint32 levelCount = header.levelCount;
+        if ((levelCount == 0) || (levelCount > static_cast<uint32>(GetMipLevelCountByTextureSize({ header.pixelWidth, header.pixelHeight }))))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Invalid level count {} in KTX2 file {}"), levelCount, fileName);
+            close();
+            return false;
+        }
+        if ((sizeof(KTX2FileHeader) + static_cast<uint64>(levelCount) * sizeof(KTX2FileLevel)) > dataSize)
+        {
+            JUMA_RENDER_LOG(error, JSTR("Invalid level index in KTX2 file {}"), fileName);
+            close();
+            return false;
+        }
+        jarray<const uint8*> mipLevelsData;
+        mipLevelsData.reserve(static_cast<int32>(levelCount));
+        math::uvector2 levelSize = { header.pixelWidth, header.pixelHeight };
+        for (uint32 levelIndex = 0; levelIndex < levelCount; levelIndex++)
+        {
+            KTX2FileLevel level;
+            std::memcpy(&level, data + sizeof(KTX2FileHeader) + levelIndex * sizeof(KTX2FileLevel), sizeof(KTX2FileLevel));
+            if ((level.byteLength < GetTextureDataSize(format, levelSize.x, levelSize.y)) || (level.byteOffset > dataSize) || (level.byteLength > (dataSize - level.byteOffset)))
+            {
+                JUMA_RENDER_LOG(error, JSTR("Invalid level {} in KTX2 file {}"), levelIndex, fileName);
+                close();
+                return false;
+            }
+            mipLevelsData.add(data + level.byteOffset);
+            levelSize = { math::max(levelSize.x / 2, 1u), math::max(levelSize.y / 2, 1u) };
+        }
+
+        m_Size = { header.pixelWidth, header.pixelHeight };
+        m_Format = format;
+        m_MipLevelsData = std::move(mipLevelsData);
+        return true;
+    }
+
+    void KTX2File::close()
+    {
+        m_MipLevelsData.clear();
+        m_Size = { 0, 0 };
+        m_Format = TextureFormat::RGBA8;
+        m_FileMapping.close();
+    }
+
+    Texture* KTX2File::createTexture(RenderEngine* renderEngine) const
+    {
+        if ((renderEngine == nullptr) || !isOpened())
+        {
+            JUMA_RENDER_LOG(error, JSTR("Invalid input params"));
+            return nullptr;
+        }
+        return renderEngine->createTexture(m_Size, m_Format, m_MipLevelsData);
+    }
+
+    Texture* LoadKTX2Texture(RenderEngine* renderEngine, const jstring& fileName)
+    {
+        KTX2File file;
+        if (!file.open(fileName))
+        {
+            return nullptr;
+        }
+        // Data is copied to the staging memory, so the file can be closed right after creation
+        return file.createTexture(renderEngine);
+    }
+}
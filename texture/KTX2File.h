@@ -0,0 +1,50 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#pragma once
+
+#include "renderEngine/juma_render_engine_core.h"
+
+#include "TextureFormat.h"
+#include "jutils/jarray.h"
+#include "jutils/jstring.h"
+#include "jutils/math/vector2.h"
+#include "renderEngine/file/FileMapping.h"
+
+namespace JumaRenderEngine
+{
+    class RenderEngine;
+    class Texture;
+
+    // KTX2 container with 2D texture. Supercompressed, array, cube and 3D textures are not supported.
+    // Mip levels are read straight from the mapped file
+    class KTX2File
+    {
+    public:
+        KTX2File() = default;
+        KTX2File(const KTX2File&) = delete;
+        ~KTX2File() = default;
+
+        KTX2File& operator=(const KTX2File&) = delete;
+
+        bool open(const jstring& fileName);
+        bool isOpened() const { return m_FileMapping.isOpened(); }
+        void close();
+
+        const math::uvector2& getSize() const { return m_Size; }
+        TextureFormat getFormat() const { return m_Format; }
+        // From the biggest level. Only one level means that the file doesn't contain mip chain
+        const jarray<const uint8*>& getMipLevelsData() const { return m_MipLevelsData; }
+
+        Texture* createTexture(RenderEngine* renderEngine) const;
+
+    private:
+
+        FileMapping m_FileMapping;
+
+        math::uvector2 m_Size = { 0, 0 };
+        TextureFormat m_Format = TextureFormat::RGBA8;
+        jarray<const uint8*> m_MipLevelsData;
+    };
+
+    Texture* LoadKTX2Texture(RenderEngine* renderEngine, const jstring& fileName);
+}
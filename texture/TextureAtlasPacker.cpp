@@ -0,0 +1,132 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#include "TextureAtlasPacker.h"
+
+#include <cstring>
+
+#include "renderEngine/RenderEngine.h"
+
+namespace JumaRenderEngine
+{
+    bool TextureAtlasPacker::init(const math::uvector2& layerSize, const TextureFormat format, const uint32 maxLayerCount, const uint32 padding)
+    {
+        if ((layerSize.x == 0) || (layerSize.y == 0) || (maxLayerCount == 0) || (GetTextureFormatSize(format) == 0))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Invalid input params"));
+            return false;
+        }
+
+        clear();
+        m_LayerSize = layerSize;
+        m_Format = format;
+        m_MaxLayerCount = maxLayerCount;
+        m_Padding = padding;
+        return true;
+    }
+    void TextureAtlasPacker::clear()
+    {
+        m_Layers.clear();
+        m_LayerSize = { 0, 0 };
+        m_MaxLayerCount = 0;
+        m_Padding = 0;
+    }
+
+    bool TextureAtlasPacker::addImage(const math::uvector2& size, const uint8* data, TextureAtlasRegion& outRegion)
+    {
+        if (!isValid())
+        {
+            JUMA_RENDER_LOG(error, JSTR("Texture atlas packer not initialized"));
+            return false;
+        }
+        if ((size.x == 0) || (size.y == 0) || (size.x > m_LayerSize.x) || (size.y > m_LayerSize.y) || (data == nullptr))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Invalid input params"));
+            return false;
+        }
+
+        // Padding on the right and bottom sides, it could be clipped by the layer border
+        const math::uvector2 paddedSize = { math::min(size.x + m_Padding, m_LayerSize.x), math::min(size.y + m_Padding, m_LayerSize.y) };
+        math::uvector2 offset = { 0, 0 };
+        int32 layerIndex = 0;
+        for (; layerIndex < m_Layers.getSize(); layerIndex++)
+        {
+            if (findPlaceInLayer(m_Layers[layerIndex], paddedSize, offset))
+            {
+                break;
+            }
+        }
+        if (layerIndex == m_Layers.getSize())
+        {
+            if (static_cast<uint32>(m_Layers.getSize()) >= m_MaxLayerCount)
+            {
+                JUMA_RENDER_LOG(error, JSTR("Not enough space in texture atlas for image {}x{}"), size.x, size.y);
+                return false;
+            }
+            Layer& layer = m_Layers.addDefault();
+            layer.data = jarray<uint8>(static_cast<int32>(GetTextureDataSize(m_Format, m_LayerSize.x, m_LayerSize.y)), 0);
+            findPlaceInLayer(layer, paddedSize, offset);
+        }
+
+        copyImage(m_Layers[layerIndex], offset, size, data);
+        outRegion.layer = static_cast<uint32>(layerIndex);
+        outRegion.offset = offset;
+        outRegion.size = size;
+        outRegion.uvMin = { static_cast<float>(offset.x) / m_LayerSize.x, static_cast<float>(offset.y) / m_LayerSize.y };
+        outRegion.uvMax = { static_cast<float>(offset.x + size.x) / m_LayerSize.x, static_cast<float>(offset.y + size.y) / m_LayerSize.y };
+        return true;
+    }
+    bool TextureAtlasPacker::findPlaceInLayer(Layer& layer, const math::uvector2& size, math::uvector2& outOffset) const
+    {
+        // Best fit by height among existing shelves
+        Shelf* bestShelf = nullptr;
+        for (auto& shelf : layer.shelves)
+        {
+            if ((shelf.height >= size.y) && ((shelf.usedWidth + size.x) <= m_LayerSize.x) && 
+                ((bestShelf == nullptr) || (shelf.height < bestShelf->height)))
+            {
+                bestShelf = &shelf;
+            }
+        }
+        if (bestShelf != nullptr)
+        {
+            outOffset = { bestShelf->usedWidth, bestShelf->y };
+            bestShelf->usedWidth += size.x;
+            return true;
+        }
+
+        if ((layer.usedHeight + size.y) > m_LayerSize.y)
+        {
+            return false;
+        }
+        layer.shelves.add({ layer.usedHeight, size.y, size.x });
+        outOffset = { 0, layer.usedHeight };
+        layer.usedHeight += size.y;
+        return true;
+    }
+    void TextureAtlasPacker::copyImage(Layer& layer, const math::uvector2& offset, const math::uvector2& size, const uint8* data) const
+    {
+        const uint32 pixelSize = GetTextureFormatSize(m_Format);
+        const uint32 rowSize = size.x * pixelSize;
+        for (uint32 y = 0; y < size.y; y++)
+        {
+            std::memcpy(layer.data.getData() + ((offset.y + y) * m_LayerSize.x + offset.x) * pixelSize, data + y * rowSize, rowSize);
+        }
+    }
+
+    TextureArray* TextureAtlasPacker::createTextureArray(RenderEngine* renderEngine) const
+    {
+        if ((renderEngine == nullptr) || m_Layers.isEmpty())
+        {
+            JUMA_RENDER_LOG(error, JSTR("Invalid input params"));
+            return nullptr;
+        }
+
+        jarray<const uint8*> layersData;
+        layersData.reserve(m_Layers.getSize());
+        for (const auto& layer : m_Layers)
+        {
+            layersData.add(layer.data.getData());
+        }
+        return renderEngine->createTextureArray(m_LayerSize, m_Format, layersData);
+    }
+}
@@ -0,0 +1,74 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#pragma once
+
+#include "renderEngine/juma_render_engine_core.h"
+
+#include "TextureFormat.h"
+#include "jutils/jarray.h"
+#include "jutils/math/vector2.h"
+
+namespace JumaRenderEngine
+{
+    class RenderEngine;
+    class TextureArray;
+
+    struct TextureAtlasRegion
+    {
+        uint32 layer = 0;
+        math::uvector2 offset = { 0, 0 };
+        math::uvector2 size = { 0, 0 };
+
+        // Texture coordinates of the region in its layer
+        math::vector2 uvMin = { 0.0f, 0.0f };
+        math::vector2 uvMax = { 0.0f, 0.0f };
+    };
+
+    // Packs small images into layers of the texture array using shelves. Images are copied into CPU side layers,
+    // so the texture array is created from all of them at once and many sprites can share one material
+    class TextureAtlasPacker
+    {
+    public:
+        TextureAtlasPacker() = default;
+
+        static constexpr uint32 DefaultMaxLayerCount = 16;
+
+        bool init(const math::uvector2& layerSize, TextureFormat format, uint32 maxLayerCount = DefaultMaxLayerCount, uint32 padding = 1);
+        bool isValid() const { return m_LayerSize.x > 0; }
+        void clear();
+
+        const math::uvector2& getLayerSize() const { return m_LayerSize; }
+        TextureFormat getFormat() const { return m_Format; }
+        uint32 getLayerCount() const { return static_cast<uint32>(m_Layers.getSize()); }
+
+        bool addImage(const math::uvector2& size, const uint8* data, TextureAtlasRegion& outRegion);
+
+        TextureArray* createTextureArray(RenderEngine* renderEngine) const;
+
+    private:
+
+        struct Shelf
+        {
+            uint32 y = 0;
+            uint32 height = 0;
+            uint32 usedWidth = 0;
+        };
+        struct Layer
+        {
+            jarray<uint8> data;
+            jarray<Shelf> shelves;
+            uint32 usedHeight = 0;
+        };
+
+        math::uvector2 m_LayerSize = { 0, 0 };
+        TextureFormat m_Format = TextureFormat::RGBA8;
+        uint32 m_MaxLayerCount = 0;
+        uint32 m_Padding = 0;
+
+        jarray<Layer> m_Layers;
+
+
+        bool findPlaceInLayer(Layer& layer, const math::uvector2& size, math::uvector2& outOffset) const;
+        void copyImage(Layer& layer, const math::uvector2& offset, const math::uvector2& size, const uint8* data) const;
+    };
+}
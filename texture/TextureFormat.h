@@ -10,22 +10,107 @@ namespace JumaRenderEngine
     {
         RGBA8,
         BGRA8,
+        R8,
+        RG8,
+        R16F,
+        RG16F,
+        RGBA16F,
+        R32F,
+        R11G11B10F,
         DEPTH32,
-        DEPTH24_STENCIL8
+        DEPTH24_STENCIL8,
+
+        // Block-compressed formats, each block is 4x4 texels
+        BC1_RGBA,
+        BC3_RGBA,
+        BC4_R,
+        BC5_RG,
+        BC7_RGBA,
+        ETC2_RGB8,
+        ETC2_RGBA8
     };
 
+    constexpr bool IsTextureFormatDepth(const TextureFormat format)
+    {
+        return (format == TextureFormat::DEPTH32) || (format == TextureFormat::DEPTH24_STENCIL8);
+    }
+    constexpr bool IsTextureFormatCompressed(const TextureFormat format)
+    {
+        switch (format)
+        {
+        case TextureFormat::BC1_RGBA:
+        case TextureFormat::BC3_RGBA:
+        case TextureFormat::BC4_R:
+        case TextureFormat::BC5_RG:
+        case TextureFormat::BC7_RGBA:
+        case TextureFormat::ETC2_RGB8:
+        case TextureFormat::ETC2_RGBA8:
+            return true;
+
+        default: ;
+        }
+        return false;
+    }
+    constexpr uint32 GetTextureFormatBlockSize(const TextureFormat format)
+    {
+        switch (format)
+        {
+        case TextureFormat::BC1_RGBA:
+        case TextureFormat::BC4_R:
+        case TextureFormat::ETC2_RGB8:
+            return 8;
+
+        case TextureFormat::BC3_RGBA:
+        case TextureFormat::BC5_RG:
+        case TextureFormat::BC7_RGBA:
+        case TextureFormat::ETC2_RGBA8:
+            return 16;
+
+        default: ;
+        }
+        return 0;
+    }
+
+    // Bytes per texel, 0 for block-compressed formats
     constexpr uint32 GetTextureFormatSize(const TextureFormat format)
     {
         switch (format)
         {
+        case TextureFormat::R8:
+            return 1;
+
+        case TextureFormat::RG8:
+        case TextureFormat::R16F:
+            return 2;
+
         case TextureFormat::RGBA8:
         case TextureFormat::BGRA8:
+        case TextureFormat::RG16F:
+        case TextureFormat::R32F:
+        case TextureFormat::R11G11B10F:
         case TextureFormat::DEPTH32:
         case TextureFormat::DEPTH24_STENCIL8:
             return 4;
 
+        case TextureFormat::RGBA16F:
+            return 8;
+
         default: ;
         }
         return 0;
     }
+
+    // Size of one row of texels (row of blocks for compressed formats)
+    constexpr uint32 GetTextureRowPitch(const TextureFormat format, const uint32 width)
+    {
+        return IsTextureFormatCompressed(format) ? ((width + 3) / 4) * GetTextureFormatBlockSize(format) : width * GetTextureFormatSize(format);
+    }
+    constexpr uint32 GetTextureRowCount(const TextureFormat format, const uint32 height)
+    {
+        return IsTextureFormatCompressed(format) ? (height + 3) / 4 : height;
+    }
+    constexpr uint32 GetTextureDataSize(const TextureFormat format, const uint32 width, const uint32 height)
+    {
+        return GetTextureRowPitch(format, width) * GetTextureRowCount(format, height);
+    }
 }
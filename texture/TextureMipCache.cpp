@@ -0,0 +1,166 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#include "TextureMipCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "renderEngine/TextureBase.h"
+#include "renderEngine/file/FileMapping.h"
+
+namespace JumaRenderEngine
+{
+    bool TextureMipCache::init(const jstring& directory)
+    {
+        std::error_code error;
+        std::filesystem::create_directories(*directory, error);
+        if (error || !std::filesystem::is_directory(*directory, error))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Can't create mip cache directory {}"), directory);
+            return false;
+        }
+
+        m_Directory = directory;
+        m_Initialized = true;
+        return true;
+    }
+
+    uint64 TextureMipCache::getSourceHash(const TextureMipSource& source, const TextureMipFilter filter)
+    {
+        // FNV-1a
+        constexpr uint64 prime = 1099511628211ull;
+        uint64 hash = 14695981039346656037ull;
+        const auto hashData = [&hash](const uint8* data, const uint64 size)
+        {
+            for (uint64 index = 0; index < size; index++)
+            {
+                hash = (hash ^ data[index]) * prime;
+            }
+        };
+        const uint32 params[5] = { source.size.x, source.size.y, static_cast<uint32>(source.format), static_cast<uint32>(filter), source.srgb ? 1u : 0u };
+        hashData(reinterpret_cast<const uint8*>(params), sizeof(params));
+        hashData(source.data, GetTextureDataSize(source.format, source.size.x, source.size.y));
+        return hash;
+    }
+    jstring TextureMipCache::getFileName(const uint64 sourceHash) const
+    {
+        char fileName[32];
+        std::snprintf(fileName, sizeof(fileName), "%016llx.jmip", static_cast<unsigned long long>(sourceHash));
+        return jstring((std::filesystem::path(*m_Directory) / fileName).string().c_str());
+    }
+
+    bool TextureMipCache::load(const TextureMipSource& source, const TextureMipFilter filter, TextureMipChain& outMipChain) const
+    {
+        if (!isValid() || (source.data == nullptr))
+        {
+            return false;
+        }
+
+        const uint64 sourceHash = getSourceHash(source, filter);
+        const jstring fileName = getFileName(sourceHash);
+        std::error_code error;
+        if (!std::filesystem::exists(*fileName, error))
+        {
+            return false;
+        }
+        FileMapping fileMapping;
+        if (!fileMapping.open(fileName))
+        {
+            return false;
+        }
+
+        const uint8* data = fileMapping.getData();
+        const uint64 dataSize = fileMapping.getSize();
+        TextureMipCacheFileHeader header;
+        if (dataSize < sizeof(TextureMipCacheFileHeader))
+        {
+            JUMA_RENDER_LOG(warning, JSTR("Invalid mip cache file {}"), fileName);
+            return false;
+        }
+        std::memcpy(&header, data, sizeof(TextureMipCacheFileHeader));
+        if ((header.magic != TextureMipCacheFileMagic) || (header.version != TextureMipCacheFileVersion) || (header.sourceHash != sourceHash) ||
+            (header.width != source.size.x) || (header.height != source.size.y) || (header.format != source.format) || (header.filter != filter) ||
+            (header.srgb != source.srgb) || (header.mipLevelCount != static_cast<uint32>(GetMipLevelCountByTextureSize(source.size))))
+        {
+            JUMA_RENDER_LOG(warning, JSTR("Mip cache file {} doesn't match source texture"), fileName);
+            return false;
+        }
+
+        TextureMipChain mipChain;
+        mipChain.size = source.size;
+        mipChain.format = source.format;
+        mipChain.mipLevels.reserve(static_cast<int32>(header.mipLevelCount));
+        uint64 offset = sizeof(TextureMipCacheFileHeader);
+        math::uvector2 levelSize = source.size;
+        for (uint32 level = 0; level < header.mipLevelCount; level++)
+        {
+            const uint32 levelDataSize = GetTextureDataSize(source.format, levelSize.x, levelSize.y);
+            if ((offset > dataSize) || (levelDataSize > (dataSize - offset)))
+            {
+                JUMA_RENDER_LOG(warning, JSTR("Mip cache file {} is truncated"), fileName);
+                return false;
+            }
+            jarray<uint8>& levelData = mipChain.mipLevels.addDefault();
+            levelData = jarray<uint8>(static_cast<int32>(levelDataSize), 0);
+            std::memcpy(levelData.getData(), data + offset, levelDataSize);
+            offset += levelDataSize;
+            levelSize = { math::max(levelSize.x / 2, 1u), math::max(levelSize.y / 2, 1u) };
+        }
+
+        outMipChain = std::move(mipChain);
+        return true;
+    }
+    bool TextureMipCache::save(const TextureMipSource& source, const TextureMipFilter filter, const TextureMipChain& mipChain) const
+    {
+        if (!isValid() || (source.data == nullptr) || mipChain.mipLevels.isEmpty())
+        {
+            JUMA_RENDER_LOG(error, JSTR("Invalid input params"));
+            return false;
+        }
+
+        TextureMipCacheFileHeader header;
+        header.sourceHash = getSourceHash(source, filter);
+        header.width = source.size.x;
+        header.height = source.size.y;
+        header.format = source.format;
+        header.filter = filter;
+        header.srgb = source.srgb;
+        header.mipLevelCount = static_cast<uint32>(mipChain.mipLevels.getSize());
+
+        const jstring fileName = getFileName(header.sourceHash);
+        std::ofstream file(*fileName, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            JUMA_RENDER_LOG(error, JSTR("Can't open file {}"), fileName);
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const auto& mipLevel : mipChain.mipLevels)
+        {
+            file.write(reinterpret_cast<const char*>(mipLevel.getData()), mipLevel.getSize());
+        }
+        if (!file.good())
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to write mip cache file {}"), fileName);
+            return false;
+        }
+        return true;
+    }
+
+    bool TextureMipCache::getMipChain(const TextureMipSource& source, const TextureMipFilter filter, TextureMipChain& outMipChain) const
+    {
+        if (load(source, filter, outMipChain))
+        {
+            return true;
+        }
+        if (!GenerateTextureMipChain(source, filter, outMipChain))
+        {
+            return false;
+        }
+        // Failed save only means that the chain will be generated again next time
+        save(source, filter, outMipChain);
+        return true;
+    }
+}
@@ -0,0 +1,55 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#pragma once
+
+#include "renderEngine/juma_render_engine_core.h"
+
+#include "TextureMipGenerator.h"
+#include "jutils/jstring.h"
+
+namespace JumaRenderEngine
+{
+    // Layout of the cache file: header and all mip levels one after another, from the biggest one
+    constexpr uint32 TextureMipCacheFileMagic = 0x50494D4A; // "JMIP"
+    constexpr uint32 TextureMipCacheFileVersion = 2;
+
+    struct TextureMipCacheFileHeader
+    {
+        uint32 magic = TextureMipCacheFileMagic;
+        uint32 version = TextureMipCacheFileVersion;
+
+        uint64 sourceHash = 0;
+        uint32 width = 0;
+        uint32 height = 0;
+        TextureFormat format = TextureFormat::RGBA8;
+        TextureMipFilter filter = TextureMipFilter::Box;
+        bool srgb = false;
+        uint8 reserved = 0;
+        uint32 mipLevelCount = 0;
+    };
+
+    // Stores generated mip chains on disk, file is found by the hash of the source image and filter
+    class TextureMipCache
+    {
+    public:
+        TextureMipCache() = default;
+
+        bool init(const jstring& directory);
+        bool isValid() const { return m_Initialized; }
+
+        bool load(const TextureMipSource& source, TextureMipFilter filter, TextureMipChain& outMipChain) const;
+        bool save(const TextureMipSource& source, TextureMipFilter filter, const TextureMipChain& mipChain) const;
+
+        // Loads chain from the cache or generates and saves it
+        bool getMipChain(const TextureMipSource& source, TextureMipFilter filter, TextureMipChain& outMipChain) const;
+
+    private:
+
+        jstring m_Directory;
+        bool m_Initialized = false;
+
+
+        static uint64 getSourceHash(const TextureMipSource& source, TextureMipFilter filter);
+        jstring getFileName(uint64 sourceHash) const;
+    };
+}
@@ -0,0 +1,344 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#include "TextureMipGenerator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+#include "renderEngine/RenderEngine.h"
+#include "renderEngine/TextureBase.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define JUMARENDERENGINE_MIP_GENERATOR_SSE
+#include <emmintrin.h>
+#endif
+
+namespace JumaRenderEngine
+{
+    // Images are processed as 4 linear floats per pixel, so every pixel is one SIMD register
+    constexpr uint32 MipPixelChannelCount = 4;
+    using MipImage = jarray<float>;
+
+    constexpr uint32 KaiserTapCount = 6;
+    constexpr float KaiserAlpha = 4.0f;
+    constexpr float KaiserWidth = 1.5f;
+
+    struct SRGBTables
+    {
+        SRGBTables()
+        {
+            for (uint32 value = 0; value < 256; value++)
+            {
+                const float srgb = static_cast<float>(value) / 255.0f;
+                toLinear[value] = srgb <= 0.04045f ? srgb / 12.92f : std::pow((srgb + 0.055f) / 1.055f, 2.4f);
+            }
+            // Linear value closer to the next sRGB value than to the current one
+            for (uint32 value = 0; value < 255; value++)
+            {
+                const float srgb = (static_cast<float>(value) + 0.5f) / 255.0f;
+                thresholds[value] = srgb <= 0.04045f ? srgb / 12.92f : std::pow((srgb + 0.055f) / 1.055f, 2.4f);
+            }
+        }
+
+        float toLinear[256];
+        float thresholds[255];
+    };
+    const SRGBTables& GetSRGBTables()
+    {
+        static const SRGBTables tables;
+        return tables;
+    }
+
+    float GetBesselI0(const float x)
+    {
+        float sum = 1.0f;
+        float term = 1.0f;
+        for (uint32 index = 1; index < 16; index++)
+        {
+            const float value = x / (2.0f * static_cast<float>(index));
+            term *= value * value;
+            sum += term;
+        }
+        return sum;
+    }
+    struct KaiserWeights
+    {
+        KaiserWeights()
+        {
+            // Distances from the center of destination pixel to the source pixel centers in destination pixels
+            float sum = 0.0f;
+            for (uint32 index = 0; index < KaiserTapCount; index++)
+            {
+                const float distance = (static_cast<float>(index) - 2.5f) * 0.5f;
+                const float sinc = std::sin(3.14159265f * distance) / (3.14159265f * distance);
+                const float ratio = distance / KaiserWidth;
+                const float window = GetBesselI0(KaiserAlpha * std::sqrt(1.0f - ratio * ratio)) / GetBesselI0(KaiserAlpha);
+                weights[index] = sinc * window;
+                sum += weights[index];
+            }
+            for (float& weight : weights)
+            {
+                weight /= sum;
+            }
+        }
+
+        float weights[KaiserTapCount];
+    };
+    const KaiserWeights& GetKaiserWeights()
+    {
+        static const KaiserWeights weights;
+        return weights;
+    }
+
+    uint32 GetMipChannelCount(const TextureFormat format)
+    {
+        switch (format)
+        {
+        case TextureFormat::R8: return 1;
+        case TextureFormat::RG8: return 2;
+        default: ;
+        }
+        return 4;
+    }
+    void DecodeMipImage(const uint8* data, const math::uvector2& size, const TextureFormat format, const bool srgb, MipImage& outImage)
+    {
+        const SRGBTables& tables = GetSRGBTables();
+        const uint32 channelCount = GetMipChannelCount(format);
+        const uint32 pixelCount = size.x * size.y;
+        outImage = MipImage(static_cast<int32>(pixelCount * MipPixelChannelCount), 0.0f);
+        float* pixels = outImage.getData();
+        for (uint32 pixelIndex = 0; pixelIndex < pixelCount; pixelIndex++)
+        {
+            for (uint32 channel = 0; channel < channelCount; channel++)
+            {
+                const uint8 value = data[pixelIndex * channelCount + channel];
+                // Alpha is always linear
+                pixels[pixelIndex * MipPixelChannelCount + channel] = srgb && (channel < 3) ? tables.toLinear[value] : static_cast<float>(value) / 255.0f;
+            }
+        }
+    }
+    void EncodeMipImage(const MipImage& image, const math::uvector2& size, const TextureFormat format, const bool srgb, jarray<uint8>& outData)
+    {
+        const SRGBTables& tables = GetSRGBTables();
+        const uint32 channelCount = GetMipChannelCount(format);
+        const uint32 pixelCount = size.x * size.y;
+        outData = jarray<uint8>(static_cast<int32>(pixelCount * channelCount), 0);
+        const float* pixels = image.getData();
+        for (uint32 pixelIndex = 0; pixelIndex < pixelCount; pixelIndex++)
+        {
+            for (uint32 channel = 0; channel < channelCount; channel++)
+            {
+                // Negative lobes of Kaiser filter could go out of range
+                const float value = math::clamp(pixels[pixelIndex * MipPixelChannelCount + channel], 0.0f, 1.0f);
+                outData[static_cast<int32>(pixelIndex * channelCount + channel)] = srgb && (channel < 3)
+                    ? static_cast<uint8>(std::upper_bound(tables.thresholds, tables.thresholds + 255, value) - tables.thresholds)
+                    : static_cast<uint8>(value * 255.0f + 0.5f);
+            }
+        }
+    }
+
+#if defined(JUMARENDERENGINE_MIP_GENERATOR_SSE)
+    inline void AverageMipPixels(float* dst, const float* src0, const float* src1, const float* src2, const float* src3)
+    {
+        const __m128 sum = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(src0), _mm_loadu_ps(src1)), _mm_add_ps(_mm_loadu_ps(src2), _mm_loadu_ps(src3)));
+        _mm_storeu_ps(dst, _mm_mul_ps(sum, _mm_set1_ps(0.25f)));
+    }
+    inline void FilterMipPixel(float* dst, const float* const* src, const float* weights)
+    {
+        __m128 sum = _mm_setzero_ps();
+        for (uint32 index = 0; index < KaiserTapCount; index++)
+        {
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(src[index]), _mm_set1_ps(weights[index])));
+        }
+        _mm_storeu_ps(dst, sum);
+    }
+#else
+    inline void AverageMipPixels(float* dst, const float* src0, const float* src1, const float* src2, const float* src3)
+    {
+        for (uint32 channel = 0; channel < MipPixelChannelCount; channel++)
+        {
+            dst[channel] = (src0[channel] + src1[channel] + src2[channel] + src3[channel]) * 0.25f;
+        }
+    }
+    inline void FilterMipPixel(float* dst, const float* const* src, const float* weights)
+    {
+        for (uint32 channel = 0; channel < MipPixelChannelCount; channel++)
+        {
+            float sum = 0.0f;
+            for (uint32 index = 0; index < KaiserTapCount; index++)
+            {
+                sum += src[index][channel] * weights[index];
+            }
+            dst[channel] = sum;
+        }
+    }
+#endif
+
+    void DownsampleMipImageBox(const MipImage& src, const math::uvector2& srcSize, MipImage& dst, const math::uvector2& dstSize)
+    {
+        dst = MipImage(static_cast<int32>(dstSize.x * dstSize.y * MipPixelChannelCount), 0.0f);
+        const float* srcPixels = src.getData();
+        float* dstPixels = dst.getData();
+        for (uint32 y = 0; y < dstSize.y; y++)
+        {
+            const float* srcRow0 = srcPixels + math::min(y * 2, srcSize.y - 1) * srcSize.x * MipPixelChannelCount;
+            const float* srcRow1 = srcPixels + math::min(y * 2 + 1, srcSize.y - 1) * srcSize.x * MipPixelChannelCount;
+            for (uint32 x = 0; x < dstSize.x; x++)
+            {
+                const uint32 srcX0 = math::min(x * 2, srcSize.x - 1) * MipPixelChannelCount;
+                const uint32 srcX1 = math::min(x * 2 + 1, srcSize.x - 1) * MipPixelChannelCount;
+                AverageMipPixels(dstPixels + (y * dstSize.x + x) * MipPixelChannelCount, 
+                    srcRow0 + srcX0, srcRow0 + srcX1, srcRow1 + srcX0, srcRow1 + srcX1);
+            }
+        }
+    }
+    void DownsampleMipImageKaiser(const MipImage& src, const math::uvector2& srcSize, MipImage& dst, const math::uvector2& dstSize)
+    {
+        const float* weights = GetKaiserWeights().weights;
+        const float* taps[KaiserTapCount];
+
+        // Separable filter, horizontal pass first
+        MipImage horizontal(static_cast<int32>(dstSize.x * srcSize.y * MipPixelChannelCount), 0.0f);
+        const float* srcPixels = src.getData();
+        float* horizontalPixels = horizontal.getData();
+        for (uint32 y = 0; y < srcSize.y; y++)
+        {
+            const float* srcRow = srcPixels + y * srcSize.x * MipPixelChannelCount;
+            for (uint32 x = 0; x < dstSize.x; x++)
+            {
+                for (uint32 index = 0; index < KaiserTapCount; index++)
+                {
+                    const int32 srcX = math::clamp(static_cast<int32>(x * 2 + index) - 2, 0, static_cast<int32>(srcSize.x) - 1);
+                    taps[index] = srcRow + srcX * MipPixelChannelCount;
+                }
+                FilterMipPixel(horizontalPixels + (y * dstSize.x + x) * MipPixelChannelCount, taps, weights);
+            }
+        }
+
+        dst = MipImage(static_cast<int32>(dstSize.x * dstSize.y * MipPixelChannelCount), 0.0f);
+        float* dstPixels = dst.getData();
+        for (uint32 y = 0; y < dstSize.y; y++)
+        {
+            for (uint32 x = 0; x < dstSize.x; x++)
+            {
+                for (uint32 index = 0; index < KaiserTapCount; index++)
+                {
+                    const int32 srcY = math::clamp(static_cast<int32>(y * 2 + index) - 2, 0, static_cast<int32>(srcSize.y) - 1);
+                    taps[index] = horizontalPixels + (srcY * dstSize.x + x) * MipPixelChannelCount;
+                }
+                FilterMipPixel(dstPixels + (y * dstSize.x + x) * MipPixelChannelCount, taps, weights);
+            }
+        }
+    }
+
+    jarray<const uint8*> TextureMipChain::getMipLevelsData() const
+    {
+        jarray<const uint8*> mipLevelsData;
+        mipLevelsData.reserve(mipLevels.getSize());
+        for (const auto& mipLevel : mipLevels)
+        {
+            mipLevelsData.add(mipLevel.getData());
+        }
+        return mipLevelsData;
+    }
+    Texture* TextureMipChain::createTexture(RenderEngine* renderEngine) const
+    {
+        if ((renderEngine == nullptr) || mipLevels.isEmpty())
+        {
+            JUMA_RENDER_LOG(error, JSTR("Invalid input params"));
+            return nullptr;
+        }
+        return renderEngine->createTexture(size, format, getMipLevelsData());
+    }
+
+    bool GenerateTextureMipChain(const TextureMipSource& source, const TextureMipFilter filter, TextureMipChain& outMipChain)
+    {
+        if ((source.size.x == 0) || (source.size.y == 0) || (source.data == nullptr))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Invalid input params"));
+            return false;
+        }
+        if (!IsTextureMipGenerationSupported(source.format))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Unsupported texture format for mip generation"));
+            return false;
+        }
+
+        const uint32 levelCount = static_cast<uint32>(GetMipLevelCountByTextureSize(source.size));
+        TextureMipChain mipChain;
+        mipChain.size = source.size;
+        mipChain.format = source.format;
+        mipChain.mipLevels.reserve(static_cast<int32>(levelCount));
+        jarray<uint8>& firstLevel = mipChain.mipLevels.addDefault();
+        firstLevel = jarray<uint8>(static_cast<int32>(GetTextureDataSize(source.format, source.size.x, source.size.y)), 0);
+        std::memcpy(firstLevel.getData(), source.data, firstLevel.getSize());
+
+        // Levels are downsampled from the previous float level, so rounding errors don't accumulate
+        MipImage srcImage;
+        MipImage dstImage;
+        DecodeMipImage(source.data, source.size, source.format, source.srgb, srcImage);
+        math::uvector2 srcSize = source.size;
+        for (uint32 level = 1; level < levelCount; level++)
+        {
+            const math::uvector2 dstSize = { math::max(srcSize.x / 2, 1u), math::max(srcSize.y / 2, 1u) };
+            if (filter == TextureMipFilter::Kaiser)
+            {
+                DownsampleMipImageKaiser(srcImage, srcSize, dstImage, dstSize);
+            }
+            else
+            {
+                DownsampleMipImageBox(srcImage, srcSize, dstImage, dstSize);
+            }
+            EncodeMipImage(dstImage, dstSize, source.format, source.srgb, mipChain.mipLevels.addDefault());
+
+            std::swap(srcImage, dstImage);
+            srcSize = dstSize;
+        }
+
+        outMipChain = std::move(mipChain);
+        return true;
+    }
+    bool GenerateTextureMipChains(const jarray<TextureMipSource>& sources, const TextureMipFilter filter, jarray<TextureMipChain>& outMipChains, 
+        const uint32 threadCount)
+    {
+        jarray<TextureMipChain> mipChains(sources.getSize());
+        std::atomic<int32> nextSourceIndex = 0;
+        std::atomic<bool> success = true;
+        const auto generateFunction = [&]()
+        {
+            while (true)
+            {
+                const int32 sourceIndex = nextSourceIndex++;
+                if (sourceIndex >= sources.getSize())
+                {
+                    return;
+                }
+                if (!GenerateTextureMipChain(sources[sourceIndex], filter, mipChains[sourceIndex]))
+                {
+                    success = false;
+                }
+            }
+        };
+
+        const uint32 maxThreadCount = threadCount > 0 ? threadCount : math::max(std::thread::hardware_concurrency(), 1u);
+        const uint32 workerCount = math::min(maxThreadCount, static_cast<uint32>(sources.getSize()));
+        jarray<std::thread> threads;
+        threads.reserve(static_cast<int32>(workerCount));
+        // Calling thread is one of the workers
+        for (uint32 index = 1; index < workerCount; index++)
+        {
+            threads.add(std::thread(generateFunction));
+        }
+        generateFunction();
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        outMipChains = std::move(mipChains);
+        return success;
+    }
+}
@@ -0,0 +1,57 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#pragma once
+
+#include "renderEngine/juma_render_engine_core.h"
+
+#include "TextureFormat.h"
+#include "jutils/jarray.h"
+#include "jutils/math/vector2.h"
+
+namespace JumaRenderEngine
+{
+    class RenderEngine;
+    class Texture;
+
+    enum class TextureMipFilter : uint8 { Box, Kaiser };
+
+    struct TextureMipSource
+    {
+        math::uvector2 size = { 0, 0 };
+        TextureFormat format = TextureFormat::RGBA8;
+        const uint8* data = nullptr;
+        // Color channels are averaged in linear space, alpha is always linear. Render APIs don't sample 8-bit formats as sRGB
+        // in the same way, so it's set by the user. Must be false for normals, masks and other data
+        bool srgb = false;
+    };
+    struct TextureMipChain
+    {
+        math::uvector2 size = { 0, 0 };
+        TextureFormat format = TextureFormat::RGBA8;
+        // From the biggest level, the first one is a copy of the source
+        jarray<jarray<uint8>> mipLevels;
+
+        jarray<const uint8*> getMipLevelsData() const;
+        Texture* createTexture(RenderEngine* renderEngine) const;
+    };
+
+    // Only formats with 8-bit channels
+    constexpr bool IsTextureMipGenerationSupported(const TextureFormat format)
+    {
+        switch (format)
+        {
+        case TextureFormat::RGBA8:
+        case TextureFormat::BGRA8:
+        case TextureFormat::R8:
+        case TextureFormat::RG8:
+            return true;
+        default: ;
+        }
+        return false;
+    }
+
+    bool GenerateTextureMipChain(const TextureMipSource& source, TextureMipFilter filter, TextureMipChain& outMipChain);
+    // Textures are split between threads, zero thread count means hardware concurrency. Returns false if any chain failed
+    bool GenerateTextureMipChains(const jarray<TextureMipSource>& sources, TextureMipFilter filter, jarray<TextureMipChain>& outMipChains, 
+        uint32 threadCount = 0);
+}
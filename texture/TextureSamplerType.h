@@ -27,6 +27,11 @@ namespace JumaRenderEngine
         bool operator<(const TextureSamplerType& type) const { return (filterType < type.filterType) || ((filterType == type.filterType) && (wrapMode < type.wrapMode)); }
     };
 
+    constexpr bool IsTextureFilterTypeUsingMips(const TextureFilterType filterType)
+    {
+        return (filterType != TextureFilterType::Point) && (filterType != TextureFilterType::Bilinear);
+    }
+
     constexpr uint8 GetTextureSamplerTypeID(const TextureSamplerType& samplerType)
     {
         return static_cast<uint8>(static_cast<uint8>(samplerType.filterType) * TextureWrapModeCount + static_cast<uint8>(samplerType.wrapMode));
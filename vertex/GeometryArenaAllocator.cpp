@@ -0,0 +1,111 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#include "GeometryArenaAllocator.h"
+
+namespace JumaRenderEngine
+{
+    uint32 GeometryArenaAllocator::getLargestFreeRange() const
+    {
+        uint32 largestRange = 0;
+        for (const auto& range : m_FreeRanges)
+        {
+            largestRange = math::max(largestRange, range.size);
+        }
+        return largestRange;
+    }
+    float GeometryArenaAllocator::getFragmentation() const
+    {
+        const uint32 freeSize = getFreeSize();
+        if (freeSize == 0)
+        {
+            return 0.0f;
+        }
+        return 1.0f - static_cast<float>(getLargestFreeRange()) / static_cast<float>(freeSize);
+    }
+
+    void GeometryArenaAllocator::reset(const uint32 capacity, const uint32 usedSize)
+    {
+        m_Capacity = capacity;
+        m_UsedSize = math::min(usedSize, capacity);
+        m_FreeRanges.clear();
+        if (m_UsedSize < m_Capacity)
+        {
+            m_FreeRanges.add({ m_UsedSize, m_Capacity - m_UsedSize });
+        }
+    }
+
+    bool GeometryArenaAllocator::allocate(const uint32 size, uint32& outOffset)
+    {
+        if (size == 0)
+        {
+            outOffset = 0;
+            return true;
+        }
+
+        for (int32 index = 0; index < m_FreeRanges.getSize(); index++)
+        {
+            GeometryArenaRange& range = m_FreeRanges[index];
+            if (range.size < size)
+            {
+                continue;
+            }
+
+            outOffset = range.offset;
+            if (range.size == size)
+            {
+                m_FreeRanges.removeAt(index);
+            }
+            else
+            {
+                range.offset += size;
+                range.size -= size;
+            }
+            m_UsedSize += size;
+            return true;
+        }
+        return false;
+    }
+    void GeometryArenaAllocator::free(const uint32 offset, const uint32 size)
+    {
+        if ((size == 0) || ((offset + size) > m_Capacity))
+        {
+            return;
+        }
+
+        int32 nextIndex = 0;
+        while ((nextIndex < m_FreeRanges.getSize()) && (m_FreeRanges[nextIndex].offset < offset))
+        {
+            nextIndex++;
+        }
+        const int32 prevIndex = nextIndex - 1;
+
+        const bool mergeWithPrev = m_FreeRanges.isValidIndex(prevIndex) &&
+            ((m_FreeRanges[prevIndex].offset + m_FreeRanges[prevIndex].size) == offset);
+        const bool mergeWithNext = m_FreeRanges.isValidIndex(nextIndex) &&
+            ((offset + size) == m_FreeRanges[nextIndex].offset);
+        if (mergeWithPrev && mergeWithNext)
+        {
+            m_FreeRanges[prevIndex].size += size + m_FreeRanges[nextIndex].size;
+            m_FreeRanges.removeAt(nextIndex);
+        }
+        else if (mergeWithPrev)
+        {
+            m_FreeRanges[prevIndex].size += size;
+        }
+        else if (mergeWithNext)
+        {
+            m_FreeRanges[nextIndex].offset = offset;
+            m_FreeRanges[nextIndex].size += size;
+        }
+        else
+        {
+            m_FreeRanges.addDefault();
+            for (int32 index = m_FreeRanges.getSize() - 1; index > nextIndex; index--)
+            {
+                m_FreeRanges[index] = m_FreeRanges[index - 1];
+            }
+            m_FreeRanges[nextIndex] = { offset, size };
+        }
+        m_UsedSize -= size;
+    }
+}
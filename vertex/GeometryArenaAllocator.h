@@ -0,0 +1,42 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#pragma once
+
+#include "renderEngine/juma_render_engine_core.h"
+
+#include "jutils/jarray.h"
+
+namespace JumaRenderEngine
+{
+    struct GeometryArenaRange
+    {
+        uint32 offset = 0;
+        uint32 size = 0;
+    };
+
+    // First-fit range allocator, offsets and sizes are in elements (vertices or indices)
+    class GeometryArenaAllocator
+    {
+    public:
+        GeometryArenaAllocator() = default;
+
+        uint32 getCapacity() const { return m_Capacity; }
+        uint32 getUsedSize() const { return m_UsedSize; }
+        uint32 getFreeSize() const { return m_Capacity - m_UsedSize; }
+        uint32 getLargestFreeRange() const;
+        float getFragmentation() const;
+
+        void reset(uint32 capacity, uint32 usedSize = 0);
+
+        bool allocate(uint32 size, uint32& outOffset);
+        void free(uint32 offset, uint32 size);
+
+    private:
+
+        uint32 m_Capacity = 0;
+        uint32 m_UsedSize = 0;
+
+        // Sorted by offset, neighbour ranges are always merged
+        jarray<GeometryArenaRange> m_FreeRanges;
+    };
+}
@@ -0,0 +1,230 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#include "MeshFile.h"
+
+#include <cstring>
+#include <fstream>
+
+namespace JumaRenderEngine
+{
+    uint64 AlignMeshFileOffset(const uint64 offset)
+    {
+        return (offset + MeshFileDataAlignment - 1) / MeshFileDataAlignment * MeshFileDataAlignment;
+    }
+
+    const char* ReadMeshFileString(const uint8* data, const uint64 dataSize, uint64& offset)
+    {
+        if (offset >= dataSize)
+        {
+            return nullptr;
+        }
+        const void* terminator = std::memchr(data + offset, '\0', static_cast<size_t>(dataSize - offset));
+        if (terminator == nullptr)
+        {
+            return nullptr;
+        }
+        const char* str = reinterpret_cast<const char*>(data + offset);
+        offset = static_cast<uint64>(static_cast<const uint8*>(terminator) - data) + 1;
+        return str;
+    }
+
+    bool WriteMeshFile(const jstring& fileName, const VertexBufferData* verticesData)
+    {
+        if ((verticesData == nullptr) || (verticesData->getVertexCount() == 0))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Invalid vertex buffer data"));
+            return false;
+        }
+
+        const VertexDescription vertexDescription = verticesData->getVertexDescription();
+        const jstring vertexTypeName = verticesData->getVertexTypeName().toString();
+        jarray<jstring> componentNames;
+        componentNames.reserve(vertexDescription.components.getSize());
+        for (const auto& component : vertexDescription.components)
+        {
+            componentNames.add(component.name.toString());
+        }
+
+        MeshFileHeader header;
+        header.vertexSize = vertexDescription.size;
+        header.vertexCount = verticesData->getVertexCount();
+        header.indexCount = verticesData->getIndexCount();
+        header.indexType = header.indexCount > 0 ? MeshFileIndexType::UInt32 : MeshFileIndexType::None;
+        header.componentCount = static_cast<uint32>(vertexDescription.components.getSize());
+
+        uint64 offset = sizeof(MeshFileHeader) + std::strlen(*vertexTypeName) + 1;
+        for (const auto& componentName : componentNames)
+        {
+            offset += sizeof(MeshFileVertexComponent) + std::strlen(*componentName) + 1;
+        }
+        header.verticesOffset = AlignMeshFileOffset(offset);
+        offset = header.verticesOffset + static_cast<uint64>(header.vertexCount) * header.vertexSize;
+        header.indicesOffset = header.indexCount > 0 ? AlignMeshFileOffset(offset) : 0;
+
+        std::ofstream file(*fileName, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            JUMA_RENDER_LOG(error, JSTR("Can't open file {}"), fileName);
+            return false;
+        }
+
+        const char padding[MeshFileDataAlignment] = {};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(*vertexTypeName, static_cast<std::streamsize>(std::strlen(*vertexTypeName) + 1));
+        for (int32 index = 0; index < vertexDescription.components.getSize(); index++)
+        {
+            const VertexComponentDescription& component = vertexDescription.components[index];
+            MeshFileVertexComponent fileComponent;
+            fileComponent.shaderLocation = component.shaderLocation;
+            fileComponent.offset = component.offset;
+            fileComponent.type = component.type;
+            file.write(reinterpret_cast<const char*>(&fileComponent), sizeof(fileComponent));
+            file.write(*componentNames[index], static_cast<std::streamsize>(std::strlen(*componentNames[index]) + 1));
+        }
+        file.write(padding, static_cast<std::streamsize>(header.verticesOffset - static_cast<uint64>(file.tellp())));
+        file.write(static_cast<const char*>(verticesData->getVertices()), static_cast<std::streamsize>(header.vertexCount) * header.vertexSize);
+        if (header.indexCount > 0)
+        {
+            file.write(padding, static_cast<std::streamsize>(header.indicesOffset - static_cast<uint64>(file.tellp())));
+            file.write(static_cast<const char*>(verticesData->getIndices()), static_cast<std::streamsize>(header.indexCount) * sizeof(uint32));
+        }
+        if (!file.good())
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to write mesh file {}"), fileName);
+            return false;
+        }
+        return true;
+    }
+
+    bool MappedVertexBufferData::open(const jstring& fileName)
+    {
+        close();
+        if (!m_FileMapping.open(fileName))
+        {
+            return false;
+        }
+
+        const uint8* data = m_FileMapping.getData();
+        const uint64 dataSize = m_FileMapping.getSize();
+        MeshFileHeader header;
+        if (dataSize < sizeof(MeshFileHeader))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Invalid mesh file {}"), fileName);
+            close();
+            return false;
+        }
+        std::memcpy(&header, data, sizeof(MeshFileHeader));
+        if ((header.magic != MeshFileMagic) || (header.version != MeshFileVersion) || 
+            (static_cast<uint8>(header.indexType) > static_cast<uint8>(MeshFileIndexType::UInt32)))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Unsupported mesh file {}"), fileName);
+            close();
+            return false;
+        }
+
+        uint64 offset = sizeof(MeshFileHeader);
+        const char* vertexTypeName = ReadMeshFileString(data, dataSize, offset);
+        if (vertexTypeName == nullptr)
+        {
+            JUMA_RENDER_LOG(error, JSTR("Invalid vertex type name in mesh file {}"), fileName);
+            close();
+            return false;
+        }
+        // Each component record is followed by at least a terminator of the name
+        if ((header.componentCount == 0) || (header.componentCount > ((dataSize - offset) / (sizeof(MeshFileVertexComponent) + 1))))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Invalid vertex components in mesh file {}"), fileName);
+            close();
+            return false;
+        }
+        VertexDescription vertexDescription;
+        vertexDescription.size = header.vertexSize;
+        vertexDescription.components.reserve(static_cast<int32>(header.componentCount));
+        for (uint32 index = 0; index < header.componentCount; index++)
+        {
+            MeshFileVertexComponent fileComponent;
+            if ((offset > dataSize) || (sizeof(MeshFileVertexComponent) > (dataSize - offset)))
+            {
+                JUMA_RENDER_LOG(error, JSTR("Invalid vertex components in mesh file {}"), fileName);
+                close();
+                return false;
+            }
+            std::memcpy(&fileComponent, data + offset, sizeof(MeshFileVertexComponent));
+            offset += sizeof(MeshFileVertexComponent);
+            const char* componentName = ReadMeshFileString(data, dataSize, offset);
+            if ((componentName == nullptr) || (static_cast<uint8>(fileComponent.type) > static_cast<uint8>(VertexComponentType::Int_10_10_10_2_Norm)) || 
+                (fileComponent.offset > header.vertexSize) || (GetVertexComponentSize(fileComponent.type) > (header.vertexSize - fileComponent.offset)))
+            {
+                JUMA_RENDER_LOG(error, JSTR("Invalid vertex components in mesh file {}"), fileName);
+                close();
+                return false;
+            }
+            vertexDescription.components.add({ componentName, fileComponent.type, fileComponent.shaderLocation, fileComponent.offset });
+        }
+
+        const uint64 verticesSize = static_cast<uint64>(header.vertexCount) * header.vertexSize;
+        const uint32 indexSize = header.indexType == MeshFileIndexType::UInt16 ? sizeof(uint16) : sizeof(uint32);
+        const uint64 indicesSize = header.indexType != MeshFileIndexType::None ? static_cast<uint64>(header.indexCount) * indexSize : 0;
+        if ((header.vertexCount == 0) || (header.vertexSize == 0) || ((header.verticesOffset % MeshFileDataAlignment) != 0) || 
+            (header.verticesOffset > dataSize) || (verticesSize > (dataSize - header.verticesOffset)) || 
+            ((header.indicesOffset % MeshFileDataAlignment) != 0) || 
+            (header.indicesOffset > dataSize) || (indicesSize > (dataSize - header.indicesOffset)))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Invalid data ranges in mesh file {}"), fileName);
+            close();
+            return false;
+        }
+
+        m_VertexTypeName = vertexTypeName;
+        m_VertexDescription = std::move(vertexDescription);
+        m_MappedVertices = data + header.verticesOffset;
+        m_VertexCount = header.vertexCount;
+        switch (header.indexType)
+        {
+        case MeshFileIndexType::UInt32:
+            m_MappedIndices = reinterpret_cast<const uint32*>(data + header.indicesOffset);
+            m_MappedIndexCount = header.indexCount;
+            break;
+        case MeshFileIndexType::UInt16:
+            {
+                // Render engine uses only 32-bit indices
+                jarray<uint32> indices(static_cast<int32>(header.indexCount), 0);
+                const uint16* indicesData = reinterpret_cast<const uint16*>(data + header.indicesOffset);
+                for (uint32 index = 0; index < header.indexCount; index++)
+                {
+                    indices[static_cast<int32>(index)] = indicesData[index];
+                }
+                setVertexIndices(std::move(indices));
+            }
+            break;
+        default: ;
+        }
+        return true;
+    }
+
+    void MappedVertexBufferData::close()
+    {
+        m_CopiedVertices.clear();
+        vertexIndices.clear();
+        m_MappedVertices = nullptr;
+        m_MappedIndices = nullptr;
+        m_VertexCount = 0;
+        m_MappedIndexCount = 0;
+        m_VertexDescription = VertexDescription();
+        m_VertexTypeName = jstringID_NONE;
+        m_FileMapping.close();
+    }
+
+    void MappedVertexBufferData::copyVertices(const void* data, const uint32 vertexCount)
+    {
+        const uint8* bytes = static_cast<const uint8*>(data);
+        const uint32 size = vertexCount * m_VertexDescription.size;
+        m_CopiedVertices.clear();
+        m_CopiedVertices.reserve(static_cast<int32>(size));
+        for (uint32 index = 0; index < size; index++)
+        {
+            m_CopiedVertices.add(bytes[index]);
+        }
+        m_VertexCount = vertexCount;
+    }
+}
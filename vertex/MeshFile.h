@@ -0,0 +1,84 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#pragma once
+
+#include "renderEngine/juma_render_engine_core.h"
+
+#include "VertexBufferData.h"
+#include "jutils/jstring.h"
+#include "renderEngine/file/FileMapping.h"
+
+namespace JumaRenderEngine
+{
+    enum class MeshFileIndexType : uint8 { None, UInt16, UInt32 };
+
+    // Layout of the binary mesh file:
+    // header, null-terminated vertex type name, component records with null-terminated names,
+    // vertices and indices (each section is aligned to MeshFileDataAlignment)
+    constexpr uint32 MeshFileMagic = 0x48534D4A; // "JMSH"
+    constexpr uint32 MeshFileVersion = 1;
+    constexpr uint32 MeshFileDataAlignment = 16;
+
+    struct MeshFileHeader
+    {
+        uint32 magic = MeshFileMagic;
+        uint32 version = MeshFileVersion;
+
+        uint32 vertexSize = 0;
+        uint32 vertexCount = 0;
+        uint32 indexCount = 0;
+        MeshFileIndexType indexType = MeshFileIndexType::None;
+        uint8 reserved[3] = { 0, 0, 0 };
+        uint32 componentCount = 0;
+        uint32 reserved2 = 0;
+
+        uint64 verticesOffset = 0;
+        uint64 indicesOffset = 0;
+    };
+    struct MeshFileVertexComponent
+    {
+        uint32 shaderLocation = 0;
+        uint32 offset = 0;
+        VertexComponentType type = VertexComponentType::Float;
+        uint8 reserved[3] = { 0, 0, 0 };
+    };
+
+    bool WriteMeshFile(const jstring& fileName, const VertexBufferData* verticesData);
+
+    // Vertices and 32-bit indices are read straight from the mapped file, 16-bit indices are expanded on open.
+    // Data is copied to owned storage only when it's changed (e.g. by VertexBufferOptimizer)
+    class MappedVertexBufferData final : public VertexBufferData
+    {
+    public:
+        MappedVertexBufferData() = default;
+        virtual ~MappedVertexBufferData() override = default;
+
+        bool open(const jstring& fileName);
+        bool isOpened() const { return m_FileMapping.isOpened(); }
+        void close();
+
+        virtual const jstringID& getVertexTypeName() const override { return m_VertexTypeName; }
+        virtual VertexDescription getVertexDescription() const override { return m_VertexDescription; }
+
+        virtual const void* getVertices() const override { return !m_CopiedVertices.isEmpty() ? m_CopiedVertices.getData() : m_MappedVertices; }
+        virtual uint32 getVertexCount() const override { return m_VertexCount; }
+        virtual void copyVertices(const void* data, uint32 vertexCount) override;
+
+        virtual const void* getIndices() const override { return !vertexIndices.isEmpty() ? vertexIndices.getData() : m_MappedIndices; }
+        virtual uint32 getIndexCount() const override { return !vertexIndices.isEmpty() ? static_cast<uint32>(vertexIndices.getSize()) : m_MappedIndexCount; }
+
+    private:
+
+        FileMapping m_FileMapping;
+
+        jstringID m_VertexTypeName = jstringID_NONE;
+        VertexDescription m_VertexDescription;
+
+        const uint8* m_MappedVertices = nullptr;
+        const uint32* m_MappedIndices = nullptr;
+        uint32 m_VertexCount = 0;
+        uint32 m_MappedIndexCount = 0;
+
+        jarray<uint8> m_CopiedVertices;
+    };
+}
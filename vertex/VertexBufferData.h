@@ -19,9 +19,11 @@ namespace JumaRenderEngine
 
         virtual const void* getVertices() const = 0;
         virtual uint32 getVertexCount() const = 0;
+        // Replace vertices with raw data of the same vertex type
+        virtual void copyVertices(const void* data, uint32 vertexCount) = 0;
 
-        const void* getIndices() const { return !vertexIndices.isEmpty() ? vertexIndices.getData() : nullptr; }
-        uint32 getIndexCount() const { return static_cast<uint32>(vertexIndices.getSize()); }
+        virtual const void* getIndices() const { return !vertexIndices.isEmpty() ? vertexIndices.getData() : nullptr; }
+        virtual uint32 getIndexCount() const { return static_cast<uint32>(vertexIndices.getSize()); }
 
         void setVertexIndices(jarray<uint32> data) { vertexIndices = std::move(data); }
 
@@ -44,6 +46,16 @@ namespace JumaRenderEngine
 
         virtual const void* getVertices() const override { return vertices.getData(); }
         virtual uint32 getVertexCount() const override { return static_cast<uint32>(vertices.getSize()); }
+        virtual void copyVertices(const void* data, const uint32 vertexCount) override
+        {
+            const VertexType* typedData = static_cast<const VertexType*>(data);
+            vertices.clear();
+            vertices.reserve(static_cast<int32>(vertexCount));
+            for (uint32 index = 0; index < vertexCount; index++)
+            {
+                vertices.add(typedData[index]);
+            }
+        }
         
         void setVertices(jarray<VertexType> data) { vertices = std::move(data); }
 
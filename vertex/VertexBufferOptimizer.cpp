@@ -0,0 +1,450 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#include "VertexBufferOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+#include "VertexBufferData.h"
+
+namespace JumaRenderEngine
+{
+    constexpr uint32 ForsythMaxCacheSize = 64;
+    constexpr float ForsythCacheDecayPower = 1.5f;
+    constexpr float ForsythLastTriangleScore = 0.75f;
+    constexpr float ForsythValenceBoostScale = 2.0f;
+    constexpr float ForsythValenceBoostPower = 0.5f;
+
+    float GetForsythVertexScore(const int32 cachePosition, const uint32 remainingTriangles, const uint32 cacheSize)
+    {
+        if (remainingTriangles == 0)
+        {
+            return -1.0f;
+        }
+
+        float score = 0.0f;
+        if (cachePosition >= 0)
+        {
+            if (cachePosition < 3)
+            {
+                // Vertices of the last triangle are scored lower to not use them again right away
+                score = ForsythLastTriangleScore;
+            }
+            else
+            {
+                const float cacheScale = 1.0f / static_cast<float>(cacheSize - 3);
+                score = std::pow(1.0f - static_cast<float>(cachePosition - 3) * cacheScale, ForsythCacheDecayPower);
+            }
+        }
+        // Vertices with few triangles left are boosted to finish them and get rid of them
+        return score + ForsythValenceBoostScale * std::pow(static_cast<float>(remainingTriangles), -ForsythValenceBoostPower);
+    }
+
+    bool VertexBufferOptimizer::optimize(VertexBufferData* verticesData, const VertexBufferOptimizationSettings& settings,
+        VertexBufferOptimizationReport* outReport)
+    {
+        if (verticesData == nullptr)
+        {
+            JUMA_RENDER_LOG(error, JSTR("Invalid vertex buffer data"));
+            return false;
+        }
+        const uint32 vertexSize = verticesData->getVertexDescription().size;
+        const uint32 vertexCount = verticesData->getVertexCount();
+        if ((vertexSize == 0) || (vertexCount == 0))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Empty vertex buffer data"));
+            return false;
+        }
+        if ((settings.cacheSize < 4) || (settings.cacheSize > ForsythMaxCacheSize))
+        {
+            JUMA_RENDER_LOG(error, JSTR("Invalid vertex cache size {}"), settings.cacheSize);
+            return false;
+        }
+
+        jarray<uint32> indices;
+        const uint32 indexCount = verticesData->getIndexCount();
+        if (indexCount > 0)
+        {
+            const uint32* indicesData = static_cast<const uint32*>(verticesData->getIndices());
+            indices.reserve(static_cast<int32>(indexCount));
+            for (uint32 index = 0; index < indexCount; index++)
+            {
+                indices.add(indicesData[index]);
+            }
+        }
+        else
+        {
+            indices.reserve(static_cast<int32>(vertexCount));
+            for (uint32 index = 0; index < vertexCount; index++)
+            {
+                indices.add(index);
+            }
+        }
+        if ((indices.getSize() % 3) != 0)
+        {
+            JUMA_RENDER_LOG(error, JSTR("Index count is not multiple of 3"));
+            return false;
+        }
+        for (const auto& index : indices)
+        {
+            if (index >= vertexCount)
+            {
+                JUMA_RENDER_LOG(error, JSTR("Vertex index {} is out of range"), index);
+                return false;
+            }
+        }
+
+        VertexBufferOptimizationReport report;
+        report.vertexCountBefore = vertexCount;
+        report.ACMRBefore = calculateACMR(indices, vertexCount, settings.cacheSize);
+
+        jarray<uint8> vertices;
+        uint32 resultVertexCount = vertexCount;
+        if (settings.deduplicateVertices)
+        {
+            const jarray<uint32> remap = deduplicateVertices(static_cast<const uint8*>(verticesData->getVertices()), vertexCount, vertexSize, vertices);
+            for (auto& index : indices)
+            {
+                index = remap[static_cast<int32>(index)];
+            }
+            resultVertexCount = static_cast<uint32>(vertices.getSize()) / vertexSize;
+        }
+        else
+        {
+            vertices.reserve(static_cast<int32>(vertexCount * vertexSize));
+            const uint8* verticesBytes = static_cast<const uint8*>(verticesData->getVertices());
+            for (uint32 index = 0; index < vertexCount * vertexSize; index++)
+            {
+                vertices.add(verticesBytes[index]);
+            }
+        }
+
+        if (settings.optimizeVertexCache)
+        {
+            optimizeVertexCache(indices, resultVertexCount, settings);
+        }
+        if (settings.optimizeVertexFetch)
+        {
+            jarray<uint8> fetchOrderedVertices;
+            resultVertexCount = optimizeVertexFetch(indices, vertices.getData(), resultVertexCount, vertexSize, fetchOrderedVertices);
+            vertices = std::move(fetchOrderedVertices);
+        }
+
+        report.vertexCountAfter = resultVertexCount;
+        report.ACMRAfter = calculateACMR(indices, resultVertexCount, settings.cacheSize);
+
+        verticesData->copyVertices(vertices.getData(), resultVertexCount);
+        verticesData->setVertexIndices(std::move(indices));
+        if (outReport != nullptr)
+        {
+            *outReport = report;
+        }
+        return true;
+    }
+
+    float VertexBufferOptimizer::calculateACMR(const jarray<uint32>& indices, const uint32 vertexCount, const uint32 cacheSize)
+    {
+        const int32 triangleCount = indices.getSize() / 3;
+        if (triangleCount == 0)
+        {
+            return 0.0f;
+        }
+
+        // FIFO cache: vertex is cached if less than cacheSize misses happened after it was loaded
+        jarray<uint32> cacheTimestamps(static_cast<int32>(vertexCount), 0);
+        uint32 missCount = 0;
+        for (const auto& index : indices)
+        {
+            uint32& timestamp = cacheTimestamps[static_cast<int32>(index)];
+            if ((timestamp == 0) || ((missCount + 1 - timestamp) > cacheSize))
+            {
+                missCount++;
+                timestamp = missCount;
+            }
+        }
+        return static_cast<float>(missCount) / static_cast<float>(triangleCount);
+    }
+
+    jarray<uint32> VertexBufferOptimizer::deduplicateVertices(const uint8* vertices, const uint32 vertexCount, const uint32 vertexSize,
+        jarray<uint8>& outVertices)
+    {
+        jarray<uint64> hashes(static_cast<int32>(vertexCount), 0);
+        for (uint32 vertexIndex = 0; vertexIndex < vertexCount; vertexIndex++)
+        {
+            // FNV-1a
+            uint64 hash = 14695981039346656037ull;
+            const uint8* vertex = vertices + vertexIndex * vertexSize;
+            for (uint32 byteIndex = 0; byteIndex < vertexSize; byteIndex++)
+            {
+                hash = (hash ^ vertex[byteIndex]) * 1099511628211ull;
+            }
+            hashes[static_cast<int32>(vertexIndex)] = hash;
+        }
+
+        jarray<uint32> sortedVertices(static_cast<int32>(vertexCount), 0);
+        for (uint32 vertexIndex = 0; vertexIndex < vertexCount; vertexIndex++)
+        {
+            sortedVertices[static_cast<int32>(vertexIndex)] = vertexIndex;
+        }
+        std::sort(sortedVertices.getData(), sortedVertices.getData() + vertexCount, [&](const uint32 vertex1, const uint32 vertex2)
+        {
+            if (hashes[static_cast<int32>(vertex1)] != hashes[static_cast<int32>(vertex2)])
+            {
+                return hashes[static_cast<int32>(vertex1)] < hashes[static_cast<int32>(vertex2)];
+            }
+            const int compareResult = std::memcmp(vertices + vertex1 * vertexSize, vertices + vertex2 * vertexSize, vertexSize);
+            return compareResult != 0 ? compareResult < 0 : vertex1 < vertex2;
+        });
+
+        // First vertex of each group of equal vertices has the lowest index
+        jarray<uint32> representatives(static_cast<int32>(vertexCount), 0);
+        uint32 groupVertex = sortedVertices[0];
+        for (uint32 sortedIndex = 0; sortedIndex < vertexCount; sortedIndex++)
+        {
+            const uint32 vertex = sortedVertices[static_cast<int32>(sortedIndex)];
+            const bool sameGroup = (hashes[static_cast<int32>(vertex)] == hashes[static_cast<int32>(groupVertex)]) &&
+                (std::memcmp(vertices + vertex * vertexSize, vertices + groupVertex * vertexSize, vertexSize) == 0);
+            if (!sameGroup)
+            {
+                groupVertex = vertex;
+            }
+            representatives[static_cast<int32>(vertex)] = groupVertex;
+        }
+
+        jarray<uint32> remap(static_cast<int32>(vertexCount), 0);
+        uint32 uniqueVertexCount = 0;
+        outVertices.clear();
+        outVertices.reserve(static_cast<int32>(vertexCount * vertexSize));
+        for (uint32 vertexIndex = 0; vertexIndex < vertexCount; vertexIndex++)
+        {
+            const uint32 representative = representatives[static_cast<int32>(vertexIndex)];
+            if (representative != vertexIndex)
+            {
+                remap[static_cast<int32>(vertexIndex)] = remap[static_cast<int32>(representative)];
+                continue;
+            }
+
+            remap[static_cast<int32>(vertexIndex)] = uniqueVertexCount++;
+            const uint8* vertex = vertices + vertexIndex * vertexSize;
+            for (uint32 byteIndex = 0; byteIndex < vertexSize; byteIndex++)
+            {
+                outVertices.add(vertex[byteIndex]);
+            }
+        }
+        return remap;
+    }
+
+    void VertexBufferOptimizer::optimizeVertexCache(jarray<uint32>& indices, const uint32 vertexCount, const VertexBufferOptimizationSettings& settings)
+    {
+        const uint32 triangleCount = static_cast<uint32>(indices.getSize()) / 3;
+        if (triangleCount == 0)
+        {
+            return;
+        }
+
+        const uint32 hardwareThreadCount = math::max(std::thread::hardware_concurrency(), 1u);
+        const uint32 maxThreadCount = settings.maxThreadCount > 0 ? settings.maxThreadCount : hardwareThreadCount;
+        const uint32 chunkCount = math::max(1u, math::min(maxThreadCount, triangleCount / math::max(settings.minTrianglesPerThread, 1u)));
+        const uint32 chunkTriangleCount = (triangleCount + chunkCount - 1) / chunkCount;
+
+        jarray<uint32> result(indices.getSize(), 0);
+        if (chunkCount == 1)
+        {
+            optimizeVertexCacheChunk(indices.getData(), static_cast<uint32>(indices.getSize()), settings.cacheSize, result.getData());
+        }
+        else
+        {
+            // Chunks are independent, cache is lost only on their borders
+            jarray<std::thread> threads;
+            threads.reserve(static_cast<int32>(chunkCount));
+            for (uint32 chunkIndex = 0; chunkIndex < chunkCount; chunkIndex++)
+            {
+                const uint32 firstIndex = chunkIndex * chunkTriangleCount * 3;
+                const uint32 lastIndex = math::min((chunkIndex + 1) * chunkTriangleCount, triangleCount) * 3;
+                if (firstIndex >= lastIndex)
+                {
+                    break;
+                }
+                threads.add(std::thread(&VertexBufferOptimizer::optimizeVertexCacheChunk,
+                    indices.getData() + firstIndex, lastIndex - firstIndex, settings.cacheSize, result.getData() + firstIndex));
+            }
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+        }
+        indices = std::move(result);
+    }
+    void VertexBufferOptimizer::optimizeVertexCacheChunk(const uint32* indices, const uint32 indexCount, const uint32 cacheSize, uint32* outIndices)
+    {
+        // Compact vertex indices of the chunk to keep per vertex data small
+        jarray<uint32> chunkVertices(static_cast<int32>(indexCount), 0);
+        std::memcpy(chunkVertices.getData(), indices, indexCount * sizeof(uint32));
+        std::sort(chunkVertices.getData(), chunkVertices.getData() + indexCount);
+        const uint32 vertexCount = static_cast<uint32>(std::unique(chunkVertices.getData(), chunkVertices.getData() + indexCount) - chunkVertices.getData());
+        jarray<uint32> localIndices(static_cast<int32>(indexCount), 0);
+        for (uint32 index = 0; index < indexCount; index++)
+        {
+            localIndices[static_cast<int32>(index)] = static_cast<uint32>(
+                std::lower_bound(chunkVertices.getData(), chunkVertices.getData() + vertexCount, indices[index]) - chunkVertices.getData()
+            );
+        }
+
+        const uint32 triangleCount = indexCount / 3;
+        jarray<uint32> vertexTriangleOffsets(static_cast<int32>(vertexCount), 0);
+        jarray<uint32> vertexRemainingTriangles(static_cast<int32>(vertexCount), 0);
+        for (const auto& index : localIndices)
+        {
+            vertexRemainingTriangles[static_cast<int32>(index)]++;
+        }
+        uint32 triangleOffset = 0;
+        for (uint32 vertex = 0; vertex < vertexCount; vertex++)
+        {
+            vertexTriangleOffsets[static_cast<int32>(vertex)] = triangleOffset;
+            triangleOffset += vertexRemainingTriangles[static_cast<int32>(vertex)];
+        }
+        jarray<uint32> vertexTriangles(static_cast<int32>(indexCount), 0);
+        {
+            jarray<uint32> vertexTriangleCursors = vertexTriangleOffsets;
+            for (uint32 index = 0; index < indexCount; index++)
+            {
+                const int32 vertex = static_cast<int32>(localIndices[static_cast<int32>(index)]);
+                vertexTriangles[static_cast<int32>(vertexTriangleCursors[vertex]++)] = index / 3;
+            }
+        }
+
+        jarray<int32> vertexCachePositions(static_cast<int32>(vertexCount), -1);
+        jarray<float> vertexScores(static_cast<int32>(vertexCount), 0.0f);
+        for (uint32 vertex = 0; vertex < vertexCount; vertex++)
+        {
+            vertexScores[static_cast<int32>(vertex)] = GetForsythVertexScore(-1, vertexRemainingTriangles[static_cast<int32>(vertex)], cacheSize);
+        }
+        jarray<float> triangleScores(static_cast<int32>(triangleCount), 0.0f);
+        jarray<uint8> trianglesAdded(static_cast<int32>(triangleCount), 0);
+        int32 bestTriangle = -1;
+        float bestTriangleScore = -1.0f;
+        for (uint32 triangle = 0; triangle < triangleCount; triangle++)
+        {
+            float& score = triangleScores[static_cast<int32>(triangle)];
+            for (uint32 corner = 0; corner < 3; corner++)
+            {
+                score += vertexScores[static_cast<int32>(localIndices[static_cast<int32>(triangle * 3 + corner)])];
+            }
+            if (score > bestTriangleScore)
+            {
+                bestTriangleScore = score;
+                bestTriangle = static_cast<int32>(triangle);
+            }
+        }
+
+        jarray<uint32> cache;
+        jarray<uint32> newCache;
+        cache.reserve(static_cast<int32>(cacheSize + 3));
+        newCache.reserve(static_cast<int32>(cacheSize + 3));
+        uint32 outIndexCount = 0;
+        uint32 nextUnaddedTriangle = 0;
+        while (bestTriangle >= 0)
+        {
+            trianglesAdded[bestTriangle] = 1;
+            newCache.clear();
+            for (uint32 corner = 0; corner < 3; corner++)
+            {
+                const uint32 vertex = localIndices[bestTriangle * 3 + static_cast<int32>(corner)];
+                outIndices[outIndexCount++] = chunkVertices[static_cast<int32>(vertex)];
+                newCache.add(vertex);
+
+                // Remove triangle from the list of vertex triangles
+                uint32& remainingTriangles = vertexRemainingTriangles[static_cast<int32>(vertex)];
+                uint32* triangles = vertexTriangles.getData() + vertexTriangleOffsets[static_cast<int32>(vertex)];
+                for (uint32 triangleIndex = 0; triangleIndex < remainingTriangles; triangleIndex++)
+                {
+                    if (triangles[triangleIndex] == static_cast<uint32>(bestTriangle))
+                    {
+                        triangles[triangleIndex] = triangles[remainingTriangles - 1];
+                        break;
+                    }
+                }
+                remainingTriangles--;
+            }
+            for (const auto& vertex : cache)
+            {
+                newCache.addUnique(vertex);
+            }
+
+            // Update scores of vertices which were or are in cache
+            for (int32 cacheIndex = 0; cacheIndex < newCache.getSize(); cacheIndex++)
+            {
+                const int32 vertex = static_cast<int32>(newCache[cacheIndex]);
+                vertexCachePositions[vertex] = cacheIndex < static_cast<int32>(cacheSize) ? cacheIndex : -1;
+                vertexScores[vertex] = GetForsythVertexScore(vertexCachePositions[vertex], vertexRemainingTriangles[vertex], cacheSize);
+            }
+
+            bestTriangle = -1;
+            bestTriangleScore = -1.0f;
+            for (const auto& cacheVertex : newCache)
+            {
+                const int32 vertex = static_cast<int32>(cacheVertex);
+                const uint32* triangles = vertexTriangles.getData() + vertexTriangleOffsets[vertex];
+                for (uint32 triangleIndex = 0; triangleIndex < vertexRemainingTriangles[vertex]; triangleIndex++)
+                {
+                    const int32 triangle = static_cast<int32>(triangles[triangleIndex]);
+                    float& score = triangleScores[triangle];
+                    score = vertexScores[static_cast<int32>(localIndices[triangle * 3])]
+                        + vertexScores[static_cast<int32>(localIndices[triangle * 3 + 1])]
+                        + vertexScores[static_cast<int32>(localIndices[triangle * 3 + 2])];
+                    if (score > bestTriangleScore)
+                    {
+                        bestTriangleScore = score;
+                        bestTriangle = triangle;
+                    }
+                }
+            }
+
+            // Evicted vertices are out of cache now
+            while (newCache.getSize() > static_cast<int32>(cacheSize))
+            {
+                newCache.removeAt(newCache.getSize() - 1);
+            }
+            std::swap(cache, newCache);
+
+            if (bestTriangle < 0)
+            {
+                while ((nextUnaddedTriangle < triangleCount) && (trianglesAdded[static_cast<int32>(nextUnaddedTriangle)] != 0))
+                {
+                    nextUnaddedTriangle++;
+                }
+                if (nextUnaddedTriangle < triangleCount)
+                {
+                    bestTriangle = static_cast<int32>(nextUnaddedTriangle);
+                }
+            }
+        }
+    }
+
+    uint32 VertexBufferOptimizer::optimizeVertexFetch(jarray<uint32>& indices, const uint8* vertices, const uint32 vertexCount, const uint32 vertexSize,
+        jarray<uint8>& outVertices)
+    {
+        constexpr uint32 invalidIndex = 0xFFFFFFFF;
+        jarray<uint32> remap(static_cast<int32>(vertexCount), invalidIndex);
+        uint32 resultVertexCount = 0;
+        outVertices.clear();
+        outVertices.reserve(static_cast<int32>(vertexCount * vertexSize));
+        for (auto& index : indices)
+        {
+            uint32& newIndex = remap[static_cast<int32>(index)];
+            if (newIndex == invalidIndex)
+            {
+                newIndex = resultVertexCount++;
+                const uint8* vertex = vertices + index * vertexSize;
+                for (uint32 byteIndex = 0; byteIndex < vertexSize; byteIndex++)
+                {
+                    outVertices.add(vertex[byteIndex]);
+                }
+            }
+            index = newIndex;
+        }
+        return resultVertexCount;
+    }
+}
@@ -0,0 +1,54 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#pragma once
+
+#include "renderEngine/juma_render_engine_core.h"
+
+#include "jutils/jarray.h"
+
+namespace JumaRenderEngine
+{
+    class VertexBufferData;
+
+    struct VertexBufferOptimizationSettings
+    {
+        // Merge equal vertices and build index buffer for them
+        bool deduplicateVertices = true;
+        // Reorder triangles for post-transform vertex cache (Forsyth)
+        bool optimizeVertexCache = true;
+        // Reorder vertices in order of first use, unused vertices are removed
+        bool optimizeVertexFetch = true;
+
+        uint32 cacheSize = 32;
+        // Triangles are split into chunks optimized in parallel, 0 means hardware concurrency
+        uint32 maxThreadCount = 0;
+        uint32 minTrianglesPerThread = 65536;
+    };
+    struct VertexBufferOptimizationReport
+    {
+        uint32 vertexCountBefore = 0;
+        uint32 vertexCountAfter = 0;
+
+        // Average cache miss ratio: transformed vertices per triangle, 0.5 is optimal and 3.0 is worst
+        float ACMRBefore = 0.0f;
+        float ACMRAfter = 0.0f;
+    };
+
+    class VertexBufferOptimizer
+    {
+    public:
+
+        static bool optimize(VertexBufferData* verticesData, const VertexBufferOptimizationSettings& settings = {},
+            VertexBufferOptimizationReport* outReport = nullptr);
+
+        static float calculateACMR(const jarray<uint32>& indices, uint32 vertexCount, uint32 cacheSize);
+
+    private:
+
+        static jarray<uint32> deduplicateVertices(const uint8* vertices, uint32 vertexCount, uint32 vertexSize, jarray<uint8>& outVertices);
+        static void optimizeVertexCache(jarray<uint32>& indices, uint32 vertexCount, const VertexBufferOptimizationSettings& settings);
+        static void optimizeVertexCacheChunk(const uint32* indices, uint32 indexCount, uint32 cacheSize, uint32* outIndices);
+        static uint32 optimizeVertexFetch(jarray<uint32>& indices, const uint8* vertices, uint32 vertexCount, uint32 vertexSize,
+            jarray<uint8>& outVertices);
+    };
+}
@@ -0,0 +1,77 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#pragma once
+
+#include "renderEngine/juma_render_engine_core.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace JumaRenderEngine
+{
+    // Helpers for filling packed vertex components (see VertexComponentType)
+
+    inline uint16 PackHalf(const float value)
+    {
+        uint32 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        const uint32 sign = (bits >> 16) & 0x8000;
+        const uint32 exponent = (bits >> 23) & 0xFF;
+        uint32 mantissa = bits & 0x7FFFFF;
+        if (exponent == 0xFF)
+        {
+            // Inf or NaN
+            return static_cast<uint16>(sign | 0x7C00 | (mantissa != 0 ? 0x200 : 0));
+        }
+
+        const int32 halfExponent = static_cast<int32>(exponent) - 127 + 15;
+        if (halfExponent >= 0x1F)
+        {
+            return static_cast<uint16>(sign | 0x7C00);
+        }
+        if (halfExponent <= 0)
+        {
+            if (halfExponent < -10)
+            {
+                return static_cast<uint16>(sign);
+            }
+            // Denormalized half, round to nearest
+            mantissa |= 0x800000;
+            const uint32 shift = static_cast<uint32>(14 - halfExponent);
+            const uint32 halfMantissa = mantissa >> shift;
+            const uint32 roundBit = 1u << (shift - 1);
+            return static_cast<uint16>(sign | (halfMantissa + ((mantissa & roundBit) != 0 ? 1 : 0)));
+        }
+
+        // Round to nearest, mantissa overflow correctly carries into exponent
+        const uint32 result = sign | (static_cast<uint32>(halfExponent) << 10) | (mantissa >> 13);
+        return static_cast<uint16>(result + ((mantissa & 0x1000) != 0 ? 1 : 0));
+    }
+
+    inline uint32 PackUNorm(const float value, const uint32 bitCount)
+    {
+        const float maxValue = static_cast<float>((1u << bitCount) - 1);
+        return static_cast<uint32>(std::lround(math::max(0.0f, math::min(value, 1.0f)) * maxValue));
+    }
+    inline uint32 PackSNorm(const float value, const uint32 bitCount)
+    {
+        const float maxValue = static_cast<float>((1u << (bitCount - 1)) - 1);
+        const int32 result = static_cast<int32>(std::lround(math::max(-1.0f, math::min(value, 1.0f)) * maxValue));
+        return static_cast<uint32>(result) & ((1u << bitCount) - 1);
+    }
+
+    inline uint8 PackUNorm8(const float value) { return static_cast<uint8>(PackUNorm(value, 8)); }
+    inline int8 PackSNorm8(const float value) { return static_cast<int8>(static_cast<uint8>(PackSNorm(value, 8))); }
+    inline uint16 PackUNorm16(const float value) { return static_cast<uint16>(PackUNorm(value, 16)); }
+    inline int16 PackSNorm16(const float value) { return static_cast<int16>(static_cast<uint16>(PackSNorm(value, 16))); }
+
+    inline uint32 PackUNorm_10_10_10_2(const float x, const float y, const float z, const float w)
+    {
+        return PackUNorm(x, 10) | (PackUNorm(y, 10) << 10) | (PackUNorm(z, 10) << 20) | (PackUNorm(w, 2) << 30);
+    }
+    inline uint32 PackSNorm_10_10_10_2(const float x, const float y, const float z, const float w)
+    {
+        return PackSNorm(x, 10) | (PackSNorm(y, 10) << 10) | (PackSNorm(z, 10) << 20) | (PackSNorm(w, 2) << 30);
+    }
+}
@@ -11,8 +11,49 @@ namespace JumaRenderEngine
 {
     enum class VertexComponentType : uint8
     {
-        Float, Vec2, Vec3, Vec4
+        Float, Vec2, Vec3, Vec4,
+        // 16-bit floats
+        Half, Half2, Half4,
+        // Integers normalized to [0, 1] (UNorm) or [-1, 1] (Norm)
+        UByte2_Norm, UByte4_Norm, Byte2_Norm, Byte4_Norm,
+        UShort2_Norm, UShort4_Norm, Short2_Norm, Short4_Norm,
+        // X, Y, Z in 10 bits and W in 2 bits of one 32-bit value, X in the lowest bits
+        UInt_10_10_10_2_Norm, Int_10_10_10_2_Norm
     };
+
+    constexpr uint32 GetVertexComponentSize(const VertexComponentType type)
+    {
+        switch (type)
+        {
+        case VertexComponentType::Half:
+        case VertexComponentType::UByte2_Norm:
+        case VertexComponentType::Byte2_Norm:
+            return 2;
+
+        case VertexComponentType::Float:
+        case VertexComponentType::Half2:
+        case VertexComponentType::UByte4_Norm:
+        case VertexComponentType::Byte4_Norm:
+        case VertexComponentType::UShort2_Norm:
+        case VertexComponentType::Short2_Norm:
+        case VertexComponentType::UInt_10_10_10_2_Norm:
+        case VertexComponentType::Int_10_10_10_2_Norm:
+            return 4;
+
+        case VertexComponentType::Vec2:
+        case VertexComponentType::Half4:
+        case VertexComponentType::UShort4_Norm:
+        case VertexComponentType::Short4_Norm:
+            return 8;
+
+        case VertexComponentType::Vec3: return 12;
+        case VertexComponentType::Vec4: return 16;
+
+        default: ;
+        }
+        return 0;
+    }
+
     struct VertexComponentDescription
     {
         jstringID name = jstringID_NONE;
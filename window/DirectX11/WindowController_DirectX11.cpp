@@ -168,7 +168,11 @@ namespace JumaRenderEngine
         const WindowData_DirectX11* windowData = findWindowData<WindowData_DirectX11>(windowID);
         if (windowData->swapchain != nullptr)
         {
-            windowData->swapchain->Present(1, 0);
+            // Flip model swapchain without sync interval doesn't tear unless it's allowed, so it works like mailbox
+            const WindowPresentMode presentMode = windowData->properties.presentMode;
+            const bool vsyncEnabled = (presentMode == WindowPresentMode::FIFO) || (presentMode == WindowPresentMode::FIFORelaxed);
+            const UINT presentFlags = m_TearingSupported && (presentMode == WindowPresentMode::Immediate) ? DXGI_PRESENT_ALLOW_TEARING : 0;
+            windowData->swapchain->Present(vsyncEnabled ? 1 : 0, presentFlags);
         }
 
         Super::onFinishWindowRender(windowID);
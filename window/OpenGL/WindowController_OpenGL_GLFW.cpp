@@ -6,6 +6,8 @@
 
 #include <GLFW/glfw3.h>
 
+#include "renderEngine/OpenGL/RenderEngine_OpenGL.h"
+
 namespace JumaRenderEngine
 {
     WindowController_OpenGL_GLFW::~WindowController_OpenGL_GLFW()
@@ -99,11 +101,38 @@ namespace JumaRenderEngine
         glfwSetFramebufferSizeCallback(window, WindowController_OpenGL_GLFW::GLFW_FramebufferResizeCallback);
         glfwSetWindowIconifyCallback(window, WindowController_OpenGL_GLFW::GLFW_WindowMinimizationCallback);
 
+        updateSwapInterval(windowID, properties.presentMode);
+        return &windowData;
+    }
+    void WindowController_OpenGL_GLFW::onWindowPresentationChanged(WindowData* windowData)
+    {
+        Super::onWindowPresentationChanged(windowData);
+
+        // Default framebuffer is always double buffered, so image count is ignored
+        updateSwapInterval(windowData->windowID, windowData->properties.presentMode);
+    }
+    void WindowController_OpenGL_GLFW::updateSwapInterval(const window_id windowID, const WindowPresentMode presentMode)
+    {
         const window_id prevActiveWindowID = getActiveWindowID();
         setActiveWindowID(windowID);
-        glfwSwapInterval(1);
+        int swapInterval;
+        switch (presentMode)
+        {
+        case WindowPresentMode::FIFORelaxed:
+            // Negative interval is adaptive vsync, it needs swap control tear extension
+            swapInterval = (glfwExtensionSupported("WGL_EXT_swap_control_tear") == GLFW_TRUE) 
+                || (glfwExtensionSupported("GLX_EXT_swap_control_tear") == GLFW_TRUE) ? -1 : 1;
+            break;
+        case WindowPresentMode::Mailbox:
+        case WindowPresentMode::Immediate:
+            // There is no mailbox in OpenGL, so it's not capped like immediate
+            swapInterval = 0;
+            break;
+        default:
+            swapInterval = 1;
+        }
+        glfwSwapInterval(swapInterval);
         setActiveWindowID(prevActiveWindowID);
-        return &windowData;
     }
     void WindowController_OpenGL_GLFW::GLFW_FramebufferResizeCallback(GLFWwindow* windowGLFW, int width, int height)
     {
@@ -148,6 +177,11 @@ namespace JumaRenderEngine
     void WindowController_OpenGL_GLFW::clearWindowGLFW(const window_id windowID, WindowData_OpenGL_GLFW& windowData)
     {
         clearWindow(windowID, windowData);
+        RenderEngine_OpenGL* renderEngine = getRenderEngine<RenderEngine_OpenGL>();
+        if (renderEngine != nullptr)
+        {
+            renderEngine->onWindowDestroyed(windowID);
+        }
 
         glfwSetWindowUserPointer(windowData.windowGLFW, nullptr);
         glfwDestroyWindow(windowData.windowGLFW);
@@ -51,6 +51,8 @@ namespace JumaRenderEngine
 
         virtual bool setActiveWindowInternal(window_id windowID) override;
 
+        virtual void onWindowPresentationChanged(WindowData* windowData) override;
+
     private:
 
         GLFWwindow* m_DefaultWindow = nullptr;
@@ -64,6 +66,8 @@ namespace JumaRenderEngine
         void clearGLFW();
 
         void clearWindowGLFW(window_id windowID, WindowData_OpenGL_GLFW& windowData);
+
+        void updateSwapInterval(window_id windowID, WindowPresentMode presentMode);
     };
 }
 
@@ -120,6 +120,39 @@ namespace JumaRenderEngine
         }
     }
 
+    bool WindowController::setWindowPresentMode(const window_id windowID, const WindowPresentMode presentMode)
+    {
+        WindowData* windowData = getWindowData(windowID);
+        if (windowData == nullptr)
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to find window {}"), windowID);
+            return false;
+        }
+        if (windowData->properties.presentMode != presentMode)
+        {
+            windowData->properties.presentMode = presentMode;
+            onWindowPresentationChanged(windowData);
+            OnWindowPropertiesChanged.call(this, windowData);
+        }
+        return true;
+    }
+    bool WindowController::setWindowSwapchainImageCount(const window_id windowID, const uint8 imageCount)
+    {
+        WindowData* windowData = getWindowData(windowID);
+        if (windowData == nullptr)
+        {
+            JUMA_RENDER_LOG(error, JSTR("Failed to find window {}"), windowID);
+            return false;
+        }
+        if (windowData->properties.swapchainImageCount != imageCount)
+        {
+            windowData->properties.swapchainImageCount = imageCount;
+            onWindowPresentationChanged(windowData);
+            OnWindowPropertiesChanged.call(this, windowData);
+        }
+        return true;
+    }
+
     void WindowController::updateWindowMinimization(const window_id windowID, const bool minimized)
     {
         WindowData* windowData = getWindowData(windowID);
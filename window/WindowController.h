@@ -5,6 +5,7 @@
 #include "renderEngine/juma_render_engine_core.h"
 #include "renderEngine/RenderEngineContextObject.h"
 
+#include "WindowPresentMode.h"
 #include "window_id.h"
 #include "jutils/jarray.h"
 #include "jutils/jdelegate_multicast.h"
@@ -22,6 +23,9 @@ namespace JumaRenderEngine
         jstring title;
         math::uvector2 size;
         TextureSamples samples = TextureSamples::X1;
+        WindowPresentMode presentMode = WindowPresentMode::FIFO;
+        // 0 means default count of the render API
+        uint8 swapchainImageCount = 0;
     };
     struct WindowData
     {
@@ -71,6 +75,10 @@ namespace JumaRenderEngine
 
         virtual bool setWindowTitle(window_id windowID, const jstring& title) = 0;
 
+        // Unsupported present mode is replaced by FIFO, swapchain is recreated before the next render if it's needed
+        bool setWindowPresentMode(window_id windowID, WindowPresentMode presentMode);
+        bool setWindowSwapchainImageCount(window_id windowID, uint8 imageCount);
+
     protected:
 
         virtual bool initWindowController() { return true; }
@@ -86,6 +94,8 @@ namespace JumaRenderEngine
         void updateWindowSize(window_id windowID, const math::uvector2& size);
         virtual void onWindowResized(WindowData* windowData) {}
 
+        virtual void onWindowPresentationChanged(WindowData* windowData) {}
+
         void updateWindowMinimization(window_id windowID, bool minimized);
         virtual void onWindowMinimizationChanged(WindowData* windowData);
 
@@ -0,0 +1,20 @@
+﻿// Copyright 2022 Leonov Maksim. All Rights Reserved.
+
+#pragma once
+
+#include "renderEngine/juma_render_engine_core.h"
+
+namespace JumaRenderEngine
+{
+    enum class WindowPresentMode : uint8
+    {
+        // Waits for vertical blank, frame rate is capped by the display
+        FIFO,
+        // Same as FIFO, but late frame is presented immediately and could tear
+        FIFORelaxed,
+        // Queued frame is replaced by the newer one, so rendering is not blocked and there is no tearing
+        Mailbox,
+        // Frame is presented immediately, could tear
+        Immediate
+    };
+}